@@ -0,0 +1,232 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define AABB_HAS_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define AABB_HAS_SSE2 1
+#endif
+
+//----------------------------------------------------------------------------
+// Batched AABB Overlap Kernel (Section 13 – Collision)
+//----------------------------------------------------------------------------
+// The narrowphase primitive under pickups, hitboxes and broadphase candidate
+// lists: one box against N boxes stored as SoA arrays (float, or int32 for
+// tile and pixel rects) produces a hit bitmask, bit i of word i/64 for box
+// i.  Eight boxes per compare with AVX2 (build with -mavx2), four with
+// SSE2, scalar otherwise and for the tail; every path gives the same bits.
+// An optional layer array filters hits to boxes sharing a bit with a mask.
+// N-vs-M runs the kernel once per box of the first set and lists the pairs.
+//
+// Boxes are half-open like the rest of the collision code: touching is not
+// overlapping.  The test is a.min < b.max && b.min < a.max on each axis
+// with nothing special-cased, so a zero-size box (min == max) is a point
+// or segment that hits every box whose interior contains it; game.cpp's
+// aggro check uses the player as a point collider this way.  Inverted
+// boxes (max < min) give meaningless results and must not be passed.
+//
+
+struct Aabb {
+    float minX, minY, maxX, maxY;
+};
+
+struct IntAabb {
+    int32_t minX, minY, maxX, maxY;
+};
+
+// Non-owning view of SoA boxes; T is float or int32_t
+template <typename T>
+struct BoxSpan {
+    const T* minX;
+    const T* minY;
+    const T* maxX;
+    const T* maxY;
+    size_t count;
+
+    BoxSpan sub(size_t begin, size_t end) const {
+        return { minX + begin, minY + begin, maxX + begin, maxY + begin, end - begin };
+    }
+};
+
+using AabbSpan = BoxSpan<float>;
+using IntAabbSpan = BoxSpan<int32_t>;
+
+// Owning SoA boxes
+template <typename T>
+struct BoxArrays {
+    using Box = typename std::conditional<std::is_same<T, float>::value, Aabb, IntAabb>::type;
+
+    std::vector<T> minX, minY, maxX, maxY;
+
+    void clear() {
+        minX.clear(); minY.clear(); maxX.clear(); maxY.clear();
+    }
+    void add(const Box& b) {
+        minX.push_back(b.minX); minY.push_back(b.minY);
+        maxX.push_back(b.maxX); maxY.push_back(b.maxY);
+    }
+    // Keeps the order of the remaining boxes
+    void erase(size_t i) {
+        minX.erase(minX.begin() + i); minY.erase(minY.begin() + i);
+        maxX.erase(maxX.begin() + i); maxY.erase(maxY.begin() + i);
+    }
+    size_t size() const { return minX.size(); }
+    BoxSpan<T> span() const { return { minX.data(), minY.data(), maxX.data(), maxY.data(), minX.size() }; }
+};
+
+using AabbArrays = BoxArrays<float>;
+using IntAabbArrays = BoxArrays<int32_t>;
+
+struct AabbPair {
+    uint32_t a;
+    uint32_t b;
+};
+
+inline size_t aabbMaskWords(size_t count) {
+    return (count + 63) / 64;
+}
+
+namespace aabb_detail {
+
+inline unsigned popcount64(uint64_t v) {
+    v = v - ((v >> 1) & 0x5555555555555555ull);
+    v = (v & 0x3333333333333333ull) + ((v >> 2) & 0x3333333333333333ull);
+    v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (unsigned)((v * 0x0101010101010101ull) >> 56);
+}
+
+// Index of the lowest set bit; v must be non-zero
+inline unsigned lowestBit(uint64_t v) {
+    static const uint8_t DEBRUIJN[64] = {
+        0, 1, 48, 2, 57, 49, 28, 3, 61, 58, 50, 42, 38, 29, 17, 4,
+        62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+        63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+        46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9, 13, 8, 7, 6
+    };
+    return DEBRUIJN[((v & (0 - v)) * 0x03F79D71B4CB0A89ull) >> 58];
+}
+
+template <typename T>
+inline bool overlaps(const T* bx, const BoxSpan<T>& s, size_t i) {
+    return bx[0] < s.maxX[i] && s.minX[i] < bx[2] && bx[1] < s.maxY[i] && s.minY[i] < bx[3];
+}
+
+// Lanes [i, i+8) of one 64-box word; returns the 8 hit bits
+#if defined(AABB_HAS_AVX2)
+inline unsigned overlap8(const float* bx, const BoxSpan<float>& s, size_t i) {
+    __m256 lt0 = _mm256_cmp_ps(_mm256_set1_ps(bx[0]), _mm256_loadu_ps(s.maxX + i), _CMP_LT_OQ);
+    __m256 lt1 = _mm256_cmp_ps(_mm256_loadu_ps(s.minX + i), _mm256_set1_ps(bx[2]), _CMP_LT_OQ);
+    __m256 lt2 = _mm256_cmp_ps(_mm256_set1_ps(bx[1]), _mm256_loadu_ps(s.maxY + i), _CMP_LT_OQ);
+    __m256 lt3 = _mm256_cmp_ps(_mm256_loadu_ps(s.minY + i), _mm256_set1_ps(bx[3]), _CMP_LT_OQ);
+    return (unsigned)_mm256_movemask_ps(_mm256_and_ps(_mm256_and_ps(lt0, lt1), _mm256_and_ps(lt2, lt3)));
+}
+inline unsigned overlap8(const int32_t* bx, const BoxSpan<int32_t>& s, size_t i) {
+    auto load = [](const int32_t* p) { return _mm256_loadu_si256((const __m256i*)p); };
+    __m256i lt0 = _mm256_cmpgt_epi32(load(s.maxX + i), _mm256_set1_epi32(bx[0]));
+    __m256i lt1 = _mm256_cmpgt_epi32(_mm256_set1_epi32(bx[2]), load(s.minX + i));
+    __m256i lt2 = _mm256_cmpgt_epi32(load(s.maxY + i), _mm256_set1_epi32(bx[1]));
+    __m256i lt3 = _mm256_cmpgt_epi32(_mm256_set1_epi32(bx[3]), load(s.minY + i));
+    __m256i hit = _mm256_and_si256(_mm256_and_si256(lt0, lt1), _mm256_and_si256(lt2, lt3));
+    return (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(hit));
+}
+#endif
+
+#if defined(AABB_HAS_SSE2)
+inline unsigned overlap4(const float* bx, const BoxSpan<float>& s, size_t i) {
+    __m128 lt0 = _mm_cmplt_ps(_mm_set1_ps(bx[0]), _mm_loadu_ps(s.maxX + i));
+    __m128 lt1 = _mm_cmplt_ps(_mm_loadu_ps(s.minX + i), _mm_set1_ps(bx[2]));
+    __m128 lt2 = _mm_cmplt_ps(_mm_set1_ps(bx[1]), _mm_loadu_ps(s.maxY + i));
+    __m128 lt3 = _mm_cmplt_ps(_mm_loadu_ps(s.minY + i), _mm_set1_ps(bx[3]));
+    return (unsigned)_mm_movemask_ps(_mm_and_ps(_mm_and_ps(lt0, lt1), _mm_and_ps(lt2, lt3)));
+}
+inline unsigned overlap4(const int32_t* bx, const BoxSpan<int32_t>& s, size_t i) {
+    auto load = [](const int32_t* p) { return _mm_loadu_si128((const __m128i*)p); };
+    __m128i lt0 = _mm_cmplt_epi32(_mm_set1_epi32(bx[0]), load(s.maxX + i));
+    __m128i lt1 = _mm_cmplt_epi32(load(s.minX + i), _mm_set1_epi32(bx[2]));
+    __m128i lt2 = _mm_cmplt_epi32(_mm_set1_epi32(bx[1]), load(s.maxY + i));
+    __m128i lt3 = _mm_cmplt_epi32(load(s.minY + i), _mm_set1_epi32(bx[3]));
+    __m128i hit = _mm_and_si128(_mm_and_si128(lt0, lt1), _mm_and_si128(lt2, lt3));
+    return (unsigned)_mm_movemask_ps(_mm_castsi128_ps(hit));
+}
+#endif
+
+// Boxes [base, base+n) of one word, n <= 64
+template <typename T>
+inline uint64_t overlapWord(const T* bx, const BoxSpan<T>& s, size_t base, size_t n) {
+    uint64_t word = 0;
+    size_t i = 0;
+#if defined(AABB_HAS_AVX2)
+    for (; i + 8 <= n; i += 8) word |= (uint64_t)overlap8(bx, s, base + i) << i;
+#endif
+#if defined(AABB_HAS_SSE2)
+    for (; i + 4 <= n; i += 4) word |= (uint64_t)overlap4(bx, s, base + i) << i;
+#endif
+    for (; i < n; ++i) word |= (uint64_t)overlaps(bx, s, base + i) << i;
+    return word;
+}
+
+// Clears bits of boxes whose layers share nothing with `mask`
+inline uint64_t filterLayers(uint64_t word, const uint32_t* layers, size_t base, uint32_t mask) {
+    for (uint64_t rest = word; rest; rest &= rest - 1) {
+        unsigned k = lowestBit(rest);
+        if (!(layers[base + k] & mask)) word &= ~(1ull << k);
+    }
+    return word;
+}
+
+template <typename T, typename Box>
+inline size_t overlapMask(const Box& box, const BoxSpan<T>& boxes, const uint32_t* layers, uint32_t layerMask,
+                          uint64_t* bits) {
+    const T bx[4] = { box.minX, box.minY, box.maxX, box.maxY };
+    size_t hits = 0;
+    for (size_t w = 0, base = 0; base < boxes.count; ++w, base += 64) {
+        uint64_t word = overlapWord(bx, boxes, base, std::min<size_t>(64, boxes.count - base));
+        if (layers && word) word = filterLayers(word, layers, base, layerMask);
+        bits[w] = word;
+        hits += popcount64(word);
+    }
+    return hits;
+}
+
+} // namespace aabb_detail
+
+// Sets bit i of `bits` (aabbMaskWords(boxes.count) words) when boxes[i]
+// overlaps `box`, clears the rest; returns the number of hits.  With
+// `layers`, a hit also needs layers[i] & layerMask.
+inline size_t aabbOverlapMask(const Aabb& box, const AabbSpan& boxes, uint64_t* bits,
+                              const uint32_t* layers = nullptr, uint32_t layerMask = ~0u) {
+    return aabb_detail::overlapMask(box, boxes, layers, layerMask, bits);
+}
+inline size_t aabbOverlapMask(const IntAabb& box, const IntAabbSpan& boxes, uint64_t* bits,
+                              const uint32_t* layers = nullptr, uint32_t layerMask = ~0u) {
+    return aabb_detail::overlapMask(box, boxes, layers, layerMask, bits);
+}
+
+// Calls fn(i) for each set bit below `count`, in ascending order
+template <typename Fn>
+inline void forEachHit(const uint64_t* bits, size_t count, Fn fn) {
+    for (size_t w = 0; w < aabbMaskWords(count); ++w) {
+        for (uint64_t word = bits[w]; word; word &= word - 1) fn(w * 64 + aabb_detail::lowestBit(word));
+    }
+}
+
+// Every overlapping (a, b) pair, ordered by a then b.  `scratch` holds one
+// mask between calls.
+template <typename T>
+inline void aabbOverlapPairs(const BoxSpan<T>& a, const BoxSpan<T>& b, std::vector<AabbPair>& pairs,
+                             std::vector<uint64_t>& scratch) {
+    using Box = typename BoxArrays<T>::Box;
+    pairs.clear();
+    scratch.resize(aabbMaskWords(b.count));
+    for (size_t i = 0; i < a.count; ++i) {
+        const Box box{ a.minX[i], a.minY[i], a.maxX[i], a.maxY[i] };
+        if (!aabb_detail::overlapMask(box, b, nullptr, 0u, scratch.data())) continue;
+        forEachHit(scratch.data(), b.count, [&](size_t j) { pairs.push_back({ (uint32_t)i, (uint32_t)j }); });
+    }
+}
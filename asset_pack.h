@@ -0,0 +1,378 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "mapped_file.h"
+
+//----------------------------------------------------------------------------
+// Asset Pack Archive (Tools / Assets)
+//----------------------------------------------------------------------------
+// Every asset in one file, opened with a single MappedFile.  Entries are
+// found by the 64-bit FNV-1a hash of their name (assetHash(), constexpr so
+// code can hash names at compile time) through a binary search of an index
+// sorted by hash, read straight from the mapping: O(log n), no allocation.
+// Opening checks the header and the sizes of the tables and nothing per
+// entry, so startup costs the same for ten assets or a hundred thousand;
+// each entry is checked when it is looked up (bounds, alignment, a known
+// compression, and size == rawSize for raw entries).
+//
+// Entry data starts on an ASSET_PACK_ALIGN boundary of the file, and so of
+// the page-aligned mapping: an uncompressed asset is used in place (as a
+// uint32_t pixel array, with aligned SIMD loads) and its pages are only
+// read when touched.  pack_tool stores an entry compressed when that saves
+// at least a quarter of it; those are decoded with assetDecode() into
+// memory the caller owns.  The codec is a byte-oriented LZ77 in the style
+// of LZ4, so there is no library to link and decoding runs at memory speed.
+//
+// File layout (little endian, 32-byte header):
+//   char     magic[4]      "APAK"
+//   uint16_t version       ASSET_PACK_VERSION
+//   uint16_t align         ASSET_PACK_ALIGN
+//   uint32_t entryCount
+//   uint32_t namesOffset   UTF-8 names, not terminated
+//   uint32_t namesSize
+//   uint32_t reserved
+//   uint64_t fileSize
+//   entry[entryCount]      32 bytes each, ascending hash:
+//     uint64_t hash  uint64_t offset  uint32_t size  uint32_t rawSize
+//     uint32_t nameOffset  uint16_t nameSize  uint8_t compression  uint8_t 0
+//   names, then entry data
+//
+
+constexpr uint16_t ASSET_PACK_VERSION     = 1;
+constexpr size_t   ASSET_PACK_HEADER_SIZE = 32;
+constexpr size_t   ASSET_PACK_ENTRY_SIZE  = 32;
+constexpr size_t   ASSET_PACK_ALIGN       = 64;      // a cache line
+constexpr const char* ASSET_PACK_DEFAULT_PATH = "assets.pak";
+
+enum class AssetCompression : uint8_t {
+    None = 0,
+    Lz   = 1
+};
+
+constexpr uint64_t assetHash(const char* name, size_t size) {
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < size; ++i) h = (h ^ (uint8_t)name[i]) * 0x100000001B3ull;
+    return h;
+}
+
+constexpr uint64_t assetHash(const char* name) {
+    size_t size = 0;
+    while (name[size]) ++size;
+    return assetHash(name, size);
+}
+
+struct AssetView {
+    const uint8_t* data{ nullptr };     // in the mapping; `size` bytes
+    size_t size{ 0 };
+    size_t rawSize{ 0 };                // bytes after decoding
+    AssetCompression compression{ AssetCompression::None };
+    const char* name{ nullptr };
+    size_t nameSize{ 0 };
+    uint64_t hash{ 0 };
+};
+
+namespace asset_pack_detail {
+
+constexpr size_t MIN_MATCH  = 4;
+constexpr size_t MAX_OFFSET = 65535;
+constexpr int    HASH_BITS  = 14;
+
+inline void writeLength(std::vector<uint8_t>& out, size_t extra) {
+    for (; extra >= 255; extra -= 255) out.push_back(255);
+    out.push_back((uint8_t)extra);
+}
+
+inline bool readLength(const uint8_t*& in, const uint8_t* end, size_t& length) {
+    for (;;) {
+        if (in == end) return false;
+        uint8_t b = *in++;
+        length += b;
+        if (b != 255) return true;
+    }
+}
+
+// One sequence: literals [lit, lit + litSize), then a match of matchSize
+// bytes `offset` back (matchSize 0 ends the stream)
+inline void writeSequence(std::vector<uint8_t>& out, const uint8_t* lit, size_t litSize, size_t offset,
+                          size_t matchSize) {
+    const size_t m = matchSize ? matchSize - MIN_MATCH : 0;
+    out.push_back((uint8_t)(std::min<size_t>(litSize, 15) << 4 | std::min<size_t>(m, 15)));
+    if (litSize >= 15) writeLength(out, litSize - 15);
+    out.insert(out.end(), lit, lit + litSize);
+    if (!matchSize) return;
+    out.push_back((uint8_t)offset);
+    out.push_back((uint8_t)(offset >> 8));
+    if (m >= 15) writeLength(out, m - 15);
+}
+
+inline uint32_t read32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+inline uint64_t read64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+    return v;
+}
+
+} // namespace asset_pack_detail
+
+// Greedy LZ77 with a hash of the next four bytes; replaces `out`
+inline void assetCompress(const uint8_t* in, size_t size, std::vector<uint8_t>& out) {
+    using namespace asset_pack_detail;
+    out.clear();
+    std::vector<uint32_t> table((size_t)1 << HASH_BITS, UINT32_MAX);
+    size_t anchor = 0, i = 0;
+    while (i + MIN_MATCH <= size) {
+        const uint32_t slot = (read32(in + i) * 2654435761u) >> (32 - HASH_BITS);
+        const uint32_t candidate = table[slot];
+        table[slot] = (uint32_t)i;
+        if (candidate == UINT32_MAX || i - candidate > MAX_OFFSET || read32(in + candidate) != read32(in + i)) {
+            ++i;
+            continue;
+        }
+        size_t length = MIN_MATCH;
+        while (i + length < size && in[candidate + length] == in[i + length]) ++length;
+        writeSequence(out, in + anchor, i - anchor, i - candidate, length);
+        i += length;
+        anchor = i;
+    }
+    writeSequence(out, in + anchor, size - anchor, 0, 0);
+}
+
+// Decodes exactly rawSize bytes into `out`; false on malformed input
+inline bool assetDecompress(const uint8_t* in, size_t size, uint8_t* out, size_t rawSize) {
+    using namespace asset_pack_detail;
+    const uint8_t* end = in + size;
+    size_t written = 0;
+    while (in < end) {
+        const uint8_t token = *in++;
+        size_t literals = token >> 4;
+        if (literals == 15 && !readLength(in, end, literals)) return false;
+        if (literals > (size_t)(end - in) || literals > rawSize - written) return false;
+        std::memcpy(out + written, in, literals);
+        in += literals;
+        written += literals;
+        if (in == end) return (token & 15) == 0 && written == rawSize;
+        if (end - in < 2) return false;
+        const size_t offset = in[0] | (size_t)in[1] << 8;
+        in += 2;
+        size_t length = (size_t)(token & 15);
+        if (length == 15 && !readLength(in, end, length)) return false;
+        length += MIN_MATCH;
+        if (offset == 0 || offset > written || length > rawSize - written) return false;
+        // Byte by byte: the match may overlap what it is copying
+        for (size_t k = 0; k < length; ++k, ++written) out[written] = out[written - offset];
+    }
+    return false;
+}
+
+// Decodes an entry into `out` (view.rawSize bytes)
+inline bool assetDecode(const AssetView& view, uint8_t* out) {
+    if (view.compression == AssetCompression::None) {
+        if (view.size != view.rawSize) return false;
+        if (view.size) std::memcpy(out, view.data, view.size);
+        return true;
+    }
+    return view.compression == AssetCompression::Lz && assetDecompress(view.data, view.size, out, view.rawSize);
+}
+
+struct AssetPack {
+    MappedFile file;
+    uint32_t entryCount{ 0 };
+
+    bool open(const char* path) {
+        close();
+        if (!file.open(path) || !parse()) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        file.close();
+        entryCount = 0;
+    }
+
+    bool isOpen() const { return file.data != nullptr; }
+
+    // By position in the index (ascending hash), for listing
+    bool entry(size_t i, AssetView& out) const {
+        if (i >= entryCount) return false;
+        return readEntry(file.data + ASSET_PACK_HEADER_SIZE + i * ASSET_PACK_ENTRY_SIZE, out);
+    }
+
+    bool find(uint64_t hash, AssetView& out) const {
+        if (entryCount == 0) return false;
+        const uint8_t* index = file.data + ASSET_PACK_HEADER_SIZE;
+        size_t lo = 0, hi = entryCount;
+        while (lo < hi) {
+            const size_t mid = lo + (hi - lo) / 2;
+            if (asset_pack_detail::read64(index + mid * ASSET_PACK_ENTRY_SIZE) < hash) lo = mid + 1;
+            else hi = mid;
+        }
+        if (lo == entryCount || asset_pack_detail::read64(index + lo * ASSET_PACK_ENTRY_SIZE) != hash) return false;
+        return readEntry(index + lo * ASSET_PACK_ENTRY_SIZE, out);
+    }
+
+    // Also compares the stored name, so a name that merely shares a hash
+    // with an asset is not found
+    bool find(const char* name, AssetView& out) const {
+        const size_t size = std::strlen(name);
+        return find(assetHash(name, size), out) && out.nameSize == size && std::memcmp(out.name, name, size) == 0;
+    }
+
+private:
+    uint32_t namesOffset{ 0 };
+    uint32_t namesSize{ 0 };
+
+    bool parse() {
+        const uint8_t* d = file.data;
+        if (!d || file.size < ASSET_PACK_HEADER_SIZE || std::memcmp(d, "APAK", 4) != 0) return false;
+        uint16_t version, align;
+        uint64_t fileSize;
+        std::memcpy(&version, d + 4, 2);
+        std::memcpy(&align, d + 6, 2);
+        std::memcpy(&entryCount, d + 8, 4);
+        std::memcpy(&namesOffset, d + 12, 4);
+        std::memcpy(&namesSize, d + 16, 4);
+        std::memcpy(&fileSize, d + 24, 8);
+        if (version != ASSET_PACK_VERSION || align != ASSET_PACK_ALIGN || fileSize != file.size) return false;
+        const uint64_t indexEnd = ASSET_PACK_HEADER_SIZE + (uint64_t)entryCount * ASSET_PACK_ENTRY_SIZE;
+        return indexEnd <= file.size && namesOffset >= indexEnd && (uint64_t)namesOffset + namesSize <= file.size;
+    }
+
+    bool readEntry(const uint8_t* e, AssetView& out) const {
+        uint64_t offset;
+        uint32_t size, rawSize, nameOffset;
+        uint16_t nameSize;
+        std::memcpy(&out.hash, e, 8);
+        std::memcpy(&offset, e + 8, 8);
+        std::memcpy(&size, e + 16, 4);
+        std::memcpy(&rawSize, e + 20, 4);
+        std::memcpy(&nameOffset, e + 24, 4);
+        std::memcpy(&nameSize, e + 28, 2);
+        if (offset > file.size || size > file.size - offset || offset % ASSET_PACK_ALIGN != 0) return false;
+        if ((uint64_t)nameOffset + nameSize > namesSize) return false;
+        // A raw entry is used in place, so it must hold all rawSize bytes
+        const uint8_t compression = e[30];
+        if (compression == (uint8_t)AssetCompression::None ? size != rawSize
+                                                             : compression != (uint8_t)AssetCompression::Lz) return false;
+        out.data = file.data + offset;
+        out.size = size;
+        out.rawSize = rawSize;
+        out.compression = (AssetCompression)compression;
+        out.name = (const char*)file.data + namesOffset + nameOffset;
+        out.nameSize = nameSize;
+        return true;
+    }
+};
+
+struct AssetPackWriter {
+    struct Pending {
+        std::string name;
+        uint64_t hash;
+        std::vector<uint8_t> data;      // as stored
+        uint32_t rawSize;
+        AssetCompression compression;
+    };
+    std::vector<Pending> entries;
+
+    // False, adding nothing, if the name is taken, too long, or hashes like
+    // another name.  With `compress`, stores the LZ form if it is at least a
+    // quarter smaller.
+    bool add(const std::string& name, const uint8_t* data, size_t size, bool compress) {
+        if (name.size() > UINT16_MAX || size > UINT32_MAX) return false;
+        const uint64_t hash = assetHash(name.data(), name.size());
+        if (!byHash.emplace(hash, entries.size()).second) return false;
+        Pending p{ name, hash, {}, (uint32_t)size, AssetCompression::None };
+        if (compress && size > 0) {
+            assetCompress(data, size, p.data);
+            if (p.data.size() <= size - size / 4) p.compression = AssetCompression::Lz;
+        }
+        if (p.compression == AssetCompression::None) p.data.assign(data, data + size);
+        entries.push_back(std::move(p));
+        return true;
+    }
+
+    bool save(const char* path) const {
+        std::vector<size_t> order(entries.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [this](size_t a, size_t b) { return entries[a].hash < entries[b].hash; });
+        const uint64_t namesOffset = ASSET_PACK_HEADER_SIZE + (uint64_t)entries.size() * ASSET_PACK_ENTRY_SIZE;
+        uint64_t namesSize = 0;
+        for (const Pending& p : entries) namesSize += p.name.size();
+        if (namesOffset + namesSize > UINT32_MAX) return false;
+        // Lay out the data in index order
+        std::vector<uint8_t> index(entries.size() * ASSET_PACK_ENTRY_SIZE);
+        uint64_t offset = alignUp(namesOffset + namesSize);
+        uint32_t nameOffset = 0;
+        for (size_t i = 0; i < order.size(); ++i) {
+            const Pending& p = entries[order[i]];
+            uint8_t* e = &index[i * ASSET_PACK_ENTRY_SIZE];
+            const uint32_t size = (uint32_t)p.data.size();
+            const uint16_t nameSize = (uint16_t)p.name.size();
+            std::memcpy(e, &p.hash, 8);
+            std::memcpy(e + 8, &offset, 8);
+            std::memcpy(e + 16, &size, 4);
+            std::memcpy(e + 20, &p.rawSize, 4);
+            std::memcpy(e + 24, &nameOffset, 4);
+            std::memcpy(e + 28, &nameSize, 2);
+            e[30] = (uint8_t)p.compression;
+            offset = alignUp(offset + size);
+            nameOffset += nameSize;
+        }
+        uint8_t header[ASSET_PACK_HEADER_SIZE] = {};
+        const uint32_t count = (uint32_t)entries.size(), namesAt = (uint32_t)namesOffset, namesBytes = (uint32_t)namesSize;
+        std::memcpy(header, "APAK", 4);
+        std::memcpy(header + 4, &ASSET_PACK_VERSION, 2);
+        const uint16_t align = (uint16_t)ASSET_PACK_ALIGN;
+        std::memcpy(header + 6, &align, 2);
+        std::memcpy(header + 8, &count, 4);
+        std::memcpy(header + 12, &namesAt, 4);
+        std::memcpy(header + 16, &namesBytes, 4);
+        std::memcpy(header + 24, &offset, 8);
+
+        FILE* f = std::fopen(path, "wb");
+        if (!f) return false;
+        bool ok = std::fwrite(header, 1, sizeof(header), f) == sizeof(header) &&
+                  std::fwrite(index.data(), 1, index.size(), f) == index.size();
+        for (size_t i : order) ok = ok && std::fwrite(entries[i].name.data(), 1, entries[i].name.size(), f) == entries[i].name.size();
+        uint64_t at = namesOffset + namesSize;
+        static const uint8_t zeros[ASSET_PACK_ALIGN] = {};
+        for (size_t i : order) {
+            const std::vector<uint8_t>& data = entries[i].data;
+            ok = ok && std::fwrite(zeros, 1, alignUp(at) - at, f) == alignUp(at) - at &&
+                 std::fwrite(data.data(), 1, data.size(), f) == data.size();
+            at = alignUp(at) + data.size();
+        }
+        ok = ok && std::fwrite(zeros, 1, alignUp(at) - at, f) == alignUp(at) - at;
+        return std::fclose(f) == 0 && ok;
+    }
+
+private:
+    std::unordered_map<uint64_t, size_t> byHash;
+
+    static uint64_t alignUp(uint64_t v) {
+        return (v + ASSET_PACK_ALIGN - 1) & ~(uint64_t)(ASSET_PACK_ALIGN - 1);
+    }
+};
+
+// Reads --assets=PATH from the command line; ASSET_PACK_DEFAULT_PATH if absent.
+inline const char* parseAssetPackPath(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--assets=", 9) == 0) return argv[i] + 9;
+        if (std::strcmp(argv[i], "--assets") == 0 && i + 1 < argc) return argv[i + 1];
+    }
+    return ASSET_PACK_DEFAULT_PATH;
+}
@@ -1,9 +1,12 @@
 #include <SDL2/SDL.h>
 #include <cmath>
+#include <vector>
+#include "tick_rate.h"
+#include "collision_query.h"
 
 const int SCREEN_W = 480;
 const int SCREEN_H = 270;
-const float DT = 1.0f / 60.0f;
+const uint32_t ENEMY_HURT_BIT = 1u << 3; // ENEMY_HURT_LAYER (Section 13)
 
 struct Player {
     float x, y;
@@ -19,6 +22,7 @@ struct Enemy {
 };
 
 int main(int argc, char** argv) {
+    const float DT = parseTickRate(argc, argv).dt;
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS) != 0) {
         return 1;
     }
@@ -39,6 +43,11 @@ int main(int argc, char** argv) {
     enemy.y = SCREEN_H - 40.0f;
     enemy.alive = true;
 
+    // Hitboxes are resolved through the batched query API
+    CollisionWorld world;
+    ColliderSet hurtboxes;
+    std::vector<OverlapPair> hits;
+
     Uint32 lastTick = SDL_GetTicks();
     float accumulator = 0.0f;
     bool running = true;
@@ -69,7 +78,7 @@ int main(int argc, char** argv) {
             if (player.vx > 200.0f) player.vx = 200.0f;
             if (player.vx < -200.0f) player.vx = -200.0f;
             if (ax == 0.0f && player.onGround) {
-                player.vx *= 0.8f;
+                player.vx *= decayFactor(GROUND_FRICTION_RATE, DT);
                 if (std::fabs(player.vx) < 5.0f) player.vx = 0.0f;
             }
             if (keys[SDL_SCANCODE_SPACE] && player.onGround) {
@@ -96,14 +105,13 @@ int main(int argc, char** argv) {
             }
             // Check attack hit
             if (player.attackTimer > 0.0f && enemy.alive) {
-                SDL_Rect attackRect;
-                if (player.facingRight) {
-                    attackRect = { (int)(player.x + 20), (int)player.y + 5, 20, 10 };
-                } else {
-                    attackRect = { (int)(player.x - 20), (int)player.y + 5, 20, 10 };
-                }
-                SDL_Rect enemyRect = { (int)enemy.x, (int)enemy.y, 20, 20 };
-                if (SDL_HasIntersection(&attackRect, &enemyRect)) {
+                hurtboxes.clear();
+                hurtboxes.add({ enemy.x, enemy.y, enemy.x + 20.0f, enemy.y + 20.0f }, ENEMY_HURT_BIT, 0);
+                world.setColliders(hurtboxes);
+                float attackX = player.facingRight ? player.x + 20.0f : player.x - 20.0f;
+                OverlapQuery attack = { { attackX, player.y + 5.0f, attackX + 20.0f, player.y + 15.0f }, ENEMY_HURT_BIT };
+                world.overlap(&attack, 1, hits, nullptr);
+                if (!hits.empty()) {
                     enemy.alive = false;
                 }
             }
@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "asset_pack.h"
+#include "rng.h"
+
+// Asset Pack Benchmark (Tools / Assets)
+// Writes packs of synthetic assets (small sprite-like images, half of them
+// compressible) with 100 to 100 000 entries, then times opening each pack
+// (best of several runs; it should not grow with the entry count) and
+// looking up every asset by name in random order.  Every asset must decode
+// to exactly what was packed and every uncompressed one must sit aligned
+// in the mapping, or the tool exits non-zero.
+//
+// Build: g++ -O2 -std=c++17 bench_assets.cpp -o bench_assets
+// Usage: bench_assets [scratch.pak]
+
+constexpr int BEST_OF = 5;
+
+static double nsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+// An 8x8 to 32x32 ARGB tile: flat colour runs (compress well) or noise
+static std::vector<uint8_t> makeAsset(uint32_t i) {
+    RngStream rng(0xA55E7ull, RngSystem::Spawn, i, 0);
+    const int w = 8 << (rng.nextU32() % 3), h = 8 << (rng.nextU32() % 3);
+    std::vector<uint32_t> px((size_t)w * h);
+    const bool noisy = i % 2 == 1;
+    uint32_t colour = rng.nextU32() | 0xFF000000u;
+    for (size_t k = 0; k < px.size(); ++k) {
+        if (noisy) colour = rng.nextU32();
+        else if (k % (size_t)w == 0 && rng.range(0.0f, 1.0f) < 0.2f) colour = rng.nextU32() | 0xFF000000u;
+        px[k] = colour;
+    }
+    std::vector<uint8_t> bytes(px.size() * sizeof(uint32_t));
+    std::memcpy(bytes.data(), px.data(), bytes.size());
+    return bytes;
+}
+
+static std::string assetName(uint32_t i) {
+    char name[48];
+    std::snprintf(name, sizeof(name), "tiles/set%03u/tile%06u.argb", i % 97, i);
+    return name;
+}
+
+static bool run(const char* path, uint32_t count) {
+    AssetPackWriter writer;
+    std::vector<std::vector<uint8_t>> assets(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        assets[i] = makeAsset(i);
+        if (!writer.add(assetName(i), assets[i].data(), assets[i].size(), true)) return false;
+    }
+    if (!writer.save(path)) {
+        std::fprintf(stderr, "Cannot write %s\n", path);
+        return false;
+    }
+    double openNs = 1e30;
+    AssetPack pack;
+    for (int run = 0; run < BEST_OF; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        bool opened = pack.open(path);
+        openNs = std::min(openNs, nsSince(start));
+        if (!opened) return false;
+    }
+    // Lookups in random order, names prepared up front
+    std::vector<std::string> names(count);
+    std::vector<uint32_t> order(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        names[i] = assetName(i);
+        order[i] = i;
+    }
+    RngStream rng(0x5EEDull, RngSystem::Spawn, count, 0);
+    for (uint32_t i = count; i > 1; --i) std::swap(order[i - 1], order[rng.nextU32() % i]);
+    double findNs = 1e30;
+    size_t found = 0;
+    for (int run = 0; run < BEST_OF; ++run) {
+        found = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i : order) {
+            AssetView v;
+            found += pack.find(names[i].c_str(), v);
+        }
+        findNs = std::min(findNs, nsSince(start) / count);
+    }
+    // Round trip, outside the timing
+    bool ok = found == count;
+    size_t compressed = 0, raw = 0, stored = 0;
+    std::vector<uint8_t> decoded;
+    for (uint32_t i = 0; ok && i < count; ++i) {
+        AssetView v;
+        ok = pack.find(names[i].c_str(), v) && v.rawSize == assets[i].size();
+        if (!ok) break;
+        decoded.resize(v.rawSize);
+        ok = assetDecode(v, decoded.data()) && decoded == assets[i];
+        if (v.compression == AssetCompression::None) ok = ok && (uintptr_t)v.data % ASSET_PACK_ALIGN == 0;
+        compressed += v.compression != AssetCompression::None;
+        raw += v.rawSize;
+        stored += v.size;
+    }
+    AssetView missing;
+    ok = ok && !pack.find("tiles/none.argb", missing);
+    std::printf("%8u %10.2f %9.1f%% %6zu %12.1f %10.1f %10s\n", count, pack.file.size / 1048576.0,
+                raw ? 100.0 * stored / raw : 0.0, compressed, openNs / 1000.0, findNs, ok ? "yes" : "NO");
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    const char* path = argc > 1 ? argv[1] : "bench_assets.pak";
+    std::printf("%8s %10s %10s %6s %12s %10s %10s\n", "assets", "pack MB", "stored", "lz", "open us", "find ns",
+                "identical");
+    bool ok = true;
+    for (uint32_t count : { 100u, 1000u, 10000u, 100000u }) ok = run(path, count) && ok;
+    std::remove(path);
+    return ok ? 0 : 1;
+}
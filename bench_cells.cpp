@@ -0,0 +1,112 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "cellular.h"
+#include "job_system.h"
+#include "rng.h"
+
+// Cellular Tiles Benchmark (Section 15)
+// A wide map with scattered ledges and its upper third full of sand, water
+// and lava, so nearly every chunk is active at first.  Steps the automaton,
+// once on the calling thread and once per worker count, and reports the
+// step cost while everything falls, the active chunks per step, how many
+// steps the map takes to come to rest, and the cost once it has.  Every parallel run must end with tiles
+// identical to the serial run; the tool exits non-zero if one does not.
+// Build with -U__SSE2__ (or -mno-sse2 on 32-bit) to time the scalar rows.
+//
+// Build: g++ -O2 -std=c++17 -pthread bench_cells.cpp -o bench_cells
+// Usage: bench_cells [width] [height] [steps]
+
+static std::vector<uint8_t> makeMap(int w, int h) {
+    std::vector<uint8_t> map((size_t)w * h, TILE_EMPTY);
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            RngStream rng(0x5A9Dull, RngSystem::Spawn, (uint32_t)(y * w + x), 0);
+            uint8_t t = TILE_EMPTY;
+            if (y == h - 1) t = TILE_BEDROCK;
+            else if (y < h / 3) {
+                float r = rng.range(0.0f, 1.0f);
+                t = r < 0.35f ? TILE_SAND : r < 0.65f ? TILE_WATER : r < 0.7f ? TILE_LAVA : TILE_EMPTY;
+            } else if (y % 12 == 0 && (x / 10) % 3 == (y / 12) % 3) t = TILE_GROUND;   // ledges
+            map[(size_t)y * w + x] = t;
+        }
+    }
+    return map;
+}
+
+struct Run {
+    double fallingMs;
+    double settledMs;
+    size_t activePerStep;
+    int settleSteps;
+    std::vector<uint8_t> tiles;
+};
+
+static Run run(const std::vector<uint8_t>& map, int w, int h, int steps, unsigned threads) {
+    Terrain terrain;
+    terrain.load(map.data(), w, h);
+    CellWorld cells;
+    cells.reset(terrain);
+    JobSystem jobs;
+    if (threads > 0) jobs.start(threads);
+    Player player;     // spawns outside the map, blocks nothing
+    player.position = WorldPos::fromPixels(-1000.0, -1000.0);
+    PhysicsWorld physics;     // no bodies
+    const float dt = 1.0f / CELL_HZ;
+    Run r{ 0.0, 0.0, 0, steps, {} };
+    std::vector<uint32_t> rebuilt;
+    for (int s = 0; s < steps; ++s) {
+        terrain.editedThisTick = { 0, 0, -1, -1 };
+        auto start = std::chrono::steady_clock::now();
+        cells.step(dt, player, physics, threads > 0 ? &jobs : nullptr);
+        r.fallingMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        r.activePerStep += cells.activeChunks;
+        // Chunk rebuilds are the frame's job (Terrain::update), not timed here
+        terrain.update(terrain.chunksX * terrain.chunksY);
+        terrain.takeRebuilt(rebuilt);
+    }
+    // Let it come to rest, then time the idle cost
+    while (cells.activeChunks && r.settleSteps < 100000) {
+        terrain.editedThisTick = { 0, 0, -1, -1 };
+        cells.step(dt, player, physics, threads > 0 ? &jobs : nullptr);
+        ++r.settleSteps;
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (int s = 0; s < steps; ++s) cells.step(dt, player, physics, threads > 0 ? &jobs : nullptr);
+    r.settledMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    r.tiles = terrain.tiles;
+    return r;
+}
+
+int main(int argc, char** argv) {
+    int w = argc > 1 ? std::atoi(argv[1]) : 1024;
+    int h = argc > 2 ? std::atoi(argv[2]) : 256;
+    int steps = argc > 3 ? std::atoi(argv[3]) : 120;
+    unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<uint8_t> map = makeMap(w, h);
+    std::printf("%dx%d tiles (%d chunks), %d steps, %u hardware threads (%s rows)\n", w, h,
+                ((w + TERRAIN_CHUNK_TILES - 1) / TERRAIN_CHUNK_TILES) * ((h + TERRAIN_CHUNK_TILES - 1) / TERRAIN_CHUNK_TILES),
+                steps, hw,
+#if defined(CELLS_HAS_SSE2)
+                "SSE2"
+#else
+                "scalar"
+#endif
+    );
+    Run serial = run(map, w, h, steps, 0);
+    std::printf("%8s %12s %14s %14s %12s %10s\n", "threads", "falling ms", "active/step", "settled after",
+                "settled ms", "identical");
+    std::printf("%8s %12.3f %14zu %14d %12.4f %10s\n", "serial", serial.fallingMs / steps,
+                serial.activePerStep / steps, serial.settleSteps, serial.settledMs / steps, "-");
+    bool allSame = true;
+    for (unsigned t : { 1u, 2u, 4u, 8u, hw }) {
+        Run r = run(map, w, h, steps, t);
+        bool same = r.tiles == serial.tiles;
+        allSame = allSame && same;
+        std::printf("%8u %12.3f %14zu %14d %12.4f %10s\n", t, r.fallingMs / steps,
+                    r.activePerStep / steps, r.settleSteps, r.settledMs / steps, same ? "yes" : "NO");
+    }
+    return allSame ? 0 : 1;
+}
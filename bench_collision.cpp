@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "rng.h"
+#include "sim.h"
+
+// Tile Collision Benchmark (Section 7)
+// A crowd of boxes runs, jumps and bounces off walls at 60 Hz, resolving
+// against the tiles every tick through TileBox<W, H> (size fixed at compile
+// time, probe loops unrolled) and through DynamicTileBox (the same size at
+// run time, loops with early exits), for the player's box and a larger one,
+// in an open room and in a room with scattered solid tiles.  Reports the
+// best of five runs in ns per box per tick; every box must end in the same
+// place both ways, or the tool exits non-zero.
+//
+// Build: g++ -O2 -std=c++17 bench_collision.cpp -o bench_collision
+// Usage: bench_collision [boxes] [ticks]
+
+constexpr int BEST_OF = 5;
+
+struct Sample {
+    WorldPos pos;
+    Vec2 velocity;
+};
+
+static std::vector<Sample> makeSamples(int count, int mapW, int mapH) {
+    std::vector<Sample> samples((size_t)count);
+    for (int i = 0; i < count; ++i) {
+        RngStream rng(0xC011ull, RngSystem::Spawn, (uint32_t)i, 0);
+        Sample& s = samples[(size_t)i];
+        s.pos = WorldPos::fromPixels(rng.range(0.0f, (float)(mapW * TILE_SIZE)), rng.range(0.0f, (float)(mapH * TILE_SIZE)));
+        s.velocity = { rng.range(0.0f, 1.0f) < 0.5f ? -MAX_RUN_SPEED : MAX_RUN_SPEED, 0.0f };
+    }
+    return samples;
+}
+
+// Player-style integration: gravity, jump on landing every so often, turn
+// around at walls
+template <typename Box>
+static double timeTicks(const Box& box, const std::vector<Sample>& in, std::vector<Sample>& out,
+                        const SolidityBitmap& tiles, int ticks) {
+    const float dt = 1.0f / 60.0f;
+    out = in;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; ++t) {
+        for (size_t i = 0; i < out.size(); ++i) {
+            Sample& s = out[i];
+            const float runX = s.velocity.x;
+            s.velocity.y += GRAVITY * dt;
+            s.pos.x.local += s.velocity.x * dt;
+            s.pos.y.local += s.velocity.y * dt;
+            bool landed = resolveTileCollisions(box, s.pos, s.velocity, tiles);
+            if (s.velocity.x == 0.0f) s.velocity.x = -runX;
+            if (landed && ((uint32_t)t + (uint32_t)i) % 45 == 0) s.velocity.y = JUMP_V0;
+            s.pos.normalize();
+        }
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return ns / ((double)ticks * in.size());
+}
+
+static bool same(const std::vector<Sample>& a, const std::vector<Sample>& b) {
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].pos.x.chunk != b[i].pos.x.chunk || a[i].pos.x.local != b[i].pos.x.local ||
+            a[i].pos.y.chunk != b[i].pos.y.chunk || a[i].pos.y.local != b[i].pos.y.local ||
+            a[i].velocity.x != b[i].velocity.x || a[i].velocity.y != b[i].velocity.y) return false;
+    }
+    return true;
+}
+
+template <int W, int H>
+static bool compare(const char* name, const std::vector<Sample>& samples, const SolidityBitmap& tiles, int ticks) {
+    std::vector<Sample> fixedOut, dynamicOut;
+    // Best of several alternating runs, to keep the machine's noise out
+    double dynamicNs = 1e30, fixedNs = 1e30;
+    for (int run = 0; run < BEST_OF; ++run) {
+        dynamicNs = std::min(dynamicNs, timeTicks(DynamicTileBox{ W, H }, samples, dynamicOut, tiles, ticks));
+        fixedNs = std::min(fixedNs, timeTicks(TileBox<W, H>{}, samples, fixedOut, tiles, ticks));
+    }
+    bool ok = same(fixedOut, dynamicOut);
+    std::printf("%-10s %4dx%-4d %4dx%-3d %12.2f %12.2f %9.2fx %10s\n", name, W, H, TileBox<W, H>::SPAN_X,
+                TileBox<W, H>::SPAN_Y, dynamicNs, fixedNs, dynamicNs / fixedNs, ok ? "yes" : "NO");
+    return ok;
+}
+
+// Solid border; inside it, `density` of the tiles are solid at random
+static SolidityBitmap makeMap(int w, int h, float density) {
+    std::vector<uint8_t> map((size_t)w * h);
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            RngStream rng(0x711Eull, RngSystem::Spawn, (uint32_t)(y * w + x), 0);
+            bool border = x == 0 || y == 0 || x == w - 1 || y == h - 1;
+            map[(size_t)y * w + x] = border || rng.range(0.0f, 1.0f) < density ? TILE_GROUND : TILE_EMPTY;
+        }
+    }
+    SolidityBitmap tiles;
+    tiles.build(map.data(), w, h);
+    return tiles;
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 10000;
+    int ticks = argc > 2 ? std::atoi(argv[2]) : 300;
+    const int mapW = 512, mapH = 128;
+    std::vector<Sample> samples = makeSamples(count, mapW, mapH);
+    std::printf("%d boxes x %d ticks on a %dx%d map\n", count, ticks, mapW, mapH);
+    bool ok = true;
+    // An open room (outcomes mostly predictable), then one where about one
+    // tile in eight is solid (landings and wall hits at random)
+    for (float density : { 0.0f, 0.125f }) {
+        SolidityBitmap tiles = makeMap(mapW, mapH, density);
+        std::printf("\n%.1f%% solid\n%-10s %9s %8s %12s %12s %10s %10s\n", density * 100.0f, "box", "size", "span",
+                    "runtime ns", "template ns", "speedup", "identical");
+        ok = compare<PLAYER_W, PLAYER_H>("player", samples, tiles, ticks) && ok;
+        ok = compare<48, 64>("large", samples, tiles, ticks) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "crowd.h"
+#include "rng.h"
+
+// Crowd Separation Check (Section 11)
+// Compares CrowdSeparation::compute against a brute-force O(n²) sum over
+// every pair within the radius: first pairs of grunts a fixed distance
+// apart at thousands of positions (cells that hash to the same bucket
+// must not count a neighbour twice), then a scattered crowd, checking the
+// grunts whose cells hold fewer candidates than the caps allow.  Reports the time of
+// both; exits non-zero on any push that differs by more than rounding.
+//
+// Build: g++ -O2 -std=c++17 bench_crowd.cpp -o bench_crowd
+// Usage: bench_crowd [grunts]
+
+constexpr float TOLERANCE = 1e-4f;
+
+static void bruteForce(float radius, const std::vector<float>& xs, const std::vector<float>& ys,
+                       std::vector<float>& pushX, std::vector<float>& pushY, std::vector<int>& neighbours) {
+    const size_t n = xs.size();
+    pushX.assign(n, 0.0f);
+    pushY.assign(n, 0.0f);
+    neighbours.assign(n, 0);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            if (i == j) continue;
+            float dx = xs[i] - xs[j], dy = ys[i] - ys[j];
+            if (dx * dx + dy * dy >= radius * radius) continue;
+            if (dx == 0.0f && dy == 0.0f) dx = i < j ? -0.01f : 0.01f;
+            float d = std::sqrt(dx * dx + dy * dy);
+            float w = std::max(0.0f, 1.0f - d / radius) / d;
+            pushX[i] += dx * w;
+            pushY[i] += dy * w;
+            ++neighbours[i];
+        }
+    }
+}
+
+// Whether every entity in grunt i's nine cells fits under the candidate cap
+// and its true neighbours under the neighbour cap, so that compute() cannot
+// have stopped early and must match the brute force
+static bool underCaps(const CrowdSeparation& crowd, const std::vector<float>& xs, const std::vector<float>& ys,
+                      size_t i, int neighbours) {
+    const SpatialGrid& grid = crowd.grid;
+    const int cx = grid.cellCoord(xs[i]), cy = grid.cellCoord(ys[i]);
+    uint32_t seen[9];
+    int seenCount = 0;
+    size_t candidates = 0;
+    for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+            const uint32_t bucket = grid.bucket(cx + dx, cy + dy);
+            if (std::find(seen, seen + seenCount, bucket) != seen + seenCount) continue;
+            seen[seenCount++] = bucket;
+            candidates += (size_t)(grid.bucketEnd(cx + dx, cy + dy) - grid.bucketBegin(cx + dx, cy + dy));
+        }
+    }
+    return candidates - 1 <= (size_t)CROWD_MAX_CANDIDATES && neighbours <= CROWD_MAX_NEIGHBOURS;
+}
+
+static bool close(float a, float b) {
+    return std::fabs(a - b) <= TOLERANCE * std::max(1.0f, std::fabs(b));
+}
+
+// Two grunts `gap` px apart, placed all over the map
+static int checkPairs(float gap, int placements) {
+    CrowdSeparation crowd;
+    std::vector<float> xs(2), ys(2), px(2), py(2), bx, by;
+    std::vector<int> neighbours;
+    int failures = 0;
+    for (int p = 0; p < placements; ++p) {
+        RngStream rng(0xC40Dull, RngSystem::Spawn, (uint32_t)p, 0);
+        xs[0] = rng.range(0.0f, 4000.0f);
+        ys[0] = rng.range(0.0f, 1000.0f);
+        xs[1] = xs[0] + gap;
+        ys[1] = ys[0];
+        crowd.compute(xs.data(), ys.data(), 2, px.data(), py.data());
+        bruteForce(crowd.radius, xs, ys, bx, by, neighbours);
+        for (int i = 0; i < 2; ++i) failures += !(close(px[i], bx[i]) && close(py[i], by[i]));
+    }
+    return failures;
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 2000;
+    bool ok = true;
+
+    const int placements = 3200;
+    int pairFailures = checkPairs(11.0f, placements);
+    std::printf("pairs 11 px apart: %d/%d placements differ\n", pairFailures, placements);
+    ok = ok && pairFailures == 0;
+
+    // A scattered crowd at about one grunt per radius², sparse enough that
+    // most grunts examine every candidate in their nine cells
+    CrowdSeparation crowd;
+    const float side = std::sqrt((float)count) * crowd.radius;
+    std::vector<float> xs((size_t)count), ys((size_t)count), px((size_t)count), py((size_t)count), bx, by;
+    std::vector<int> neighbours;
+    for (int i = 0; i < count; ++i) {
+        RngStream rng(0xC40Eull, RngSystem::Spawn, (uint32_t)i, 0);
+        xs[(size_t)i] = rng.range(0.0f, side);
+        ys[(size_t)i] = rng.range(0.0f, side);
+    }
+    auto start = std::chrono::steady_clock::now();
+    crowd.compute(xs.data(), ys.data(), xs.size(), px.data(), py.data());
+    double gridUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    bruteForce(crowd.radius, xs, ys, bx, by, neighbours);
+    double bruteUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    // The caps only let a grunt see part of a crowded neighbourhood, so only
+    // the grunts under them have a single right answer
+    int checked = 0, failures = 0;
+    for (size_t i = 0; i < xs.size(); ++i) {
+        if (!underCaps(crowd, xs, ys, i, neighbours[i])) continue;
+        ++checked;
+        failures += !(close(px[i], bx[i]) && close(py[i], by[i]));
+    }
+    std::printf("crowd of %d: %d/%d checked grunts differ, grid %.0f us, brute force %.0f us\n", count, failures,
+                checked, gridUs, bruteUs);
+    ok = ok && failures == 0;
+    return ok ? 0 : 1;
+}
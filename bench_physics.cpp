@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "physics.h"
+
+// Crate Physics Benchmark (Section 14)
+// Stacks columns of crates on a tile floor at 60 Hz, plus a kinematic
+// platform that slides back and forth with a small stack riding on it.
+// Reports the step cost while the piles settle and once they are asleep,
+// how many bodies sleep, and how far the resting stacks sank or drifted.
+// Then reruns a few stacks with the floor FAR_TILES into the bitmap and the
+// tile origin moved there (a long level, sim.h SimOrigin); exits non-zero
+// unless they end exactly where the ones at the map's corner do.
+// Build with -U__SSE2__ (or -mno-sse2 on 32-bit) to time the scalar rows.
+//
+// Build: g++ -O2 -std=c++17 -pthread bench_physics.cpp -o bench_physics
+// Usage: bench_physics [crates] [steps]
+
+constexpr float TILE = 16.0f;
+constexpr int   STACK_HEIGHT = 10;
+constexpr int   FAR_TILES = 1 << 16;     // a million px into the level
+
+// A few stacks on a floor starting `originTile` tiles into the bitmap,
+// stepped with the tile origin there; returns the final body positions
+static std::vector<float> farStacks(int originTile, int steps, float dt) {
+    const int width = 24, height = STACK_HEIGHT + 4;
+    std::vector<uint8_t> map((size_t)(originTile + width) * height, 0);
+    for (int x = 0; x < width; ++x) map[(size_t)(height - 1) * (originTile + width) + originTile + x] = 1;
+    SolidityBitmap tiles;
+    tiles.build(map.data(), originTile + width, height);
+    PhysicsWorld world;
+    world.setTiles(tiles, TILE);
+    world.setTileOrigin(originTile, 0);
+    for (int i = 0; i < STACK_HEIGHT * 4; ++i) {
+        int col = i / STACK_HEIGHT, row = i % STACK_HEIGHT;
+        world.bodies.add((col * 4 + 2) * TILE + 8.0f, (height - 1) * TILE - row * TILE - 8.0f, 8.0f, 8.0f, 1.0f, 0.6f, false);
+    }
+    for (int s = 0; s < steps; ++s) world.step(dt);
+    std::vector<float> out(world.bodies.x);
+    out.insert(out.end(), world.bodies.y.begin(), world.bodies.y.end());
+    return out;
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 4000;
+    int steps = argc > 2 ? std::atoi(argv[2]) : 600;
+    const float dt = 1.0f / 60.0f;
+
+    // Floor of tiles wide enough for every column with a gap between them
+    int columns = (count + STACK_HEIGHT - 1) / STACK_HEIGHT;
+    int width = columns * 2 + 16, height = STACK_HEIGHT + 8;
+    std::vector<uint8_t> map((size_t)width * height, 0);
+    for (int x = 0; x < width; ++x) map[(size_t)(height - 1) * width + x] = 1;
+    SolidityBitmap tiles;
+    tiles.build(map.data(), width, height);
+
+    PhysicsWorld world;
+    world.setTiles(tiles, TILE);
+    const float floorY = (height - 1) * TILE;
+    for (int i = 0; i < count; ++i) {
+        int col = i / STACK_HEIGHT, row = i % STACK_HEIGHT;
+        world.bodies.add((col * 2 + 1) * TILE + 8.0f, floorY - row * TILE - 8.0f, 8.0f, 8.0f, 1.0f, 0.6f, false);
+    }
+    // Moving platform above the floor at the far end, three crates on it
+    float platformX = (width - 8) * TILE;
+    float platformY = floorY - (STACK_HEIGHT + 2) * TILE;
+    uint32_t platform = world.bodies.add(platformX, platformY, 32.0f, 4.0f, 0.0f, 0.8f, true);
+    uint32_t riders = (uint32_t)world.bodies.size();
+    for (int k = 0; k < 3; ++k) {
+        world.bodies.add(platformX, platformY - 4.0f - k * TILE - 8.0f, 8.0f, 8.0f, 1.0f, 0.8f, false);
+    }
+    std::vector<float> startX(world.bodies.x.begin(), world.bodies.x.begin() + count);
+    std::vector<float> startY(world.bodies.y.begin(), world.bodies.y.begin() + count);
+
+    double settleMs = 0.0, restMs = 0.0;
+    int settleSteps = 0, restSteps = 0;
+    for (int s = 0; s < steps; ++s) {
+        // Platform: 1.5 s each way at 40 px/s
+        world.bodies.vx[platform] = (s / 90) % 2 ? -40.0f : 40.0f;
+        auto t0 = std::chrono::steady_clock::now();
+        world.step(dt);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        if (s < steps / 2) { settleMs += ms; ++settleSteps; }
+        else               { restMs += ms; ++restSteps; }
+    }
+
+    float sink = 0.0f, drift = 0.0f;
+    for (int i = 0; i < count; ++i) {
+        sink = std::max(sink, world.bodies.y[i] - startY[i]);
+        drift = std::max(drift, std::abs(world.bodies.x[i] - startX[i]));
+    }
+    float riderOffset = 0.0f;
+    for (uint32_t k = 0; k < 3; ++k) {
+        riderOffset = std::max(riderOffset, std::abs(world.bodies.x[riders + k] - world.bodies.x[platform]));
+    }
+    std::printf("%d crates in %d stacks, %d steps at 60 Hz (%s rows)\n", count, columns, steps,
+#if defined(PHYSICS_HAS_SSE2)
+                "SSE2"
+#else
+                "scalar"
+#endif
+    );
+    std::printf("  first half   %8.3f ms/step\n", settleMs / std::max(settleSteps, 1));
+    std::printf("  second half  %8.3f ms/step\n", restMs / std::max(restSteps, 1));
+    std::printf("  sleeping     %u / %zu dynamic bodies\n", world.sleepingBodies, world.bodies.size() - 1);
+    std::printf("  max sink %.2f px, max drift %.2f px, riders off platform centre %.2f px\n",
+                sink, drift, riderOffset);
+
+    const bool farSame = farStacks(FAR_TILES, steps, dt) == farStacks(0, steps, dt);
+    std::printf("  stacks %d tiles in: %s\n", FAR_TILES, farSame ? "same as at the origin" : "DIFFER");
+    return farSame ? 0 : 1;
+}
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "verlet.h"
+
+// Verlet Rope Benchmark (Section 14)
+// Drops a field of horizontal ropes (every fourth one a bridge) over a
+// tile floor and lets them swing, stepping at 60 Hz.  Ropes are long enough
+// to drape on the floor, so tile collision is exercised.  Reports
+// the step cost, the worst link stretch after relaxation, and whether any
+// particle array was reallocated during stepping (it must not be).  Then
+// reruns a few ropes with the floor FAR_TILES into the bitmap and the tile
+// origin moved there (a long level, sim.h SimOrigin), which must end
+// exactly where the ones at the map's corner do.
+// Build with -U__SSE2__ (or -mno-sse2 on 32-bit) to time the scalar rows.
+//
+// Build: g++ -O2 -std=c++17 bench_ropes.cpp -o bench_ropes
+// Usage: bench_ropes [ropes] [links] [steps]
+
+constexpr float TILE = 16.0f;
+constexpr int   FAR_TILES = 1 << 16;     // a million px into the level
+
+// A few draping ropes over a floor starting `originTile` tiles into the
+// bitmap, stepped with the tile origin there; returns the final positions
+static std::vector<float> farRopes(int originTile, int links, int steps, float dt) {
+    const int width = links + 24, height = 40;
+    std::vector<uint8_t> map((size_t)(originTile + width) * height, 0);
+    for (int x = 0; x < width; ++x) map[(size_t)(height - 1) * (originTile + width) + originTile + x] = 1;
+    // Ropes swing past the left edge, which must read as solid in both maps
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < originTile; ++x) map[(size_t)y * (originTile + width) + x] = 1;
+    }
+    SolidityBitmap tiles;
+    tiles.build(map.data(), originTile + width, height);
+    VerletSystem verlet;
+    verlet.setTiles(tiles, TILE);
+    verlet.setTileOrigin(originTile, 0);
+    for (int r = 0; r < 8; ++r) {
+        float ax = (r * 2 + 2) * TILE, ay = (height - 1) * TILE - links * 14.0f;
+        verlet.addRope(ax, ay, ax + links * 16.0f, ay, links, r % 4 == 3, r % 4 == 3 ? 1.1f : 1.0f);
+    }
+    for (int s = 0; s < steps; ++s) verlet.step(dt);
+    std::vector<float> out(verlet.x);
+    out.insert(out.end(), verlet.y.begin(), verlet.y.end());
+    return out;
+}
+
+int main(int argc, char** argv) {
+    int ropes = argc > 1 ? std::atoi(argv[1]) : 500;
+    int links = argc > 2 ? std::atoi(argv[2]) : 24;
+    int steps = argc > 3 ? std::atoi(argv[3]) : 600;
+    const float dt = 1.0f / 60.0f;
+
+    int width = ropes * 2 + links + 8, height = 40;
+    std::vector<uint8_t> map((size_t)width * height, 0);
+    for (int x = 0; x < width; ++x) map[(size_t)(height - 1) * width + x] = 1;
+    SolidityBitmap tiles;
+    tiles.build(map.data(), width, height);
+
+    VerletSystem verlet;
+    verlet.setTiles(tiles, TILE);
+    for (int r = 0; r < ropes; ++r) {
+        // Ropes start horizontal and swing down; anchored low enough that
+        // they are ~2 px per link too long to clear the floor
+        float ax = (r * 2 + 2) * TILE, ay = (height - 1) * TILE - links * 14.0f;
+        verlet.addRope(ax, ay, ax + links * 16.0f, ay, links, r % 4 == 3, r % 4 == 3 ? 1.1f : 1.0f);
+    }
+    const float* xData = verlet.x.data();
+    const uint32_t* cData = verlet.ca.data();
+    auto start = std::chrono::steady_clock::now();
+    for (int s = 0; s < steps; ++s) verlet.step(dt);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    bool stable = xData == verlet.x.data() && cData == verlet.ca.data();
+
+    float stretch = 0.0f;
+    for (size_t c = 0; c < verlet.ca.size(); ++c) {
+        uint32_t a = verlet.ca[c], b = verlet.cb[c];
+        if (a == 0) continue;
+        float len = std::sqrt((verlet.x[b] - verlet.x[a]) * (verlet.x[b] - verlet.x[a]) +
+                              (verlet.y[b] - verlet.y[a]) * (verlet.y[b] - verlet.y[a]));
+        stretch = std::max(stretch, len / verlet.rest[c] - 1.0f);
+    }
+    float lowest = 0.0f;
+    for (size_t i = 1; i < verlet.y.size(); ++i) lowest = std::max(lowest, verlet.y[i]);
+
+    std::printf("%d ropes x %d links (%zu particles, %zu constraint rows), %d steps, %d iterations (%s rows)\n",
+                ropes, links, verlet.particleCount(), verlet.ca.size() / 4, steps, verlet.iterations,
+#if defined(VERLET_HAS_SSE2)
+                "SSE2"
+#else
+                "scalar"
+#endif
+    );
+    std::printf("  %.3f ms/step\n", ms / steps);
+    std::printf("  max stretch %.2f%%, lowest particle %.1f px (floor at %.1f)\n",
+                stretch * 100.0f, lowest, (height - 1) * TILE);
+    std::printf("  arrays reallocated while stepping: %s\n", stable ? "no" : "YES");
+
+    const bool farSame = farRopes(FAR_TILES, links, steps, dt) == farRopes(0, links, steps, dt);
+    std::printf("  ropes %d tiles in: %s\n", FAR_TILES, farSame ? "same as at the origin" : "DIFFER");
+    return stable && farSame ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "sim.h"
+#include "crowd.h"
+#include "rng.h"
+#include "tick_rate.h"
+
+// Tick Rate Benchmark (Section 0)
+// Runs the headless simulation for a fixed amount of game time at each
+// supported tick rate and reports what that costs in CPU.  The workload is
+// the skeleton's player + camera plus a patrolling grunt crowd with
+// separation steering, driven by a scripted input pattern expressed in
+// seconds so every rate plays the same scenario.
+//
+// Build: g++ -O2 -std=c++17 bench_tickrate.cpp -o bench_tickrate
+// Usage: bench_tickrate [grunts] [seconds]
+
+struct Crowd {
+    std::vector<float> x, y, vx, pushX, pushY;
+    CrowdSeparation separation;
+    float left{ 0.0f }, right{ 0.0f };
+
+    void spawn(int count, float patrolLeft, float patrolRight) {
+        left = patrolLeft;
+        right = patrolRight;
+        x.resize(count); y.resize(count); vx.resize(count);
+        pushX.resize(count); pushY.resize(count);
+        for (int i = 0; i < count; ++i) {
+            RngStream rng(0xBE7C4ull, RngSystem::Spawn, (uint32_t)i, 0);
+            x[i] = rng.range(left, right);
+            y[i] = rng.range(0.0f, 8.0f);
+            vx[i] = rng.nextFloat() < 0.5f ? -40.0f : 40.0f;
+        }
+    }
+
+    void update(float dt) {
+        for (size_t i = 0; i < x.size(); ++i) {
+            x[i] += vx[i] * dt;
+            if ((vx[i] < 0 && x[i] <= left) || (vx[i] > 0 && x[i] >= right)) vx[i] = -vx[i];
+        }
+        separation.compute(x.data(), y.data(), x.size(), pushX.data(), pushY.data());
+        for (size_t i = 0; i < x.size(); ++i) x[i] += pushX[i] * 90.0f * dt;
+    }
+};
+
+// Same inputs for the same moment in game time at every rate
+static PlayerInput scriptedInput(float t) {
+    PlayerInput in;
+    float phase = std::fmod(t, 4.0f);
+    in.right = phase < 2.0f;
+    in.left  = phase >= 2.5f && phase < 3.5f;
+    in.jump  = std::fmod(t, 1.3f) < 0.05f;
+    return in;
+}
+
+struct Result {
+    double secondsPerRun;
+    uint64_t ticks;
+    float finalX;
+};
+
+static Result run(const TickRate& rate, int grunts, float gameSeconds) {
+    SolidityBitmap tiles;
+    tiles.build(LEVEL_DATA.data(), LEVEL_WIDTH, LEVEL_HEIGHT, tileSolid);
+    Player player;
+    player.position = WorldPos::fromPixels(100.0, 100.0);
+    Camera camera;
+    Crowd crowd;
+    crowd.spawn(grunts, 0.0f, grunts * 6.0f);
+    const uint64_t ticks = (uint64_t)(gameSeconds * rate.hz);
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t t = 0; t < ticks; ++t) {
+        player.update(scriptedInput(t * rate.dt), rate.dt, tiles);
+        camera.update(player.position, rate.dt);
+        crowd.update(rate.dt);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return { std::chrono::duration<double>(end - start).count(), ticks, (float)player.position.x.pixels() };
+}
+
+int main(int argc, char** argv) {
+    int grunts = argc > 1 ? std::atoi(argv[1]) : 512;
+    float gameSeconds = argc > 2 ? (float)std::atof(argv[2]) : 20.0f;
+    const int rates[] = { 60, 120, 240 };
+    const int repeats = 5;
+    std::printf("%d grunts, %.0f s of game time, best of %d\n", grunts, gameSeconds, repeats);
+    std::printf("%6s %10s %12s %14s %16s %10s\n", "rate", "ticks", "us/tick", "ms/game-sec", "% of 1 core", "player x");
+    double base = 0.0;
+    for (int hz : rates) {
+        TickRate rate = TickRate::fromHz(hz);
+        Result best{ 1e30, 0, 0.0f };
+        for (int r = 0; r < repeats; ++r) {
+            Result res = run(rate, grunts, gameSeconds);
+            if (res.secondsPerRun < best.secondsPerRun) best = res;
+        }
+        double usPerTick = best.secondsPerRun * 1e6 / (double)best.ticks;
+        double msPerGameSecond = best.secondsPerRun * 1e3 / gameSeconds;
+        if (hz == rates[0]) base = msPerGameSecond;
+        std::printf("%4d Hz %10llu %12.2f %14.3f %15.2f%% %10.1f  (x%.2f)\n",
+                    hz, (unsigned long long)best.ticks, usPerTick, msPerGameSecond,
+                    msPerGameSecond / 10.0, best.finalX, msPerGameSecond / base);
+    }
+    return 0;
+}
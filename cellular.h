@@ -0,0 +1,339 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "job_system.h"
+#include "physics.h"
+#include "sim.h"
+#include "terrain.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CELLS_HAS_SSE2 1
+#endif
+
+//----------------------------------------------------------------------------
+// Cellular Tiles (Section 15 – Level)
+//----------------------------------------------------------------------------
+// Falling sand, water and lava as a cellular automaton over Terrain::tiles,
+// stepped at its own fixed rate (CELL_HZ) from the simulation tick.
+//
+//   sand    falls, sinks through liquids, slides off slopes; never enters a
+//           tile overlapped by the player or a body
+//   water   falls, runs diagonally down, and flows sideways towards the
+//           nearest drop within CELL_WATER_REACH tiles, so it pools
+//   lava    like water with a shorter reach; turns to ground where it
+//           touches water, which boils away
+//
+// Only active chunks (Terrain's 16×16-tile chunks) are stepped.  A chunk
+// that changed stays active and wakes its eight neighbours; one that did
+// not goes to sleep until a neighbour or a terrain edit (wake()) wakes it.
+//
+// A chunk's rules read and write at most one tile outside it, so chunks two
+// apart in both axes never touch the same tile.  Active chunks are stepped
+// in four checkerboard phases by (cx & 1, cy & 1) and the chunks of a phase
+// run in parallel on the JobSystem; the result does not depend on the
+// thread count or schedule.  Cells that moved carry a flag bit (0x80) until
+// the end of the step so nothing moves twice.  Flow towards a drop looks
+// further than one tile and reads a snapshot taken at the start of the step.
+//
+// The vertical rules (fall, sink) run on a 16-tile chunk row at once in
+// SSE2 lanes; the sideways rules are scalar.  After the phases, each chunk's
+// changed rectangle is handed to Terrain::syncTiles(), which updates
+// solidity, queues chunk rebuilds (textures, minimap, nav) and extends
+// editedThisTick so crates.h wakes the bodies involved.
+//
+// step() is deterministic and runs in replays (with jobs == nullptr).
+//
+
+constexpr float CELL_HZ           = 30.0f;
+constexpr int   CELL_WATER_REACH  = 8;      // tiles water looks sideways for a drop
+constexpr int   CELL_LAVA_REACH   = 3;
+constexpr uint8_t CELL_MOVED      = 0x80;
+
+struct CellWorld {
+    Terrain* terrain{ nullptr };
+    std::vector<uint8_t> active, nextActive;    // per chunk
+    std::vector<TileRect> changed;              // per chunk, written only by its own task
+    std::vector<uint32_t> phase[4];
+    std::vector<uint8_t> snapshot;              // tiles at the start of the step
+    std::vector<uint8_t> blocked;               // 0xFF under the player and bodies
+    std::vector<TileRect> blockers;
+    float accumulator{ 0.0f };
+    uint32_t steps{ 0 };
+    size_t activeChunks{ 0 };                   // stepped by the last step
+    size_t changedChunks{ 0 };
+
+    void reset(Terrain& t) {
+        terrain = &t;
+        const size_t chunks = (size_t)t.chunksX * t.chunksY;
+        active.assign(chunks, 1);
+        nextActive.assign(chunks, 0);
+        changed.assign(chunks, TileRect{ 0, 0, -1, -1 });
+        for (std::vector<uint32_t>& p : phase) {
+            p.clear();
+            p.reserve(chunks / 4 + 2);
+        }
+        snapshot.assign(t.tiles.size(), 0);
+        blocked.assign(t.tiles.size(), 0);
+        accumulator = 0.0f;
+        steps = 0;
+        activeChunks = changedChunks = 0;
+    }
+
+    // Wake the chunks around edited tiles (bombs, crumbling)
+    void wake(const TileRect& area) { mark(active, area); }
+
+    void mark(std::vector<uint8_t>& flags, const TileRect& a) {
+        const Terrain& t = *terrain;
+        int cx0 = std::max(a.x0 - 1, 0) / TERRAIN_CHUNK_TILES, cx1 = std::min(a.x1 + 1, t.width - 1) / TERRAIN_CHUNK_TILES;
+        int cy0 = std::max(a.y0 - 1, 0) / TERRAIN_CHUNK_TILES, cy1 = std::min(a.y1 + 1, t.height - 1) / TERRAIN_CHUNK_TILES;
+        for (int cy = cy0; cy <= cy1; ++cy) {
+            for (int cx = cx0; cx <= cx1; ++cx) flags[(size_t)cy * t.chunksX + cx] = 1;
+        }
+    }
+
+    // Per simulation tick, after Terrain::step.  Runs as many automaton
+    // steps as CELL_HZ owes; changes land in terrain.editedThisTick.
+    void step(float dt, const Player& player, const PhysicsWorld& physics, JobSystem* jobs = nullptr) {
+        const TileRect& e = terrain->editedThisTick;
+        if (!e.empty()) wake(e);
+        accumulator += dt;
+        if (accumulator < 1.0f / CELL_HZ) return;
+        blockers.clear();
+        blockers.push_back({ player.position.x.tile(TILE_SIZE), player.position.y.tile(TILE_SIZE),
+                             player.position.x.tile(TILE_SIZE, PLAYER_W - 1),
+                             player.position.y.tile(TILE_SIZE, PLAYER_H - 1) });
+        const PhysicsBodies& bodies = physics.bodies;
+        const int ox = physics.tileOriginX, oy = physics.tileOriginY;
+        for (size_t i = 0; i < bodies.size(); ++i) {
+            blockers.push_back({ ox + (int)std::floor((bodies.x[i] - bodies.halfW[i]) / TILE_SIZE),
+                                 oy + (int)std::floor((bodies.y[i] - bodies.halfH[i]) / TILE_SIZE),
+                                 ox + (int)std::floor((bodies.x[i] + bodies.halfW[i] - 0.01f) / TILE_SIZE),
+                                 oy + (int)std::floor((bodies.y[i] + bodies.halfH[i] - 0.01f) / TILE_SIZE) });
+        }
+        fillBlocked(0xFF);
+        while (accumulator >= 1.0f / CELL_HZ) {
+            accumulator -= 1.0f / CELL_HZ;
+            stepOnce(jobs);
+        }
+        fillBlocked(0);
+    }
+
+    void fillBlocked(uint8_t value) {
+        const Terrain& t = *terrain;
+        for (const TileRect& r : blockers) {
+            int x0 = std::max(r.x0, 0), x1 = std::min(r.x1, t.width - 1);
+            for (int y = std::max(r.y0, 0); y <= std::min(r.y1, t.height - 1); ++y) {
+                if (x0 <= x1) std::memset(&blocked[(size_t)y * t.width + x0], value, (size_t)(x1 - x0 + 1));
+            }
+        }
+    }
+
+    void stepOnce(JobSystem* jobs) {
+        Terrain& t = *terrain;
+        activeChunks = changedChunks = 0;
+        for (std::vector<uint32_t>& p : phase) p.clear();
+        for (int c = 0; c < t.chunksX * t.chunksY; ++c) {
+            if (!active[c]) continue;
+            int cx = c % t.chunksX, cy = c / t.chunksX;
+            phase[(cx & 1) | ((cy & 1) << 1)].push_back((uint32_t)c);
+            ++activeChunks;
+        }
+        if (activeChunks == 0) return;
+        // Snapshot what the drop search can see: each active chunk, one row
+        // below and the reach to either side
+        for (const std::vector<uint32_t>& p : phase) {
+            for (uint32_t c : p) {
+                TileRect a = t.chunkTiles((int)c);
+                int x0 = std::max(a.x0 - CELL_WATER_REACH, 0), x1 = std::min(a.x1 + CELL_WATER_REACH, t.width - 1);
+                for (int y = a.y0; y <= std::min(a.y1 + 1, t.height - 1); ++y) {
+                    size_t row = (size_t)y * t.width;
+                    std::memcpy(&snapshot[row + x0], &t.tiles[row + x0], (size_t)(x1 - x0 + 1));
+                }
+            }
+        }
+        for (const std::vector<uint32_t>& p : phase) {
+            if (jobs) {
+                jobs->parallelFor(p.size(), 1, [&](size_t begin, size_t end, unsigned) {
+                    for (size_t i = begin; i < end; ++i) stepChunk(p[i]);
+                });
+            } else {
+                for (uint32_t c : p) stepChunk(c);
+            }
+        }
+        std::fill(nextActive.begin(), nextActive.end(), 0);
+        for (const std::vector<uint32_t>& p : phase) {
+            for (uint32_t c : p) {
+                if (changed[c].empty()) continue;
+                t.syncTiles(changed[c]);
+                mark(nextActive, changed[c]);
+                ++changedChunks;
+            }
+        }
+        active.swap(nextActive);
+        ++steps;
+    }
+
+    uint8_t get(int x, int y) const {
+        const Terrain& t = *terrain;
+        return t.inBounds(x, y) ? t.tiles[(size_t)y * t.width + x] : (uint8_t)TILE_BEDROCK;
+    }
+
+    static void touch(TileRect& ch, int x, int y) {
+        if (ch.empty()) ch = { x, y, x, y };
+        else ch = { std::min(ch.x0, x), std::min(ch.y0, y), std::max(ch.x1, x), std::max(ch.y1, y) };
+    }
+
+    void put(int x, int y, uint8_t id, TileRect& ch) {
+        terrain->tiles[(size_t)y * terrain->width + x] = id;
+        touch(ch, x, y);
+    }
+
+    static bool liquid(uint8_t id) {
+        id &= (uint8_t)~CELL_MOVED;
+        return id == TILE_WATER || id == TILE_LAVA;
+    }
+
+    bool isBlocked(int x, int y) const { return blocked[(size_t)y * terrain->width + x] != 0; }
+
+    void stepChunk(uint32_t c) {
+        const TileRect a = terrain->chunkTiles((int)c);
+        TileRect& ch = changed[c];
+        ch = { 0, 0, -1, -1 };
+        // Bottom-up, so a falling column moves as a whole
+        for (int y = a.y1; y >= a.y0; --y) {
+            if (y + 1 < terrain->height) fallRow(y, a.x0, a.x1, ch);
+            spreadRow(y, a.x0, a.x1, ch);
+        }
+    }
+
+    // Sand over empty or liquid and liquid over empty swap with the tile
+    // below; both end up flagged (an emptied tile stays 0).
+    void fallRow(int y, int x0, int x1, TileRect& ch) {
+        Terrain& t = *terrain;
+        uint8_t* cur = &t.tiles[(size_t)y * t.width];
+        uint8_t* below = cur + t.width;
+        const uint8_t* blk = &blocked[(size_t)(y + 1) * t.width];
+        int x = x0;
+#if defined(CELLS_HAS_SSE2)
+        const __m128i sand = _mm_set1_epi8((char)TILE_SAND), water = _mm_set1_epi8((char)TILE_WATER);
+        const __m128i lava = _mm_set1_epi8((char)TILE_LAVA), flag = _mm_set1_epi8((char)CELL_MOVED);
+        const __m128i zero = _mm_setzero_si128();
+        for (; x + 16 <= x1 + 1; x += 16) {
+            __m128i c = _mm_loadu_si128((const __m128i*)(cur + x));
+            __m128i b = _mm_loadu_si128((const __m128i*)(below + x));
+            __m128i k = _mm_loadu_si128((const __m128i*)(blk + x));
+            // Flagged tiles never equal a plain id, so they stay put
+            __m128i isSand = _mm_cmpeq_epi8(c, sand);
+            __m128i isLiquid = _mm_or_si128(_mm_cmpeq_epi8(c, water), _mm_cmpeq_epi8(c, lava));
+            __m128i bEmpty = _mm_cmpeq_epi8(b, zero);
+            __m128i bLiquid = _mm_or_si128(_mm_cmpeq_epi8(_mm_andnot_si128(flag, b), water),
+                                           _mm_cmpeq_epi8(_mm_andnot_si128(flag, b), lava));
+            __m128i m = _mm_or_si128(_mm_andnot_si128(k, _mm_and_si128(isSand, _mm_or_si128(bEmpty, bLiquid))),
+                                     _mm_and_si128(isLiquid, bEmpty));
+            int bits = _mm_movemask_epi8(m);
+            if (!bits) continue;
+            __m128i newBelow = _mm_or_si128(_mm_and_si128(m, _mm_or_si128(c, flag)), _mm_andnot_si128(m, b));
+            __m128i displaced = _mm_or_si128(b, _mm_and_si128(bLiquid, flag));
+            __m128i newCur = _mm_or_si128(_mm_and_si128(m, displaced), _mm_andnot_si128(m, c));
+            _mm_storeu_si128((__m128i*)(below + x), newBelow);
+            _mm_storeu_si128((__m128i*)(cur + x), newCur);
+            int first = 0, last = 15;
+            while (!(bits & (1 << first))) ++first;
+            while (!(bits & (1 << last))) --last;
+            touch(ch, x + first, y);
+            touch(ch, x + last, y + 1);
+        }
+#endif
+        for (; x <= x1; ++x) {
+            uint8_t c = cur[x], b = below[x];
+            bool fall = (c == TILE_SAND && (b == TILE_EMPTY || liquid(b)) && !blk[x]) ||
+                        ((c == TILE_WATER || c == TILE_LAVA) && b == TILE_EMPTY);
+            if (!fall) continue;
+            put(x, y + 1, (uint8_t)(c | CELL_MOVED), ch);
+            put(x, y, b == TILE_EMPTY ? (uint8_t)TILE_EMPTY : (uint8_t)(b | CELL_MOVED), ch);
+        }
+    }
+
+    // Scalar rules for what could not fall: slides, sideways flow and
+    // lava meeting water.  Direction preference alternates by tile and step.
+    void spreadRow(int y, int x0, int x1, TileRect& ch) {
+        const bool reverse = ((steps + (uint32_t)y) & 1) != 0;
+        for (int i = 0; i <= x1 - x0; ++i) {
+            const int x = reverse ? x1 - i : x0 + i;
+            const uint8_t t = get(x, y);
+            if (t != TILE_SAND && t != TILE_WATER && t != TILE_LAVA) continue;
+            const int pref = ((x + y + (int)steps) & 1) ? 1 : -1;
+            if (t == TILE_LAVA && quench(x, y, ch)) continue;
+            if (t == TILE_SAND) {
+                for (int d : { pref, -pref }) {
+                    uint8_t side = get(x + d, y), diag = get(x + d, y + 1);
+                    if (!(side == TILE_EMPTY || liquid(side)) || !(diag == TILE_EMPTY || liquid(diag))) continue;
+                    if (isBlocked(x + d, y + 1)) continue;
+                    put(x + d, y + 1, (uint8_t)(TILE_SAND | CELL_MOVED), ch);
+                    put(x, y, diag == TILE_EMPTY ? (uint8_t)TILE_EMPTY : (uint8_t)(diag | CELL_MOVED), ch);
+                    break;
+                }
+                continue;
+            }
+            bool moved = false;
+            for (int d : { pref, -pref }) {
+                if (get(x + d, y) != TILE_EMPTY || get(x + d, y + 1) != TILE_EMPTY) continue;
+                put(x + d, y + 1, (uint8_t)(t | CELL_MOVED), ch);
+                put(x, y, TILE_EMPTY, ch);
+                moved = true;
+                break;
+            }
+            if (moved || get(x, y + 1) == TILE_EMPTY) continue;
+            const int reach = t == TILE_LAVA ? CELL_LAVA_REACH : CELL_WATER_REACH;
+            int left = dropDistance(x, y, -1, reach), right = dropDistance(x, y, 1, reach);
+            int d = 0;
+            if (left && (!right || left < right)) d = -1;
+            else if (right && (!left || right < left)) d = 1;
+            else if (left) d = pref;
+            if (d && get(x + d, y) == TILE_EMPTY) {
+                put(x + d, y, (uint8_t)(t | CELL_MOVED), ch);
+                put(x, y, TILE_EMPTY, ch);
+            }
+        }
+    }
+
+    // Tiles to the nearest empty tile with empty below it, through empty
+    // tiles of row y, in the step's snapshot; 0 if none within reach.
+    int dropDistance(int x, int y, int dir, int reach) const {
+        const Terrain& t = *terrain;
+        for (int k = 1; k <= reach; ++k) {
+            int sx = x + dir * k;
+            if (sx < 0 || sx >= t.width || snapshot[(size_t)y * t.width + sx] != TILE_EMPTY) return 0;
+            if (y + 1 < t.height && snapshot[(size_t)(y + 1) * t.width + sx] == TILE_EMPTY) return k;
+        }
+        return 0;
+    }
+
+    // Lava next to water cools to ground and the water boils away
+    bool quench(int x, int y, TileRect& ch) {
+        static const int DX[4] = { 0, 1, 0, -1 }, DY[4] = { -1, 0, 1, 0 };
+        for (int n = 0; n < 4; ++n) {
+            if ((get(x + DX[n], y + DY[n]) & (uint8_t)~CELL_MOVED) != TILE_WATER) continue;
+            put(x + DX[n], y + DY[n], TILE_EMPTY, ch);
+            put(x, y, (uint8_t)(TILE_GROUND | CELL_MOVED), ch);
+            return true;
+        }
+        return false;
+    }
+
+    // Any tile of `id` under the player's box (lava kills)
+    bool touching(const Player& player, uint8_t id) const {
+        int x0 = player.position.x.tile(TILE_SIZE), x1 = player.position.x.tile(TILE_SIZE, PLAYER_W - 1);
+        int y0 = player.position.y.tile(TILE_SIZE), y1 = player.position.y.tile(TILE_SIZE, PLAYER_H - 1);
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                if (get(x, y) == id) return true;
+            }
+        }
+        return false;
+    }
+};
@@ -1,10 +1,13 @@
 #include <SDL2/SDL.h>
+#include <algorithm>
 #include <vector>
 #include <cmath>
+#include "tick_rate.h"
+#include "collision_query.h"
 
 const int SCREEN_W = 480;
 const int SCREEN_H = 270;
-const float DT = 1.0f / 60.0f;
+const uint32_t SENSOR_BIT = 1u << 5; // SENSOR_LAYER (Section 13)
 
 struct Player {
     float x, y;
@@ -13,6 +16,7 @@ struct Player {
 };
 
 int main(int argc, char** argv) {
+    const float DT = parseTickRate(argc, argv).dt;
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS) != 0) {
         return 1;
     }
@@ -34,6 +38,11 @@ int main(int argc, char** argv) {
     coins.push_back({400, SCREEN_H - 60, 16, 16});
     int coinCount = 0;
 
+    // Pickups are resolved through the batched query API
+    CollisionWorld world;
+    ColliderSet pickups;
+    std::vector<OverlapPair> touched;
+
     Uint32 lastTick = SDL_GetTicks();
     float accumulator = 0.0f;
     bool running = true;
@@ -65,7 +74,7 @@ int main(int argc, char** argv) {
 
             // friction
             if (ax == 0.0f && player.onGround) {
-                player.vx *= 0.8f;
+                player.vx *= decayFactor(GROUND_FRICTION_RATE, DT);
                 if (std::fabs(player.vx) < 5.0f) player.vx = 0.0f;
             }
 
@@ -100,14 +109,20 @@ int main(int argc, char** argv) {
             }
 
             // coin collision
-            for (auto it = coins.begin(); it != coins.end(); ) {
-                SDL_Rect pRect = { (int)player.x, (int)player.y, 20, 20 };
-                if (SDL_HasIntersection(&pRect, &*it)) {
-                    coinCount++;
-                    it = coins.erase(it);
-                } else {
-                    ++it;
-                }
+            pickups.clear();
+            for (size_t i = 0; i < coins.size(); ++i) {
+                const SDL_Rect& c = coins[i];
+                pickups.add({ (float)c.x, (float)c.y, (float)(c.x + c.w), (float)(c.y + c.h) }, SENSOR_BIT, (uint32_t)i);
+            }
+            world.setColliders(pickups);
+            OverlapQuery body = { { player.x, player.y, player.x + 20.0f, player.y + 20.0f }, SENSOR_BIT };
+            world.overlap(&body, 1, touched, nullptr);
+            // erase from the back so earlier indices stay valid
+            std::sort(touched.begin(), touched.end(),
+                      [](const OverlapPair& a, const OverlapPair& b) { return a.id > b.id; });
+            for (const OverlapPair& hit : touched) {
+                coinCount++;
+                coins.erase(coins.begin() + hit.id);
             }
         }
 
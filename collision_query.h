@@ -0,0 +1,337 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+#include "aabb_simd.h"
+#include "solidity.h"
+
+//----------------------------------------------------------------------------
+// Batched Collision Queries (Section 13 – Collision)
+//----------------------------------------------------------------------------
+// Gameplay asks spatial questions in batches: arrays of overlap boxes, ray
+// segments or swept boxes go in, result arrays come out.  Each query carries
+// a mask with one bit per CollisionLayer; bit 0 (TILE_LAYER) includes the
+// tile solidity bitmap, the other bits select dynamic colliders by layer.
+//
+// Dynamic colliders are copied into SoA arrays sorted by minX when the set
+// is installed.  Queries are processed in order of their own minX, so a
+// batch sweeps across the collider list left to right: each query
+// binary-searches a contiguous candidate range and tests it with the SIMD
+// overlap kernel (aabb_simd.h) in one call.  Tile tests walk rows of the solidity bitmap (overlap,
+// sweep) or step tile by tile with a DDA (ray).
+//
+// Results never depend on batch order: ray and sweep hits are written at the
+// query's own index, and overlap pairs are returned grouped by query index,
+// in ascending minX order of the colliders inside each group.
+//
+// Conventions: boxes are half-open, so touching is not overlapping.  Rays
+// and sweeps cover t in [0, 1] along (dx, dy); a sweep that starts out
+// overlapping reports t = 0 with a zero normal.
+//
+
+constexpr uint32_t QUERY_TILES = 1u << 0;   // TILE_LAYER bit
+
+struct ColliderSet {
+    std::vector<float> minX, minY, maxX, maxY;
+    std::vector<uint32_t> layers;   // CollisionLayer bits of each collider
+    std::vector<uint32_t> ids;      // caller's handle, reported in results
+
+    void clear() {
+        minX.clear(); minY.clear(); maxX.clear(); maxY.clear();
+        layers.clear(); ids.clear();
+    }
+    void add(const Aabb& b, uint32_t layerBits, uint32_t id) {
+        minX.push_back(b.minX); minY.push_back(b.minY);
+        maxX.push_back(b.maxX); maxY.push_back(b.maxY);
+        layers.push_back(layerBits);
+        ids.push_back(id);
+    }
+    size_t size() const { return ids.size(); }
+    AabbSpan boxes() const { return { minX.data(), minY.data(), maxX.data(), maxY.data(), size() }; }
+};
+
+struct OverlapQuery {
+    Aabb box;
+    uint32_t mask;
+};
+
+// Segment from (x, y) to (x + dx, y + dy)
+struct RayQuery {
+    float x, y, dx, dy;
+    uint32_t mask;
+};
+
+// Box moved by (dx, dy)
+struct SweepQuery {
+    Aabb box;
+    float dx, dy;
+    uint32_t mask;
+};
+
+struct OverlapPair {
+    uint32_t query;
+    uint32_t id;
+};
+
+struct QueryHit {
+    bool hit;
+    float t;               // fraction of the segment / sweep
+    float nx, ny;          // surface normal at the hit
+    int32_t id;            // collider id, or -1 for a tile
+    int32_t tileX, tileY;  // tile coordinates when id == -1
+};
+
+namespace collision_detail {
+
+constexpr float INF = std::numeric_limits<float>::infinity();
+
+// Ray-vs-box slab test for a point moving by (dx, dy), t in [0, 1].
+// A zero-length axis counts as inside only strictly between the faces.
+inline bool slab(float px, float py, float dx, float dy,
+                 float minX, float minY, float maxX, float maxY,
+                 float& tHit, float& nx, float& ny) {
+    float txMin, txMax, tyMin, tyMax;
+    if (dx != 0.0f) {
+        float inv = 1.0f / dx;
+        float a = (minX - px) * inv, b = (maxX - px) * inv;
+        txMin = std::min(a, b); txMax = std::max(a, b);
+    } else {
+        if (!(px > minX && px < maxX)) return false;
+        txMin = -INF; txMax = INF;
+    }
+    if (dy != 0.0f) {
+        float inv = 1.0f / dy;
+        float a = (minY - py) * inv, b = (maxY - py) * inv;
+        tyMin = std::min(a, b); tyMax = std::max(a, b);
+    } else {
+        if (!(py > minY && py < maxY)) return false;
+        tyMin = -INF; tyMax = INF;
+    }
+    float tEnter = std::max(txMin, tyMin);
+    float tExit  = std::min(txMax, tyMax);
+    if (!(tEnter < tExit) || tExit <= 0.0f || tEnter > 1.0f) return false;
+    if (tEnter < 0.0f) {
+        tHit = 0.0f; nx = 0.0f; ny = 0.0f;   // started inside
+    } else if (txMin > tyMin) {
+        tHit = tEnter; nx = dx > 0.0f ? -1.0f : 1.0f; ny = 0.0f;
+    } else {
+        tHit = tEnter; nx = 0.0f; ny = dy > 0.0f ? -1.0f : 1.0f;
+    }
+    return true;
+}
+
+inline int floorDiv(float v, int size) {
+    return (int)std::floor(v / size);
+}
+
+} // namespace collision_detail
+
+struct CollisionWorld {
+    const SolidityBitmap* tiles{ nullptr };
+    int tileSize{ 16 };
+
+    // Colliders sorted by minX
+    ColliderSet sorted;
+    size_t count{ 0 };
+    float maxWidth{ 0.0f };
+    float maxHeight{ 0.0f };
+
+    // Scratch reused between batches
+    std::vector<uint32_t> order;
+    std::vector<float> keys;
+    std::vector<uint64_t> hitBits;
+
+    void setTiles(const SolidityBitmap* bitmap, int size) {
+        tiles = bitmap;
+        tileSize = size;
+    }
+
+    void setColliders(const ColliderSet& set) {
+        count = set.size();
+        order.resize(count);
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(), order.end(),
+                         [&](uint32_t a, uint32_t b) { return set.minX[a] < set.minX[b]; });
+        sorted.clear();
+        maxWidth = maxHeight = 0.0f;
+        for (uint32_t i : order) {
+            sorted.add({ set.minX[i], set.minY[i], set.maxX[i], set.maxY[i] }, set.layers[i], set.ids[i]);
+            maxWidth  = std::max(maxWidth,  set.maxX[i] - set.minX[i]);
+            maxHeight = std::max(maxHeight, set.maxY[i] - set.minY[i]);
+        }
+    }
+
+    //------------------------------------------------------------------------
+    // Overlap: every collider each box touches, plus whether it touches a
+    // solid tile.  `tileHits` may be null when no query asks for tiles.
+    void overlap(const OverlapQuery* queries, size_t n,
+                 std::vector<OverlapPair>& pairs, uint8_t* tileHits) {
+        pairs.clear();
+        sortQueries(n, [&](size_t q) { return queries[q].box.minX; });
+        for (uint32_t q : order) {
+            const OverlapQuery& query = queries[q];
+            if (tileHits) tileHits[q] = (query.mask & QUERY_TILES) && overlapsTiles(query.box);
+            if (!(query.mask & ~QUERY_TILES)) continue;
+            size_t begin, end;
+            candidateRange(query.box.minX, query.box.maxX, begin, end);
+            if (!overlapRange(begin, end, query.box, query.mask)) continue;
+            forEachHit(hitBits.data(), end - begin, [&](size_t k) { pairs.push_back({ q, sorted.ids[begin + k] }); });
+        }
+        // Batch order is an implementation detail: group results by query
+        std::stable_sort(pairs.begin(), pairs.end(),
+                         [](const OverlapPair& a, const OverlapPair& b) { return a.query < b.query; });
+    }
+
+    //------------------------------------------------------------------------
+    // Ray: nearest hit along each segment.
+    void raycast(const RayQuery* queries, size_t n, QueryHit* out) {
+        sortQueries(n, [&](size_t q) { return std::min(queries[q].x, queries[q].x + queries[q].dx); });
+        for (uint32_t q : order) {
+            const RayQuery& r = queries[q];
+            QueryHit best{ false, 2.0f, 0.0f, 0.0f, -1, 0, 0 };
+            if (r.mask & QUERY_TILES) rayTiles(r, best);
+            if (r.mask & ~QUERY_TILES) {
+                Aabb bounds{ std::min(r.x, r.x + r.dx), std::min(r.y, r.y + r.dy),
+                             std::max(r.x, r.x + r.dx), std::max(r.y, r.y + r.dy) };
+                castColliders(r.x, r.y, r.dx, r.dy, 0.0f, 0.0f, bounds, r.mask, best);
+            }
+            out[q] = best;
+        }
+    }
+
+    //------------------------------------------------------------------------
+    // Shape-cast: earliest time each moving box touches something.
+    void sweep(const SweepQuery* queries, size_t n, QueryHit* out) {
+        sortQueries(n, [&](size_t q) { return std::min(queries[q].box.minX, queries[q].box.minX + queries[q].dx); });
+        for (uint32_t q : order) {
+            const SweepQuery& s = queries[q];
+            float hx = (s.box.maxX - s.box.minX) * 0.5f;
+            float hy = (s.box.maxY - s.box.minY) * 0.5f;
+            float cx = s.box.minX + hx;
+            float cy = s.box.minY + hy;
+            Aabb bounds{ std::min(s.box.minX, s.box.minX + s.dx), std::min(s.box.minY, s.box.minY + s.dy),
+                         std::max(s.box.maxX, s.box.maxX + s.dx), std::max(s.box.maxY, s.box.maxY + s.dy) };
+            QueryHit best{ false, 2.0f, 0.0f, 0.0f, -1, 0, 0 };
+            if (s.mask & QUERY_TILES) sweepTiles(cx, cy, hx, hy, s.dx, s.dy, bounds, best);
+            if (s.mask & ~QUERY_TILES) castColliders(cx, cy, s.dx, s.dy, hx, hy, bounds, s.mask, best);
+            out[q] = best;
+        }
+    }
+
+private:
+    template <class KeyFn>
+    void sortQueries(size_t n, KeyFn key) {
+        order.resize(n);
+        keys.resize(n);
+        for (size_t q = 0; q < n; ++q) {
+            order[q] = (uint32_t)q;
+            keys[q] = key(q);
+        }
+        std::stable_sort(order.begin(), order.end(),
+                         [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+    }
+
+    // Colliders whose x-extent can touch [lo, hi].
+    void candidateRange(float lo, float hi, size_t& begin, size_t& end) const {
+        const float* xs = sorted.minX.data();
+        begin = (size_t)(std::lower_bound(xs, xs + count, lo - maxWidth) - xs);
+        end   = (size_t)(std::upper_bound(xs, xs + count, hi) - xs);
+        if (end < begin) end = begin;
+    }
+
+    // Bit k of hitBits set if collider begin+k overlaps `b` and shares a
+    // layer with `mask`; returns the number of hits.
+    size_t overlapRange(size_t begin, size_t end, const Aabb& b, uint32_t mask) {
+        hitBits.resize(aabbMaskWords(end - begin));
+        return aabbOverlapMask(b, sorted.boxes().sub(begin, end), hitBits.data(), sorted.layers.data() + begin,
+                               mask & ~QUERY_TILES);
+    }
+
+    bool overlapsTiles(const Aabb& b) const {
+        if (!tiles || !(b.maxX > b.minX) || !(b.maxY > b.minY)) return false;
+        int x0 = collision_detail::floorDiv(b.minX, tileSize);
+        int x1 = (int)std::ceil(b.maxX / tileSize) - 1;
+        int y0 = collision_detail::floorDiv(b.minY, tileSize);
+        int y1 = (int)std::ceil(b.maxY / tileSize) - 1;
+        for (int y = y0; y <= y1; ++y) {
+            if (tiles->anySolid(x0, x1, y)) return true;
+        }
+        return false;
+    }
+
+    // Point (px, py) moving by (dx, dy) against colliders grown by (hx, hy).
+    void castColliders(float px, float py, float dx, float dy, float hx, float hy,
+                       const Aabb& bounds, uint32_t mask, QueryHit& best) {
+        size_t begin, end;
+        candidateRange(bounds.minX, bounds.maxX, begin, end);
+        // SIMD reject against the swept bounds before the per-box slab test
+        if (!overlapRange(begin, end, bounds, mask)) return;
+        forEachHit(hitBits.data(), end - begin, [&](size_t k) {
+            size_t j = begin + k;
+            float t, nx, ny;
+            if (collision_detail::slab(px, py, dx, dy,
+                                       sorted.minX[j] - hx, sorted.minY[j] - hy,
+                                       sorted.maxX[j] + hx, sorted.maxY[j] + hy, t, nx, ny) &&
+                t < best.t) {
+                best = { true, t, nx, ny, (int32_t)sorted.ids[j], 0, 0 };
+            }
+        });
+    }
+
+    // Amanatides–Woo grid walk along the ray; the first solid tile wins.
+    void rayTiles(const RayQuery& r, QueryHit& best) const {
+        if (!tiles) return;
+        int tx = collision_detail::floorDiv(r.x, tileSize);
+        int ty = collision_detail::floorDiv(r.y, tileSize);
+        if (tiles->solid(tx, ty)) {
+            best = { true, 0.0f, 0.0f, 0.0f, -1, tx, ty };
+            return;
+        }
+        using collision_detail::INF;
+        int stepX = r.dx > 0.0f ? 1 : (r.dx < 0.0f ? -1 : 0);
+        int stepY = r.dy > 0.0f ? 1 : (r.dy < 0.0f ? -1 : 0);
+        float tMaxX = stepX ? ((tx + (stepX > 0)) * (float)tileSize - r.x) / r.dx : INF;
+        float tMaxY = stepY ? ((ty + (stepY > 0)) * (float)tileSize - r.y) / r.dy : INF;
+        float tDeltaX = stepX ? tileSize / std::fabs(r.dx) : INF;
+        float tDeltaY = stepY ? tileSize / std::fabs(r.dy) : INF;
+        for (;;) {
+            float t;
+            float nx = 0.0f, ny = 0.0f;
+            if (tMaxX < tMaxY) {
+                t = tMaxX; tx += stepX; tMaxX += tDeltaX; nx = (float)-stepX;
+            } else {
+                t = tMaxY; ty += stepY; tMaxY += tDeltaY; ny = (float)-stepY;
+            }
+            if (t > 1.0f || t >= best.t) return;
+            if (tiles->solid(tx, ty)) {
+                best = { true, t, nx, ny, -1, tx, ty };
+                return;
+            }
+        }
+    }
+
+    // Every solid tile under the swept bounds, skipping empty rows by word.
+    void sweepTiles(float cx, float cy, float hx, float hy, float dx, float dy,
+                    const Aabb& bounds, QueryHit& best) const {
+        if (!tiles) return;
+        int x0 = collision_detail::floorDiv(bounds.minX, tileSize);
+        int x1 = (int)std::ceil(bounds.maxX / tileSize) - 1;
+        int y0 = collision_detail::floorDiv(bounds.minY, tileSize);
+        int y1 = (int)std::ceil(bounds.maxY / tileSize) - 1;
+        for (int y = y0; y <= y1; ++y) {
+            if (!tiles->anySolid(x0, x1, y)) continue;
+            for (int x = x0; x <= x1; ++x) {
+                if (!tiles->solid(x, y)) continue;
+                float t, nx, ny;
+                float minX = x * (float)tileSize - hx, minY = y * (float)tileSize - hy;
+                float maxX = (x + 1) * (float)tileSize + hx, maxY = (y + 1) * (float)tileSize + hy;
+                if (collision_detail::slab(cx, cy, dx, dy, minX, minY, maxX, maxY, t, nx, ny) && t < best.t) {
+                    best = { true, t, nx, ny, -1, x, y };
+                }
+            }
+        }
+    }
+};
@@ -0,0 +1,199 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "spatial_grid.h"
+#include "job_system.h"
+
+//----------------------------------------------------------------------------
+// Parallel Contact Resolution (Section 13 – Collision)
+//----------------------------------------------------------------------------
+// Overlapping dynamic boxes are pushed apart along their axis of least
+// penetration, split by inverse mass, for a few Gauss-Seidel iterations.
+//
+// To run that in parallel without races, the contact list is partitioned
+// with greedy graph colouring: walking contacts in order, each takes the
+// lowest colour not already used by either of its bodies.  Contacts of one
+// colour touch disjoint bodies, so a colour is one batch that can be
+// solved by any number of threads.  Batches run in colour order and each
+// contact only reads and writes its own two bodies, so the result is
+// bit-identical to solving the same batches on one thread, whatever the
+// thread count or scheduling.
+//
+// Static bodies (inverse mass 0) are never written and do not constrain
+// colouring, so a crowd leaning on one wall still fits in a few colours.
+// Contacts that find no free colour among MAX_COLORS go to an overflow
+// batch that is solved serially after the coloured ones.
+//
+
+struct ContactBodies {
+    std::vector<float> x, y;           // centres
+    std::vector<float> halfW, halfH;
+    std::vector<float> invMass;        // 0 = static / kinematic
+
+    size_t size() const { return x.size(); }
+
+    void clear() {
+        x.clear(); y.clear(); halfW.clear(); halfH.clear(); invMass.clear();
+    }
+
+    uint32_t add(float cx, float cy, float hw, float hh, float inverseMass) {
+        x.push_back(cx); y.push_back(cy);
+        halfW.push_back(hw); halfH.push_back(hh);
+        invMass.push_back(inverseMass);
+        return (uint32_t)x.size() - 1;
+    }
+};
+
+struct ContactPair {
+    uint32_t a, b;
+};
+
+struct ContactSolver {
+    static constexpr int MAX_COLORS = 64;
+
+    int iterations{ 4 };
+    size_t grain{ 64 };                    // contacts per job chunk
+    std::vector<ContactPair> batched;      // contacts grouped by colour, overflow last
+    std::vector<uint32_t> batchStart;      // colours + overflow + 1 offsets into `batched`
+    std::vector<uint64_t> usedColors;      // per body
+    std::vector<uint8_t> colorOf;          // per input contact
+    std::vector<uint32_t> cursor;          // per colour, counting sort scratch
+    bool overflow{ false };                // last batch is the serial overflow batch
+    SpatialGrid grid;
+    std::vector<uint32_t> oversized;       // bodies too big for the grid cells
+
+    size_t batchCount() const { return batchStart.empty() ? 0 : batchStart.size() - 1; }
+
+    // Broadphase: all overlapping pairs with at least one dynamic body, a < b,
+    // in a deterministic order.  The grid is sized for dynamic bodies; larger
+    // ones (floors, walls) are tested against everything directly.
+    void findContacts(const ContactBodies& bodies, std::vector<ContactPair>& out) {
+        out.clear();
+        const size_t n = bodies.size();
+        if (n < 2) return;
+        float extent = 0.0f;
+        for (size_t i = 0; i < n; ++i) {
+            if (bodies.invMass[i] != 0.0f) extent = std::max(extent, std::max(bodies.halfW[i], bodies.halfH[i]));
+        }
+        const float cell = std::max(2.0f * extent, 1.0f);
+        grid.setCellSize(cell);
+        grid.build(bodies.x.data(), bodies.y.data(), n);
+        oversized.clear();
+        for (size_t i = 0; i < n; ++i) {
+            if (2.0f * std::max(bodies.halfW[i], bodies.halfH[i]) > cell) oversized.push_back((uint32_t)i);
+        }
+        auto test = [&](uint32_t i, uint32_t j) {
+            if (bodies.invMass[i] == 0.0f && bodies.invMass[j] == 0.0f) return;
+            if (std::abs(bodies.x[i] - bodies.x[j]) < bodies.halfW[i] + bodies.halfW[j] &&
+                std::abs(bodies.y[i] - bodies.y[j]) < bodies.halfH[i] + bodies.halfH[j]) {
+                out.push_back({ std::min(i, j), std::max(i, j) });
+            }
+        };
+        auto isOversized = [&](uint32_t i) {
+            return std::binary_search(oversized.begin(), oversized.end(), i);
+        };
+        for (uint32_t i = 0; i < (uint32_t)n; ++i) {
+            if (isOversized(i)) continue;
+            int cx = grid.cellCoord(bodies.x[i]), cy = grid.cellCoord(bodies.y[i]);
+            uint32_t seen[9];
+            int seenCount = 0;
+            for (int oy = -1; oy <= 1; ++oy) {
+                for (int ox = -1; ox <= 1; ++ox) {
+                    // Neighbouring cells can hash to the same bucket; visit each once
+                    uint32_t b = grid.bucket(cx + ox, cy + oy);
+                    if (std::find(seen, seen + seenCount, b) != seen + seenCount) continue;
+                    seen[seenCount++] = b;
+                    for (const uint32_t* it = grid.bucketBegin(cx + ox, cy + oy); it != grid.bucketEnd(cx + ox, cy + oy); ++it) {
+                        if (*it > i && !isOversized(*it)) test(i, *it);
+                    }
+                }
+            }
+        }
+        for (size_t k = 0; k < oversized.size(); ++k) {
+            uint32_t i = oversized[k];
+            for (uint32_t j = 0; j < (uint32_t)n; ++j) {
+                if (j != i && (!isOversized(j) || j > i)) test(i, j);
+            }
+        }
+        // Bucket order depends on the hash; sort so the contact order only
+        // depends on the bodies
+        std::sort(out.begin(), out.end(), [](const ContactPair& p, const ContactPair& q) {
+            return p.a != q.a ? p.a < q.a : p.b < q.b;
+        });
+    }
+
+    // Greedy colouring, then a stable counting sort of contacts by colour.
+    void color(const ContactBodies& bodies, const ContactPair* pairs, size_t count) {
+        usedColors.assign(bodies.size(), 0);
+        colorOf.resize(count);
+        batchStart.assign(MAX_COLORS + 2, 0);
+        int colorsUsed = 0;
+        for (size_t c = 0; c < count; ++c) {
+            const ContactPair& p = pairs[c];
+            bool dynA = bodies.invMass[p.a] != 0.0f, dynB = bodies.invMass[p.b] != 0.0f;
+            uint64_t taken = (dynA ? usedColors[p.a] : 0) | (dynB ? usedColors[p.b] : 0);
+            int k = MAX_COLORS;                       // overflow
+            if (~taken) {
+                k = 0;
+                while (taken & (1ull << k)) ++k;
+                if (dynA) usedColors[p.a] |= 1ull << k;
+                if (dynB) usedColors[p.b] |= 1ull << k;
+                colorsUsed = std::max(colorsUsed, k + 1);
+            }
+            colorOf[c] = (uint8_t)k;
+            ++batchStart[k + 1];
+        }
+        for (int k = 0; k <= MAX_COLORS; ++k) batchStart[k + 1] += batchStart[k];
+        batched.resize(count);
+        cursor.assign(batchStart.begin(), batchStart.end() - 1);
+        for (size_t c = 0; c < count; ++c) batched[cursor[colorOf[c]]++] = pairs[c];
+        // Drop the empty colours between the last used one and the overflow
+        overflow = batchStart[MAX_COLORS] < count;
+        batchStart.erase(batchStart.begin() + colorsUsed + 1, batchStart.end() - (overflow ? 1 : 0));
+    }
+
+    static void resolve(ContactBodies& bodies, const ContactPair& p) {
+        const uint32_t a = p.a, b = p.b;
+        float wa = bodies.invMass[a], wb = bodies.invMass[b];
+        float wsum = wa + wb;
+        if (wsum == 0.0f) return;
+        float dx = bodies.x[b] - bodies.x[a];
+        float dy = bodies.y[b] - bodies.y[a];
+        float px = bodies.halfW[a] + bodies.halfW[b] - std::abs(dx);
+        float py = bodies.halfH[a] + bodies.halfH[b] - std::abs(dy);
+        if (px <= 0.0f || py <= 0.0f) return;
+        // Push along the axis of least penetration; exact ties break towards +.
+        // Static bodies are shared across a batch, so they must not be written.
+        std::vector<float>& axis = px < py ? bodies.x : bodies.y;
+        float s = px < py ? (dx < 0.0f ? -px : px) : (dy < 0.0f ? -py : py);
+        if (wa != 0.0f) axis[a] -= s * (wa / wsum);
+        if (wb != 0.0f) axis[b] += s * (wb / wsum);
+    }
+
+    // Solve the coloured batches; jobs == nullptr runs on the calling thread.
+    void solve(ContactBodies& bodies, JobSystem* jobs) {
+        const size_t batches = batchCount();
+        for (int it = 0; it < iterations; ++it) {
+            for (size_t k = 0; k < batches; ++k) {
+                const ContactPair* first = batched.data() + batchStart[k];
+                const size_t n = batchStart[k + 1] - batchStart[k];
+                if (!jobs || (overflow && k + 1 == batches)) {
+                    for (size_t c = 0; c < n; ++c) resolve(bodies, first[c]);
+                } else {
+                    jobs->parallelFor(n, grain, [&](size_t begin, size_t end, unsigned) {
+                        for (size_t c = begin; c < end; ++c) resolve(bodies, first[c]);
+                    });
+                }
+            }
+        }
+    }
+
+    // Broadphase, colouring and solve in one call.
+    void step(ContactBodies& bodies, JobSystem* jobs, std::vector<ContactPair>& scratch) {
+        findContacts(bodies, scratch);
+        color(bodies, scratch.data(), scratch.size());
+        solve(bodies, jobs);
+    }
+};
@@ -0,0 +1,93 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include "physics.h"
+#include "sim.h"
+#include "solidity.h"
+
+//----------------------------------------------------------------------------
+// Level Crates (Section 14 – Dynamic Bodies)
+//----------------------------------------------------------------------------
+// Binds the level's crates (LEVEL_CRATES) and the player to a PhysicsWorld.
+// Every tick, after Player::update, the player is mirrored into the world as
+// a kinematic box with its own velocity, so crates it walks into are pushed
+// along and crates on top ride with it.  After the physics step the player
+// is pushed back out of any crate it still overlaps: a crate stuck against a
+// wall stops the player, and one below it is stood on like a tile.
+//
+// Bodies are relative to `origin` (sim.h), which follows the player, so
+// crates keep their precision anywhere in a long level.  SDL-free and
+// deterministic, so main.cpp and replay_analytics.cpp step the same world
+// and recorded replays resimulate exactly.
+//
+
+// Largest impulse the player applies to one crate per tick.  Above the
+// floor friction of a crate (mass 1) but below that of a boulder (mass 4),
+// so crates slide and boulders do not.
+constexpr float PLAYER_PUSH_IMPULSE = 60.0f;
+
+struct CrateWorld {
+    PhysicsWorld physics;
+    SimOrigin origin;
+    uint32_t playerBody{ 0 };
+
+    void reset(const SolidityBitmap& solidity) {
+        physics.bodies.clear();
+        physics.setTiles(solidity, (float)TILE_SIZE);
+        origin = SimOrigin{};
+        physics.setTileOrigin(origin.tileX(), origin.tileY());
+        for (const CrateSpawn& c : LEVEL_CRATES) {
+            float hw = c.w * 0.5f, hh = c.h * 0.5f;
+            physics.bodies.add((c.tileX - origin.tileX()) * TILE_SIZE + hw, (c.tileY + 1 - origin.tileY()) * TILE_SIZE - hh,
+                               hw, hh, c.mass, 0.6f, false);
+        }
+        playerBody = physics.bodies.add(0.0f, 0.0f, PLAYER_W * 0.5f, PLAYER_H * 0.5f, 0.0f, 0.6f, true);
+        physics.bodies.pushLimit[playerBody] = PLAYER_PUSH_IMPULSE;
+    }
+
+    // Terrain changed under [x0, x1] × [y0, y1] (tiles): crates resting
+    // there (or right above) must fall again.
+    void terrainChanged(int x0, int y0, int x1, int y1) {
+        x0 -= origin.tileX(); x1 -= origin.tileX();
+        y0 -= origin.tileY(); y1 -= origin.tileY();
+        physics.wakeArea((float)(x0 * TILE_SIZE), (float)((y0 - 1) * TILE_SIZE),
+                         (float)((x1 + 1) * TILE_SIZE), (float)((y1 + 1) * TILE_SIZE));
+    }
+
+    size_t crateCount() const { return physics.bodies.size() - 1; }
+
+    void step(Player& player, float dt) {
+        float shiftX, shiftY;
+        if (origin.follow(player.position, shiftX, shiftY)) {
+            physics.shift(shiftX, shiftY);
+            physics.setTileOrigin(origin.tileX(), origin.tileY());
+        }
+        PhysicsBodies& b = physics.bodies;
+        float cx = origin.localX(player.position.x) + PLAYER_W * 0.5f;
+        float cy = origin.localY(player.position.y) + PLAYER_H * 0.5f;
+        b.x[playerBody] = cx;
+        b.y[playerBody] = cy;
+        b.vx[playerBody] = player.velocity.x;
+        // Only upward motion is imposed: falling onto a crate is handled by
+        // separation below rather than by driving the crate into the floor
+        b.vy[playerBody] = std::min(player.velocity.y, 0.0f);
+        physics.step(dt);
+
+        float pushX, pushY;
+        float sx = cx, sy = cy;
+        physics.separate(sx, sy, PLAYER_W * 0.5f, PLAYER_H * 0.5f, pushX, pushY);
+        if (sx == cx && sy == cy) return;
+        player.position.x.local += sx - cx;
+        player.position.y.local += sy - cy;
+        player.position.normalize();
+        if (pushX * player.velocity.x < 0.0f) player.velocity.x = 0.0f;
+        if (pushY > 0.0f && player.velocity.y < 0.0f) player.velocity.y = 0.0f;   // head bump
+        if (pushY < 0.0f && player.velocity.y > 0.0f) {
+            player.velocity.y = 0.0f;
+            player.onGround = true;
+            player.coyoteTimer = 0.1f;
+            player.state = std::abs(player.velocity.x) > 1.0f ? PlayerState::Run : PlayerState::Idle;
+        }
+    }
+};
@@ -0,0 +1,146 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "spatial_grid.h"
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CROWD_HAS_SSE2 1
+#endif
+
+//----------------------------------------------------------------------------
+// Crowd Separation Steering (Section 11 – Enemy Groups)
+//----------------------------------------------------------------------------
+// Keeps dense groups of enemies from collapsing into one blob.  Each tick the
+// spatial grid is rebuilt and every entity gathers at most
+// CROWD_MAX_NEIGHBOURS neighbours inside `radius`, examining no more than
+// CROWD_MAX_CANDIDATES grid entries.  Both caps are fixed, so the pass stays
+// linear in entity count however tightly the crowd is packed.
+//
+// The push is a linear falloff (1 - d / radius) along the separating
+// direction, summed over the neighbour list four lanes at a time.  Only IEEE
+// sqrt and divide are used (no rsqrt approximations), so the result is the
+// same on every x86 CPU and on the scalar fallback.  Exactly coincident
+// entities are split by index so they never stay stacked.
+//
+
+constexpr int CROWD_MAX_NEIGHBOURS  = 8;
+constexpr int CROWD_MAX_CANDIDATES  = 32;
+
+struct CrowdSeparation {
+    float radius{ 18.0f };
+    SpatialGrid grid;
+    // Per-entity neighbour offsets (self - neighbour), padded to the cap with
+    // zeros and a zero weight mask.
+    std::vector<float> offX;
+    std::vector<float> offY;
+    std::vector<float> valid;
+
+    // Writes the separation direction scaled by overlap into pushX/pushY
+    // (unitless, roughly 0..CROWD_MAX_NEIGHBOURS).  Callers scale by a speed.
+    void compute(const float* xs, const float* ys, size_t count, float* pushX, float* pushY) {
+        grid.setCellSize(radius);
+        grid.build(xs, ys, count);
+        offX.resize(count * CROWD_MAX_NEIGHBOURS);
+        offY.resize(count * CROWD_MAX_NEIGHBOURS);
+        valid.resize(count * CROWD_MAX_NEIGHBOURS);
+        const float r2 = radius * radius;
+        for (size_t i = 0; i < count; ++i) {
+            float* ox = &offX[i * CROWD_MAX_NEIGHBOURS];
+            float* oy = &offY[i * CROWD_MAX_NEIGHBOURS];
+            float* ok = &valid[i * CROWD_MAX_NEIGHBOURS];
+            int found = 0;
+            int examined = 0;
+            int cx = grid.cellCoord(xs[i]);
+            int cy = grid.cellCoord(ys[i]);
+            const uint32_t own = grid.bucket(cx, cy);
+            uint32_t seen[9];
+            int seenCount = 0;
+            for (int dy = -1; dy <= 1 && found < CROWD_MAX_NEIGHBOURS && examined < CROWD_MAX_CANDIDATES; ++dy) {
+                for (int dx = -1; dx <= 1 && found < CROWD_MAX_NEIGHBOURS && examined < CROWD_MAX_CANDIDATES; ++dx) {
+                    // Neighbouring cells can hash to the same bucket; visit each
+                    // once or its entities would be counted twice
+                    const uint32_t bucket = grid.bucket(cx + dx, cy + dy);
+                    if (std::find(seen, seen + seenCount, bucket) != seen + seenCount) continue;
+                    seen[seenCount++] = bucket;
+                    const uint32_t* b = grid.bucketBegin(cx + dx, cy + dy);
+                    const uint32_t* e = grid.bucketEnd(cx + dx, cy + dy);
+                    size_t n = (size_t)(e - b);
+                    // Start just after our own slot in our own bucket so that
+                    // a packed crowd does not all pick the same first few.
+                    size_t start = 0;
+                    if (bucket == own && n > 0) {
+                        start = grid.slotOf[i] - (size_t)(b - grid.entries.data());
+                    }
+                    for (size_t k = 0; k < n && found < CROWD_MAX_NEIGHBOURS && examined < CROWD_MAX_CANDIDATES; ++k) {
+                        uint32_t j = b[(start + k) % n];
+                        if (j == i) continue;
+                        ++examined;
+                        float ddx = xs[i] - xs[j];
+                        float ddy = ys[i] - ys[j];
+                        if (ddx * ddx + ddy * ddy >= r2) continue;
+                        if (ddx == 0.0f && ddy == 0.0f) ddx = (i < j) ? -0.01f : 0.01f;
+                        ox[found] = ddx;
+                        oy[found] = ddy;
+                        ok[found] = 1.0f;
+                        ++found;
+                    }
+                }
+            }
+            for (int k = found; k < CROWD_MAX_NEIGHBOURS; ++k) {
+                ox[k] = 1.0f;   // any non-zero offset keeps the divide finite
+                oy[k] = 0.0f;
+                ok[k] = 0.0f;
+            }
+        }
+        accumulate(count, pushX, pushY);
+    }
+
+private:
+    void accumulate(size_t count, float* pushX, float* pushY) const {
+        const float invR = 1.0f / radius;
+#ifdef CROWD_HAS_SSE2
+        static_assert(CROWD_MAX_NEIGHBOURS % 4 == 0, "neighbour cap must be a multiple of the SIMD width");
+        const __m128 vInvR = _mm_set1_ps(invR);
+        const __m128 one   = _mm_set1_ps(1.0f);
+        const __m128 zero  = _mm_setzero_ps();
+        for (size_t i = 0; i < count; ++i) {
+            __m128 sumX = zero;
+            __m128 sumY = zero;
+            for (int k = 0; k < CROWD_MAX_NEIGHBOURS; k += 4) {
+                size_t o = i * CROWD_MAX_NEIGHBOURS + k;
+                __m128 dx = _mm_loadu_ps(&offX[o]);
+                __m128 dy = _mm_loadu_ps(&offY[o]);
+                __m128 ok = _mm_loadu_ps(&valid[o]);
+                __m128 d  = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+                __m128 w  = _mm_max_ps(zero, _mm_sub_ps(one, _mm_mul_ps(d, vInvR)));
+                w = _mm_div_ps(_mm_mul_ps(w, ok), d);
+                sumX = _mm_add_ps(sumX, _mm_mul_ps(dx, w));
+                sumY = _mm_add_ps(sumY, _mm_mul_ps(dy, w));
+            }
+            // Fixed-order horizontal sum keeps the result reproducible
+            float lx[4], ly[4];
+            _mm_storeu_ps(lx, sumX);
+            _mm_storeu_ps(ly, sumY);
+            pushX[i] = (lx[0] + lx[1]) + (lx[2] + lx[3]);
+            pushY[i] = (ly[0] + ly[1]) + (ly[2] + ly[3]);
+        }
+#else
+        for (size_t i = 0; i < count; ++i) {
+            float lx[4] = {}, ly[4] = {};
+            for (int k = 0; k < CROWD_MAX_NEIGHBOURS; ++k) {
+                size_t o = i * CROWD_MAX_NEIGHBOURS + k;
+                float d = std::sqrt(offX[o] * offX[o] + offY[o] * offY[o]);
+                float w = 1.0f - d * invR;
+                if (w < 0.0f) w = 0.0f;
+                w = (w * valid[o]) / d;
+                lx[k & 3] += offX[o] * w;
+                ly[k & 3] += offY[o] * w;
+            }
+            pushX[i] = (lx[0] + lx[1]) + (lx[2] + lx[3]);
+            pushY[i] = (ly[0] + ly[1]) + (ly[2] + ly[3]);
+        }
+#endif
+    }
+};
@@ -1,5 +1,6 @@
 #include <SDL2/SDL.h>
 #include <cmath>
+#include "tick_rate.h"
 
 // Dash Demo implementing player dash mechanics from Section 10.
 // This example shows a player that can run and perform an 8-way dash
@@ -8,7 +9,6 @@
 
 constexpr int SCREEN_W = 480;
 constexpr int SCREEN_H = 270;
-constexpr float DT      = 1.0f / 60.0f;
 
 // Player struct holding state for dash
 struct Player {
@@ -23,6 +23,7 @@ struct Player {
 };
 
 int main(int argc, char* argv[]) {
+    const float DT = parseTickRate(argc, argv).dt;
     if (SDL_Init(SDL_INIT_VIDEO) != 0) {
         SDL_Log("SDL_Init Error: %s", SDL_GetError());
         return 1;
@@ -173,7 +174,7 @@ int main(int argc, char* argv[]) {
 
             // Camera follow horizontally
             float targetCam = player.x - SCREEN_W * 0.5f;
-            cameraX += (targetCam - cameraX) * 0.1f;
+            cameraX += (targetCam - cameraX) * approachFactor(CAMERA_FOLLOW_RATE, DT);
 
             accumulator -= DT;
         }
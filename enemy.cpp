@@ -1,5 +1,6 @@
 #include <SDL2/SDL.h>
 #include <cmath>
+#include "tick_rate.h"
 
 // Simple Enemy Demo implementing a grunt swordsman with patrol and attack telegraph.
 // This demonstrates Sections 11 and 12.1 of the specification. The enemy patrols
@@ -8,7 +9,6 @@
 
 constexpr int SCREEN_W = 480;
 constexpr int SCREEN_H = 270;
-constexpr float DT = 1.0f / 60.0f;
 
 struct Player {
     float x, y;
@@ -26,6 +26,7 @@ struct Enemy {
 };
 
 int main(int argc, char* argv[]) {
+    const float DT = parseTickRate(argc, argv).dt;
     SDL_Init(SDL_INIT_VIDEO);
     SDL_Window* window = SDL_CreateWindow("Enemy Demo",
         SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
@@ -142,7 +143,7 @@ int main(int argc, char* argv[]) {
             if (player.x > 1024.0f) player.x = 1024.0f;
             // Camera follow
             float targetCam = player.x - SCREEN_W * 0.5f;
-            cameraX += (targetCam - cameraX) * 0.1f;
+            cameraX += (targetCam - cameraX) * approachFactor(CAMERA_FOLLOW_RATE, DT);
             accumulator -= DT;
         }
         // Render scene
@@ -0,0 +1,63 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#include "profiler.h"
+
+// Flame Graph Renderer (Section 0 – Diagnostics)
+// Turns folded-stack files ("root;caller;leaf count" per line, as written
+// by the sampling profiler, profiler.h) into a self-contained SVG flame
+// graph.  Several inputs are merged, so profiles of a few runs of the same
+// demo can be viewed together.  Lines that do not end in a count are
+// skipped.
+//
+// Build: g++ -O2 -std=c++17 flamegraph.cpp -o flamegraph
+// Usage: flamegraph [-t title] -o out.svg <file.folded>...
+
+int main(int argc, char** argv) {
+    const char* out = nullptr;
+    const char* title = "Flame Graph";
+    std::vector<const char*> inputs;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) out = argv[++i];
+        else if (std::strcmp(argv[i], "-t") == 0 && i + 1 < argc) title = argv[++i];
+        else inputs.push_back(argv[i]);
+    }
+    if (!out || inputs.empty()) {
+        std::fprintf(stderr, "usage: %s [-t title] -o out.svg <file.folded>...\n", argv[0]);
+        return 1;
+    }
+    std::map<std::string, uint64_t> merged;
+    size_t skipped = 0;
+    for (const char* path : inputs) {
+        FILE* f = std::fopen(path, "r");
+        if (!f) {
+            std::fprintf(stderr, "cannot open %s\n", path);
+            return 1;
+        }
+        std::string line;
+        auto take = [&] {
+            size_t space = line.rfind(' ');
+            char* end = nullptr;
+            unsigned long long count = space == std::string::npos ? 0 : std::strtoull(line.c_str() + space + 1, &end, 10);
+            if (count && end && *end == '\0') merged[line.substr(0, space)] += count;
+            else if (!line.empty()) ++skipped;
+            line.clear();
+        };
+        for (int c; (c = std::fgetc(f)) != EOF;) {
+            if (c == '\n') take();
+            else line += (char)c;
+        }
+        take();
+        std::fclose(f);
+    }
+    std::vector<std::pair<std::string, uint64_t>> folded(merged.begin(), merged.end());
+    if (!writeFlameGraphSvg(folded, out, title)) {
+        std::fprintf(stderr, "cannot write %s\n", out);
+        return 1;
+    }
+    std::printf("%zu stacks -> %s (%zu lines skipped)\n", folded.size(), out, skipped);
+    return 0;
+}
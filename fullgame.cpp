@@ -2,10 +2,11 @@
 #include <vector>
 #include <algorithm>
 #include <cmath>
+#include "tick_rate.h"
+#include "aabb_simd.h"
 
 const int SCREEN_W = 480;
 const int SCREEN_H = 270;
-const float DT = 1.0f / 60.0f;
 
 struct ParallaxLayer {
     float speed;
@@ -30,6 +31,7 @@ struct Player {
 };
 
 int main(int argc, char** argv) {
+    const float DT = parseTickRate(argc, argv).dt;
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS) != 0) {
         return 1;
     }
@@ -51,6 +53,12 @@ int main(int argc, char** argv) {
     coins.push_back({200, SCREEN_H - 60, 12, 12});
     coins.push_back({300, SCREEN_H - 60, 12, 12});
     coins.push_back({380, SCREEN_H - 60, 12, 12});
+    // Pickup boxes in SoA form for the overlap kernel, parallel to `coins`
+    AabbArrays coinBoxes;
+    for (const SDL_Rect& c : coins) {
+        coinBoxes.add({ (float)c.x, (float)c.y, (float)(c.x + c.w), (float)(c.y + c.h) });
+    }
+    std::vector<uint64_t> coinHits;
     int coinCount = 0;
 
     float cameraX = 0.0f;
@@ -156,19 +164,21 @@ int main(int argc, char** argv) {
             } else {
                 player.onGround = false;
             }
-            // Coin collection
-            for (auto it = coins.begin(); it != coins.end(); ) {
-                SDL_Rect pRect = { (int)player.x, (int)player.y, 20, 20 };
-                if (SDL_HasIntersection(&pRect, &*it)) {
+            // Coin collection: the player box against every coin in one batch
+            coinHits.resize(aabbMaskWords(coinBoxes.size()));
+            Aabb body = { player.x, player.y, player.x + 20.0f, player.y + 20.0f };
+            if (aabbOverlapMask(body, coinBoxes.span(), coinHits.data())) {
+                // erase from the back so earlier indices stay valid
+                for (size_t i = coinBoxes.size(); i-- > 0;) {
+                    if (!(coinHits[i / 64] >> (i % 64) & 1)) continue;
                     coinCount++;
-                    it = coins.erase(it);
-                } else {
-                    ++it;
+                    coins.erase(coins.begin() + i);
+                    coinBoxes.erase(i);
                 }
             }
             // Camera follow
             float targetCam = player.x - SCREEN_W * 0.5f;
-            cameraX += (targetCam - cameraX) * 0.1f;
+            cameraX += (targetCam - cameraX) * approachFactor(CAMERA_FOLLOW_RATE, DT);
         }
         // Render scene
         SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
@@ -1,6 +1,15 @@
 #include <SDL2/SDL.h>
 #include <cmath>
 #include <array>
+#include <vector>
+#include "render_target.h"
+#include "rng.h"
+#include "crowd.h"
+#include "parallax_bake.h"
+#include "tick_rate.h"
+#include "quality_governor.h"
+#include "collision_query.h"
+#include "contact_solver.h"
 
 // Unified demo: combines parallax background, player movement with dash,
 // and a simple enemy AI. This serves as a step toward the complete game.
@@ -8,19 +17,19 @@
 
 constexpr int SCREEN_W = 480;
 constexpr int SCREEN_H = 270;
-constexpr float DT = 1.0f / 60.0f;
+constexpr uint64_t LEVEL_SEED = 0x2D0C0FFEEull;
+constexpr int GRUNT_COUNT = 8;
+constexpr float SEPARATION_SPEED = 90.0f; // px/s of push per fully overlapping neighbour
+constexpr float AGGRO_RANGE = 60.0f;
+constexpr float FAR_GRUNT_DISTANCE = SCREEN_W * 0.25f; // px from the player; farther grunts may be drawn stale
+constexpr uint32_t PLAYER_HURT_BIT = 1u << 1; // PLAYER_HURT_LAYER (Section 13)
 
-// Parallax layer definition
-struct ParallaxLayer {
-    float speed;
-    SDL_Color color;
-};
-
-static const std::array<ParallaxLayer,4> PARALLAX = {{
-    {0.05f,{135,206,235,255}}, // sky
-    {0.2f, {100,149,237,255}}, // far
-    {0.45f,{70,130,180,255}}, // mid
-    {0.75f,{65,105,225,255}}  // near
+// Parallax layers, baked procedurally from LEVEL_SEED at load
+static const std::array<ParallaxLayerDesc,4> PARALLAX = {{
+    {0.05f,{135,206,235,255}, ParallaxKind::Sky},     // sky
+    {0.2f, {100,149,237,255}, ParallaxKind::Clouds},  // far
+    {0.45f,{70,130,180,255},  ParallaxKind::Hills},   // mid
+    {0.75f,{65,105,225,255},  ParallaxKind::Foliage}  // near
 }};
 
 // Player with dash
@@ -38,6 +47,7 @@ struct Player {
 // Enemy with simple AI
 enum class EnemyState{ Patrol, Telegraph, Attack, Recover };
 struct Enemy {
+    uint32_t id;
     float x,y;
     float vx;
     EnemyState state;
@@ -45,22 +55,54 @@ struct Enemy {
 };
 
 int main(int argc, char* argv[]){
+    const float DT = parseTickRate(argc, argv).dt;
     SDL_Init(SDL_INIT_VIDEO);
     SDL_Window* window = SDL_CreateWindow("Unified Demo", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
-        SCREEN_W*2, SCREEN_H*2, SDL_WINDOW_SHOWN);
-    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED|SDL_RENDERER_PRESENTVSYNC);
-    SDL_RenderSetLogicalSize(renderer, SCREEN_W, SCREEN_H);
+        SCREEN_W*2, SCREEN_H*2, SDL_WINDOW_SHOWN|SDL_WINDOW_RESIZABLE|SDL_WINDOW_ALLOW_HIGHDPI);
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED|SDL_RENDERER_PRESENTVSYNC|SDL_RENDERER_TARGETTEXTURE);
+    // Start painting the background while the rest of the level loads
+    ParallaxBaker<4> parallax;
+    parallax.start(PARALLAX, LEVEL_SEED, SCREEN_W, SCREEN_H);
+    RenderTarget target;
+    if(!target.create(renderer, SCREEN_W, SCREEN_H)) return 1;
 
     Player player{SCREEN_W/4.0f, SCREEN_H-30.0f, 0.0f, 0.0f, true, false, 0.0f, 0.0f, 1.0f, 0.0f};
-    Enemy enemy{SCREEN_W*0.8f, SCREEN_H-30.0f, -40.0f, EnemyState::Patrol, 0.0f};
     float patrolLeft = SCREEN_W*0.6f;
     float patrolRight = SCREEN_W*0.9f;
+    // A squad of grunts sharing one patrol stretch, placed from the level seed
+    std::vector<Enemy> enemies;
+    for(uint32_t id=0; id<GRUNT_COUNT; ++id){
+        RngStream rng(LEVEL_SEED, RngSystem::Spawn, id, 0);
+        float x = rng.range(patrolLeft, patrolRight);
+        float vx = (rng.nextFloat() < 0.5f ? -40.0f : 40.0f);
+        enemies.push_back({id, x, SCREEN_H-30.0f, vx, EnemyState::Patrol, 0.0f});
+    }
+    CrowdSeparation crowd;
+    std::vector<float> crowdX(GRUNT_COUNT), crowdY(GRUNT_COUNT), pushX(GRUNT_COUNT), pushY(GRUNT_COUNT);
+    // Aggro checks go out as one batch of overlap queries per tick
+    CollisionWorld collision;
+    ColliderSet targets;
+    std::vector<OverlapQuery> aggroQueries(GRUNT_COUNT);
+    std::vector<OverlapPair> aggroPairs;
+    std::vector<uint8_t> aggro(GRUNT_COUNT);
+    // Grunt bodies are pushed out of each other and out of the player
+    ContactBodies bodies;
+    ContactSolver contacts;
+    std::vector<ContactPair> contactPairs;
     float cameraX = 0.0f;
+    if(!parallax.upload(renderer)) return 1;
+
+    // Presentation quality follows the CPU frame budget; never read by the sim
+    QualityGovernor governor;
+    std::vector<Enemy> drawnEnemies = enemies;   // what was last drawn of each grunt
+    uint32_t frameIndex = 0;
+    const float perfToMs = 1000.0f / (float)SDL_GetPerformanceFrequency();
 
     bool quit=false;
     Uint32 lastTick = SDL_GetTicks();
     float accumulator = 0.0f;
     while(!quit){
+        Uint64 frameStart = SDL_GetPerformanceCounter();
         Uint32 now = SDL_GetTicks();
         float frameTime = (now - lastTick)/1000.0f;
         if(frameTime>0.25f) frameTime=0.25f;
@@ -70,6 +112,10 @@ int main(int argc, char* argv[]){
         SDL_Event e;
         while(SDL_PollEvent(&e)){
             if(e.type==SDL_QUIT) quit=true;
+            target.handleEvent(e);
+            if(e.type==SDL_RENDER_DEVICE_RESET && !parallax.deviceReset(renderer)){
+                SDL_Log("Failed to recreate the parallax layers");
+            }
         }
         const Uint8* keys = SDL_GetKeyboardState(nullptr);
 
@@ -78,11 +124,11 @@ int main(int argc, char* argv[]){
             if(!player.dashing){
                 float accel = 2400.0f;
                 float decel = 2800.0f;
-                float target = 0.0f;
-                if(keys[SDL_SCANCODE_A] || keys[SDL_SCANCODE_LEFT]) target -= 1.0f;
-                if(keys[SDL_SCANCODE_D] || keys[SDL_SCANCODE_RIGHT]) target += 1.0f;
-                if(target != 0.0f){
-                    player.vx += target*accel*DT;
+                float moveDir = 0.0f;
+                if(keys[SDL_SCANCODE_A] || keys[SDL_SCANCODE_LEFT]) moveDir -= 1.0f;
+                if(keys[SDL_SCANCODE_D] || keys[SDL_SCANCODE_RIGHT]) moveDir += 1.0f;
+                if(moveDir != 0.0f){
+                    player.vx += moveDir*accel*DT;
                     if(player.vx > 220.0f) player.vx = 220.0f;
                     if(player.vx < -220.0f) player.vx = -220.0f;
                 } else {
@@ -149,77 +195,116 @@ int main(int argc, char* argv[]){
             }
             if(player.x < 0.0f) player.x = 0.0f;
             if(player.x > 1024.0f) player.x = 1024.0f;
+            // Aggro: a horizontal band around each grunt against the player's column
+            targets.clear();
+            targets.add({player.x, player.y, player.x, player.y}, PLAYER_HURT_BIT, 0);
+            collision.setColliders(targets);
+            for(size_t i=0;i<enemies.size();++i){
+                aggroQueries[i] = {{enemies[i].x-AGGRO_RANGE, -1e9f, enemies[i].x+AGGRO_RANGE, 1e9f}, PLAYER_HURT_BIT};
+            }
+            collision.overlap(aggroQueries.data(), enemies.size(), aggroPairs, nullptr);
+            std::fill(aggro.begin(), aggro.end(), 0);
+            for(const OverlapPair& p : aggroPairs) aggro[p.query] = 1;
             // Enemy AI
-            float dist = std::abs(enemy.x - player.x);
-            switch(enemy.state){
-                case EnemyState::Patrol:
-                    enemy.x += enemy.vx * DT;
-                    if((enemy.vx<0 && enemy.x <= patrolLeft) || (enemy.vx>0 && enemy.x >= patrolRight)){
-                        enemy.vx = -enemy.vx;
-                    }
-                    if(dist < 60.0f){
-                        enemy.state = EnemyState::Telegraph;
-                        enemy.timer = 0.25f;
-                    }
-                    break;
-                case EnemyState::Telegraph:
-                    enemy.timer -= DT;
-                    if(enemy.timer <= 0.0f){
-                        enemy.state = EnemyState::Attack;
-                        enemy.vx = (player.x < enemy.x ? -1.0f : 1.0f) * 300.0f;
-                        enemy.timer = 0.12f;
-                    }
-                    break;
-                case EnemyState::Attack:
-                    enemy.timer -= DT;
-                    enemy.x += enemy.vx * DT;
-                    if(enemy.timer <= 0.0f){
-                        enemy.state = EnemyState::Recover;
-                        enemy.vx = (enemy.x < (patrolLeft+patrolRight)/2 ? 40.0f : -40.0f);
-                        enemy.timer = 0.4f;
-                    }
-                    break;
-                case EnemyState::Recover:
-                    enemy.timer -= DT;
-                    enemy.x += enemy.vx * DT;
-                    if(enemy.timer <= 0.0f){
-                        enemy.state = EnemyState::Patrol;
-                        enemy.vx = (enemy.x < (patrolLeft+patrolRight)/2 ? 40.0f : -40.0f);
-                    }
-                    break;
+            for(size_t i=0;i<enemies.size();++i){
+                Enemy& enemy = enemies[i];
+                switch(enemy.state){
+                    case EnemyState::Patrol:
+                        enemy.x += enemy.vx * DT;
+                        if((enemy.vx<0 && enemy.x <= patrolLeft) || (enemy.vx>0 && enemy.x >= patrolRight)){
+                            enemy.vx = -enemy.vx;
+                        }
+                        if(aggro[i]){
+                            enemy.state = EnemyState::Telegraph;
+                            enemy.timer = 0.25f;
+                        }
+                        break;
+                    case EnemyState::Telegraph:
+                        enemy.timer -= DT;
+                        if(enemy.timer <= 0.0f){
+                            enemy.state = EnemyState::Attack;
+                            enemy.vx = (player.x < enemy.x ? -1.0f : 1.0f) * 300.0f;
+                            enemy.timer = 0.12f;
+                        }
+                        break;
+                    case EnemyState::Attack:
+                        enemy.timer -= DT;
+                        enemy.x += enemy.vx * DT;
+                        if(enemy.timer <= 0.0f){
+                            enemy.state = EnemyState::Recover;
+                            enemy.vx = (enemy.x < (patrolLeft+patrolRight)/2 ? 40.0f : -40.0f);
+                            enemy.timer = 0.4f;
+                        }
+                        break;
+                    case EnemyState::Recover:
+                        enemy.timer -= DT;
+                        enemy.x += enemy.vx * DT;
+                        if(enemy.timer <= 0.0f){
+                            enemy.state = EnemyState::Patrol;
+                            enemy.vx = (enemy.x < (patrolLeft+patrolRight)/2 ? 40.0f : -40.0f);
+                        }
+                        break;
+                }
+            }
+            // Crowd separation: keep grunts sharing a patrol stretch apart
+            for(size_t i=0;i<enemies.size();++i){ crowdX[i]=enemies[i].x; crowdY[i]=enemies[i].y; }
+            crowd.compute(crowdX.data(), crowdY.data(), enemies.size(), pushX.data(), pushY.data());
+            for(size_t i=0;i<enemies.size();++i){
+                if(enemies[i].state==EnemyState::Patrol || enemies[i].state==EnemyState::Recover){
+                    enemies[i].x += pushX[i] * SEPARATION_SPEED * DT;
+                }
             }
+            // Hard contacts: grunts are dynamic, the player is an immovable body.
+            // Only x is written back: grunts have no vertical motion (no gravity,
+            // one ground line), so a y push - the player coming down on a grunt -
+            // would sink it into the floor for good.  Such a contact is dropped
+            // and the two overlap until the player moves off; side contacts,
+            // the only kind between grunts on one line, are kept.
+            bodies.clear();
+            for(const auto& enemy : enemies) bodies.add(enemy.x, enemy.y, 10.0f, 20.0f, 1.0f);
+            bodies.add(player.x, player.y, 8.0f, 20.0f, 0.0f);
+            contacts.step(bodies, nullptr, contactPairs);
+            for(size_t i=0;i<enemies.size();++i) enemies[i].x = bodies.x[i];
             // Camera follow
             float targetCam = player.x - SCREEN_W*0.5f;
-            cameraX += (targetCam - cameraX) * 0.1f;
+            cameraX += (targetCam - cameraX) * approachFactor(CAMERA_FOLLOW_RATE, DT);
             accumulator -= DT;
         }
         // Render
+        target.refresh();
+        target.begin();
         SDL_SetRenderDrawColor(renderer, 0,0,0,255);
         SDL_RenderClear(renderer);
-        // Draw parallax layers
-        for(const auto& layer: PARALLAX){
-            float offset = fmodf(cameraX * layer.speed, (float)SCREEN_W);
+        // Draw parallax layers; lower quality tiers drop the far layers after the sky
+        const QualitySettings& quality = governor.settings();
+        size_t firstDetail = PARALLAX.size() - (size_t)(quality.parallaxLayers - 1);
+        for(size_t i=0;i<PARALLAX.size();++i){
+            if(i != 0 && i < firstDetail) continue;
+            float offset = fmodf(cameraX * PARALLAX[i].speed, (float)SCREEN_W);
             if(offset < 0) offset += SCREEN_W;
-            SDL_SetRenderDrawColor(renderer, layer.color.r, layer.color.g, layer.color.b, layer.color.a);
-            SDL_Rect rect1{ (int)-offset, 0, SCREEN_W, SCREEN_H};
-            SDL_Rect rect2{ rect1.x + SCREEN_W, 0, SCREEN_W, SCREEN_H};
-            SDL_RenderFillRect(renderer, &rect1);
-            SDL_RenderFillRect(renderer, &rect2);
+            parallax.draw(renderer, i, offset);
         }
         // Ground
         SDL_SetRenderDrawColor(renderer, 50,205,50,255);
         SDL_Rect ground{0, SCREEN_H-20, SCREEN_W, 20};
         SDL_RenderFillRect(renderer, &ground);
-        // Enemy
-        if(enemy.state == EnemyState::Telegraph){
-            SDL_SetRenderDrawColor(renderer, 255,165,0,255);
-        } else if(enemy.state == EnemyState::Attack){
-            SDL_SetRenderDrawColor(renderer, 255,0,0,255);
-        } else {
-            SDL_SetRenderDrawColor(renderer, 139,0,0,255);
+        // Enemies; lower quality tiers refresh grunts far from the player
+        // only every farEntityDivisor frames
+        const bool refreshFar = frameIndex++ % (uint32_t)quality.farEntityDivisor == 0;
+        for(size_t i=0;i<enemies.size();++i){
+            if(refreshFar || std::fabs(enemies[i].x - player.x) < FAR_GRUNT_DISTANCE) drawnEnemies[i] = enemies[i];
+        }
+        for(const auto& enemy : drawnEnemies){
+            if(enemy.state == EnemyState::Telegraph){
+                SDL_SetRenderDrawColor(renderer, 255,165,0,255);
+            } else if(enemy.state == EnemyState::Attack){
+                SDL_SetRenderDrawColor(renderer, 255,0,0,255);
+            } else {
+                SDL_SetRenderDrawColor(renderer, 139,0,0,255);
+            }
+            SDL_Rect eRect{ (int)(enemy.x - cameraX) - 10, (int)(enemy.y) -20, 20, 40};
+            SDL_RenderFillRect(renderer, &eRect);
         }
-        SDL_Rect eRect{ (int)(enemy.x - cameraX) - 10, (int)(enemy.y) -20, 20, 40};
-        SDL_RenderFillRect(renderer, &eRect);
         // Player
         SDL_SetRenderDrawColor(renderer, 70,130,180,255);
         SDL_Rect pRect{ (int)(player.x - cameraX) - 8, (int)(player.y) -20, 16, 40};
@@ -232,8 +317,15 @@ int main(int argc, char* argv[]){
         SDL_SetRenderDrawColor(renderer,30,144,255,255);
         SDL_Rect bar{10, SCREEN_H-15, (int)(dashRatio * 100.0f), 5};
         SDL_RenderFillRect(renderer, &bar);
-        SDL_RenderPresent(renderer);
+        // Work time excludes present, which may block on vsync
+        float workMs = (SDL_GetPerformanceCounter() - frameStart) * perfToMs;
+        if(governor.addFrame(workMs)){
+            SDL_Log("Quality tier %d (p95 %.2f ms, budget %.2f ms)", governor.tier, governor.lastPercentileMs, governor.budgetMs);
+        }
+        target.present();
     }
+    parallax.destroy();
+    target.destroy();
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
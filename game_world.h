@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include "sim.h"
+#include "terrain.h"
+#include "cellular.h"
+#include "crates.h"
+#include "ropes.h"
+#include "job_system.h"
+
+//----------------------------------------------------------------------------
+// Game World
+//----------------------------------------------------------------------------
+// Everything the fixed tick simulates, stepped in one place.  main.cpp,
+// spectators (spectator_stream.h) and replay_analytics all run step(), so a
+// change to the order of systems reaches every one of them and replays and
+// spectators stay deterministic with the game.  No SDL: rendering, input,
+// the minimap and metrics stay with the caller.
+//
+
+// What happened during one step(), for callers that keep statistics
+struct GameTickEvents {
+    uint32_t coinsGained{ 0 };   // bits of the coins picked up this tick
+    bool died{ false };          // fell below the kill plane or touched lava
+    Player beforeRespawn{};      // the player where it died, when `died`
+};
+
+struct GameWorld {
+    Player player;
+    Camera camera;
+    Terrain terrain;
+    CrateWorld crates;
+    RopeWorld ropes;
+    CellWorld cells;
+    uint32_t coins{ 0 };
+    uint32_t tick{ 0 };
+
+    void reset() {
+        respawn(player);
+        camera = Camera{};
+        terrain = Terrain{};
+        terrain.load(LEVEL_DATA.data(), LEVEL_WIDTH, LEVEL_HEIGHT);
+        crates.reset(terrain.solidity);
+        ropes.reset(terrain.solidity);
+        cells.reset(terrain);
+        coins = 0;
+        tick = 0;
+    }
+
+    GameTickEvents step(const PlayerInput& input, float dt, JobSystem* jobs = nullptr) {
+        GameTickEvents events;
+        player.update(input, dt, terrain.solidity);
+        terrain.step(player, input, dt);
+        cells.step(dt, player, crates.physics, jobs);
+        const TileRect& edit = terrain.editedThisTick;
+        if (!edit.empty()) crates.terrainChanged(edit.x0, edit.y0, edit.x1, edit.y1);
+        crates.step(player, dt);
+        ropes.step(player, input, dt);
+        events.coinsGained = touchCoins(player, coins);
+        coins |= events.coinsGained;
+        if (belowKillPlane(player) || cells.touching(player, TILE_LAVA)) {
+            events.died = true;
+            events.beforeRespawn = player;
+            respawn(player);
+        }
+        camera.update(player.position, dt);
+        ++tick;
+        return events;
+    }
+};
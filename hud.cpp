@@ -1,11 +1,14 @@
 #include <SDL2/SDL.h>
 #include <algorithm>
+#include "tick_rate.h"
+#include "render_queue.h"
 
 const int SCREEN_W = 480;
 const int SCREEN_H = 270;
-const float DT = 1.0f / 60.0f;
+const int IDLE_WAIT_MS = 250; // max time to block for input while nothing on screen changes
 
 int main(int argc, char** argv) {
+    const float DT = parseTickRate(argc, argv).dt;
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS) != 0) {
         return 1;
     }
@@ -16,38 +19,50 @@ int main(int argc, char** argv) {
     const int maxSegments = 20; // 5 hearts * 4 segments each
     int hpSegments = maxSegments; // start full
 
+    RenderQueue queue;
     Uint32 lastTicks = SDL_GetTicks();
     float accumulator = 0.0f;
     bool running = true;
 
+    auto handleEvent = [&](const SDL_Event& e) {
+        queue.handleEvent(e);
+        if (e.type == SDL_QUIT) {
+            running = false;
+        } else if (e.type == SDL_KEYDOWN) {
+            // press H to take damage, J to heal
+            if (e.key.keysym.sym == SDLK_h) {
+                if (hpSegments > 0) hpSegments--;
+            } else if (e.key.keysym.sym == SDLK_j) {
+                if (hpSegments < maxSegments) hpSegments++;
+            }
+        }
+    };
+
     while (running) {
+        SDL_Event e;
+        // Last frame was identical to the one on screen: nothing can change
+        // until an event arrives, so sleep in the event queue.
+        if (queue.isIdle() && SDL_WaitEventTimeout(&e, IDLE_WAIT_MS)) {
+            handleEvent(e);
+        }
+        while (SDL_PollEvent(&e)) {
+            handleEvent(e);
+        }
+
         Uint32 now = SDL_GetTicks();
         float frameTime = (now - lastTicks) / 1000.0f;
+        if (frameTime > 0.25f) frameTime = 0.25f;
         lastTicks = now;
         accumulator += frameTime;
 
-        SDL_Event e;
-        while (SDL_PollEvent(&e)) {
-            if (e.type == SDL_QUIT) {
-                running = false;
-            } else if (e.type == SDL_KEYDOWN) {
-                // press H to take damage, J to heal
-                if (e.key.keysym.sym == SDLK_h) {
-                    if (hpSegments > 0) hpSegments--;
-                } else if (e.key.keysym.sym == SDLK_j) {
-                    if (hpSegments < maxSegments) hpSegments++;
-                }
-            }
-        }
-
         while (accumulator >= DT) {
             // nothing to update; we only simulate time for deterministic behavior
             accumulator -= DT;
         }
 
         // Render
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-        SDL_RenderClear(renderer);
+        queue.begin();
+        queue.clear(0, 0, 0, 255);
 
         // Draw hearts (top-left)
         int hearts = maxSegments / 4;
@@ -61,11 +76,11 @@ int main(int argc, char** argv) {
             for (int s = 0; s < 4; ++s) {
                 SDL_Rect segRect = { xStart + i * (segmentWidth * 4 + heartSpacing) + s * segmentWidth, yStart, segmentWidth, segmentHeight };
                 if (s < filled) {
-                    SDL_SetRenderDrawColor(renderer, 200, 30, 30, 255);
+                    queue.setColor(200, 30, 30, 255);
                 } else {
-                    SDL_SetRenderDrawColor(renderer, 60, 60, 60, 255);
+                    queue.setColor(60, 60, 60, 255);
                 }
-                SDL_RenderFillRect(renderer, &segRect);
+                queue.fillRect(segRect);
             }
         }
 
@@ -76,13 +91,17 @@ int main(int argc, char** argv) {
         int barX = (SCREEN_W - barW) / 2;
         int barY = SCREEN_H - barH - 10;
         SDL_Rect bg = { barX, barY, barW, barH };
-        SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
-        SDL_RenderFillRect(renderer, &bg);
+        queue.setColor(50, 50, 50, 255);
+        queue.fillRect(bg);
         SDL_Rect fill = { barX, barY, (int)(barW * ratio), barH };
-        SDL_SetRenderDrawColor(renderer, 30, 144, 255, 255);
-        SDL_RenderFillRect(renderer, &fill);
+        queue.setColor(30, 144, 255, 255);
+        queue.fillRect(fill);
 
-        SDL_RenderPresent(renderer);
+        // Skip submit and present when the frame matches what is on screen
+        if (queue.shouldPresent()) {
+            queue.submit(renderer);
+            SDL_RenderPresent(renderer);
+        }
     }
 
     SDL_DestroyRenderer(renderer);
@@ -0,0 +1,119 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//----------------------------------------------------------------------------
+// Job System (Section 0 – Threading)
+//----------------------------------------------------------------------------
+// A fixed pool of worker threads that runs parallel-for loops.  The range
+// [0, count) is handed out in chunks of `grain` from a shared atomic
+// counter, so fast workers simply take more chunks.  The calling thread
+// joins in as worker 0 and parallelFor() returns once every chunk is done.
+//
+// The body receives (begin, end, worker).  `worker` is stable for the
+// duration of a chunk and below workerCount(), so callers can keep one
+// accumulator per worker and merge them afterwards instead of sharing
+// state between threads.
+//
+// Workers sleep on a condition variable between loops; one pool can be kept
+// for the lifetime of the program and reused every tick.  threadStart, if
+// set before start(), runs first on every worker thread (e.g. to register
+// it with the sampling profiler, profiler.h).
+//
+
+struct JobSystem {
+    using Body = std::function<void(size_t, size_t, unsigned)>;
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    Body body;
+    std::function<void(unsigned)> threadStart;
+    size_t count{ 0 };
+    size_t grain{ 1 };
+    std::atomic<size_t> next{ 0 };
+    unsigned busy{ 0 };
+    uint64_t generation{ 0 };
+    bool quit{ false };
+
+    JobSystem() = default;
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    ~JobSystem() { stop(); }
+
+    // Total workers including the caller; 0 means one per hardware thread.
+    void start(unsigned workers = 0) {
+        stop();
+        if (workers == 0) workers = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned i = 1; i < workers; ++i) {
+            threads.emplace_back(&JobSystem::workerLoop, this, i, generation);
+        }
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        wake.notify_all();
+        for (std::thread& t : threads) t.join();
+        threads.clear();
+        quit = false;
+    }
+
+    unsigned workerCount() const { return (unsigned)threads.size() + 1; }
+
+    void parallelFor(size_t n, size_t grainSize, const Body& fn) {
+        if (n == 0) return;
+        grainSize = std::max<size_t>(1, grainSize);
+        if (threads.empty() || n <= grainSize) {
+            fn(0, n, 0);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            body = fn;
+            count = n;
+            grain = grainSize;
+            next.store(0, std::memory_order_relaxed);
+            busy = (unsigned)threads.size();
+            ++generation;
+        }
+        wake.notify_all();
+        runChunks(0);
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return busy == 0; });
+        body = nullptr;
+    }
+
+    void runChunks(unsigned worker) {
+        for (;;) {
+            size_t begin = next.fetch_add(grain, std::memory_order_relaxed);
+            if (begin >= count) break;
+            body(begin, std::min(begin + grain, count), worker);
+        }
+    }
+
+    void workerLoop(unsigned worker, uint64_t seen) {
+        if (threadStart) threadStart(worker);
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return quit || generation != seen; });
+                if (quit) return;
+                seen = generation;
+            }
+            runChunks(worker);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--busy == 0) done.notify_one();
+        }
+    }
+};
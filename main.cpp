@@ -1,9 +1,27 @@
 #include <SDL2/SDL.h>
 #include <cstdint>
+#include <cstring>
 #include <array>
 #include <vector>
 #include <cmath>
 #include <memory>
+#include <algorithm>
+#include "render_target.h"
+#include "sim.h"
+#include "tick_rate.h"
+#include "sdl_alloc.h"
+#include "replay.h"
+#include "solidity.h"
+#include "minimap.h"
+#include "texture_cache.h"
+#include "stats_overlay.h"
+#include "game_world.h"
+#include "job_system.h"
+#include "metrics_shm.h"
+#include "profiler.h"
+#include "render_capture.h"
+#include "spectator_stream.h"
+#include "asset_pack.h"
 
 //----------------------------------------------------------------------------
 // 2D Platformer Implementation Skeleton with Camera
@@ -14,38 +32,20 @@
 // screen.  Other systems (physics, input, parallax) remain as in the
 // original skeleton, providing a foundation for further development.
 //
-
-// Section 0 – Global Targets & Constraints
-constexpr float FIXED_DT        = 1.0f / 60.0f;     // Deterministic timestep (dt = 1/60 s)
-constexpr int   TILE_SIZE       = 16;               // World units = pixels; tile = 16×16 px
-constexpr int   NATIVE_W        = 480;              // Native render target width
-constexpr int   NATIVE_H        = 270;              // Native render target height
-constexpr float GRAVITY         = 2100.0f;          // Gravity (Section 7/8)
-constexpr float MAX_RUN_SPEED   = 220.0f;           // Player Vmax (Section 7)
-constexpr float GROUND_ACCEL    = 2400.0f;
-constexpr float GROUND_DECEL    = 2800.0f;
-constexpr float AIR_ACCEL       = 1400.0f;
-constexpr float AIR_DECEL       = 1000.0f;
-constexpr float JUMP_V0         = -620.0f;          // Primary jump velocity (Section 8)
-
-// Section 13 – Collision Layers (bitmasks)
-enum CollisionLayer : uint8_t {
-    TILE_LAYER         = 0,
-    PLAYER_HURT_LAYER  = 1,
-    PLAYER_ATTACK_LAYER= 2,
-    ENEMY_HURT_LAYER   = 3,
-    ENEMY_ATTACK_LAYER = 4,
-    SENSOR_LAYER       = 5
-};
-
-// Simple 2‑D vector for positions/velocities
-struct Vec2 {
-    float x{}, y{};
-};
+// The simulation itself (constants, level, camera, player movement) lives in
+// sim.h and its fixed tick in game_world.h, so headless tools run the same
+// code; this file owns input and rendering.
+// Pass --tick-rate 60|120|240 to change the fixed step (tick_rate.h) and
+// --record PATH to save the session's inputs as a replay (replay.h).
+// --capture=PATH writes every frame's render calls for render_replay
+// (render_capture.h).  --spectate[=PORT] streams the session to spectator
+// clients on localhost (spectator_stream.h).  Art is taken from the asset
+// pack given by --assets=PATH (default assets.pak, asset_pack.h) when it
+// has it, and generated otherwise.  --alloc-report prints the SDL
+// allocator's per-tag and size-class statistics on exit (sdl_alloc.h).
+//
 
 // Section 5 – Player Visual Design (simple silhouette)
-static constexpr int PLAYER_W = 22;
-static constexpr int PLAYER_H = 32;
 static const std::array<uint32_t, PLAYER_W * PLAYER_H> PLAYER_PIXELS = []{
     std::array<uint32_t, PLAYER_W * PLAYER_H> data{};
     for (int i = 0; i < PLAYER_W * PLAYER_H; ++i) {
@@ -54,185 +54,138 @@ static const std::array<uint32_t, PLAYER_W * PLAYER_H> PLAYER_PIXELS = []{
     return data;
 }();
 
-// Section 6 – Player State Machine (skeleton enumerations)
-enum class PlayerState {
-    Idle,
-    Run,
-    JumpRise,
-    JumpApex,
-    Fall,
-    Land,
-    Dash,
-    Hurt,
-    Dead
-    // Additional states can be added here
-};
-
-// Section 15 – Level Definition (tile map)
-static constexpr int LEVEL_WIDTH  = 32;
-static constexpr int LEVEL_HEIGHT = 16;
-static const std::array<uint8_t, LEVEL_WIDTH * LEVEL_HEIGHT> LEVEL_DATA = []{
-    std::array<uint8_t, LEVEL_WIDTH * LEVEL_HEIGHT> data{};
-    for (int y = 0; y < LEVEL_HEIGHT; ++y) {
-        for (int x = 0; x < LEVEL_WIDTH; ++x) {
-            data[y * LEVEL_WIDTH + x] = (y == LEVEL_HEIGHT - 1) ? 1 : 0;
-        }
+// The sprite from the asset pack if it holds one of the right size: used in
+// place when stored raw, decoded into `storage` when compressed
+const uint32_t* loadPlayerSprite(const AssetPack& assets, std::vector<uint32_t>& storage) {
+    constexpr uint64_t PLAYER_SPRITE = assetHash("sprites/player.argb");
+    AssetView v;
+    if (!assets.isOpen() || !assets.find(PLAYER_SPRITE, v) || v.rawSize != PLAYER_PIXELS.size() * sizeof(uint32_t)) {
+        return PLAYER_PIXELS.data();
     }
-    return data;
-}();
-
-uint8_t getTile(int x, int y) {
-    if (x < 0 || y < 0 || x >= LEVEL_WIDTH || y >= LEVEL_HEIGHT) return 1;
-    return LEVEL_DATA[y * LEVEL_WIDTH + x];
+    if (v.compression == AssetCompression::None) return (const uint32_t*)v.data;
+    storage.resize(PLAYER_PIXELS.size());
+    return assetDecode(v, (uint8_t*)storage.data()) ? storage.data() : PLAYER_PIXELS.data();
 }
 
-// Section 2 – Camera (smooth follow)
-struct Camera {
-    Vec2 position{};
-    Vec2 velocity{};
-    // Update camera using a critically damped spring toward target
-    void update(const Vec2& target, float dt) {
-        // Compute desired position so that target appears near center of screen
-        Vec2 desired{ target.x - NATIVE_W * 0.5f + PLAYER_W * 0.5f,
-                      target.y - NATIVE_H * 0.5f + PLAYER_H * 0.5f };
-        float stiffness = 60.0f;      // spring stiffness
-        float damping   = 2.0f * std::sqrt(stiffness); // critical damping
-        // Spring force
-        Vec2 diff{ desired.x - position.x, desired.y - position.y };
-        velocity.x += diff.x * stiffness * dt;
-        velocity.y += diff.y * stiffness * dt;
-        // Damping
-        velocity.x *= std::exp(-damping * dt);
-        velocity.y *= std::exp(-damping * dt);
-        // Integrate
-        position.x += velocity.x * dt;
-        position.y += velocity.y * dt;
-        // Clamp to level bounds (Section 2 – Bounds)
-        if (position.x < 0) position.x = 0;
-        if (position.y < 0) position.y = 0;
-        float maxX = LEVEL_WIDTH * TILE_SIZE - NATIVE_W;
-        float maxY = LEVEL_HEIGHT * TILE_SIZE - NATIVE_H;
-        if (position.x > maxX) position.x = maxX;
-        if (position.y > maxY) position.y = maxY;
-    }
-};
+// Section 12 – HUD: minimap placement and fog-of-war reveal radius
+constexpr int MINIMAP_SCALE        = 3;   // screen pixels per minimap pixel
+constexpr int MINIMAP_REVEAL_TILES = 12;
 
-// Section 7/8 – Player Movement & Jumping
-struct Player {
-    Vec2 position{};
-    Vec2 velocity{};
-    PlayerState state{ PlayerState::Idle };
-    bool onGround{ false };
-    float jumpBufferTimer{ 0.0f };
-    float coyoteTimer{ 0.0f };
+// Section 1 – Rendering: the tile layer is drawn from cached chunk textures
+constexpr int    RENDER_CHUNK_TILES   = 16;                 // tiles per chunk texture edge
+constexpr int    RENDER_CHUNK_PIXELS  = RENDER_CHUNK_TILES * TILE_SIZE;
+constexpr int    RENDER_CHUNKS_X      = (LEVEL_WIDTH  + RENDER_CHUNK_TILES - 1) / RENDER_CHUNK_TILES;
+constexpr int    RENDER_CHUNKS_Y      = (LEVEL_HEIGHT + RENDER_CHUNK_TILES - 1) / RENDER_CHUNK_TILES;
+constexpr size_t TEXTURE_BUDGET_BYTES = 8u << 20;
+constexpr float  PREFETCH_SPEED       = 20.0f;              // camera px/s before prefetching ahead
+static_assert(RENDER_CHUNK_TILES == TERRAIN_CHUNK_TILES, "terrain rebuilds map 1:1 onto chunk textures");
 
-    void update(float dt) {
-        if (jumpBufferTimer > 0.0f) jumpBufferTimer -= dt;
-        if (coyoteTimer     > 0.0f) coyoteTimer     -= dt;
-        const Uint8* keys = SDL_GetKeyboardState(nullptr);
-        bool left  = keys[SDL_SCANCODE_LEFT] || keys[SDL_SCANCODE_A];
-        bool right = keys[SDL_SCANCODE_RIGHT] || keys[SDL_SCANCODE_D];
-        bool jump  = keys[SDL_SCANCODE_SPACE];
-        float desiredAccel = 0.0f;
-        if (left ^ right) {
-            desiredAccel = (left ? -1.0f : 1.0f) * (onGround ? GROUND_ACCEL : AIR_ACCEL);
-        } else {
-            if (onGround) {
-                if (velocity.x > 0.0f) desiredAccel = -GROUND_DECEL;
-                else if (velocity.x < 0.0f) desiredAccel = GROUND_DECEL;
-            } else {
-                if (velocity.x > 0.0f) desiredAccel = -AIR_DECEL;
-                else if (velocity.x < 0.0f) desiredAccel = AIR_DECEL;
-            }
-        }
-        velocity.x += desiredAccel * dt;
-        if (velocity.x >  MAX_RUN_SPEED) velocity.x =  MAX_RUN_SPEED;
-        if (velocity.x < -MAX_RUN_SPEED) velocity.x = -MAX_RUN_SPEED;
-        if (jump) {
-            jumpBufferTimer = 0.09f;
-        }
-        if (jumpBufferTimer > 0.0f && (onGround || coyoteTimer > 0.0f)) {
-            velocity.y = JUMP_V0;
-            onGround = false;
-            jumpBufferTimer = 0.0f;
-            coyoteTimer = 0.0f;
-        }
-        velocity.y += GRAVITY * dt;
-        Vec2 newPos = position;
-        newPos.x += velocity.x * dt;
-        newPos.y += velocity.y * dt;
-        // Y collisions
-        if (velocity.y > 0.0f) {
-            int bottom = (int)((newPos.y + PLAYER_H) / TILE_SIZE);
-            int leftTile  = (int)(newPos.x / TILE_SIZE);
-            int rightTile = (int)((newPos.x + PLAYER_W - 1) / TILE_SIZE);
-            bool collides = false;
-            for (int tx = leftTile; tx <= rightTile; ++tx) {
-                if (getTile(tx, bottom) == 1) { collides = true; break; }
-            }
-            if (collides) {
-                newPos.y = bottom * TILE_SIZE - PLAYER_H;
-                velocity.y = 0.0f;
-                onGround = true;
-                coyoteTimer = 0.1f;
-            }
-        } else if (velocity.y < 0.0f) {
-            // upward collision (omitted)
-        }
-        // X collisions
-        int top = (int)(newPos.y / TILE_SIZE);
-        int bottomY = (int)((newPos.y + PLAYER_H - 1) / TILE_SIZE);
-        if (velocity.x > 0.0f) {
-            int rightTile = (int)((newPos.x + PLAYER_W) / TILE_SIZE);
-            bool collides = false;
-            for (int ty = top; ty <= bottomY; ++ty) {
-                if (getTile(rightTile, ty) == 1) { collides = true; break; }
-            }
-            if (collides) {
-                newPos.x = rightTile * TILE_SIZE - PLAYER_W;
-                velocity.x = 0.0f;
-            }
-        } else if (velocity.x < 0.0f) {
-            int leftTile = (int)(newPos.x / TILE_SIZE);
-            bool collides = false;
-            for (int ty = top; ty <= bottomY; ++ty) {
-                if (getTile(leftTile, ty) == 1) { collides = true; break; }
-            }
-            if (collides) {
-                newPos.x = (leftTile + 1) * TILE_SIZE;
-                velocity.x = 0.0f;
+TextureKey tileChunkKey(int cx, int cy) {
+    return (TextureKey)(uint32_t)cy << 32 | (uint32_t)cx;
+}
+
+// The player sprite lives in the same cache (tile chunk keys never set the
+// top bit), so it is uploaded once, and again only after a device reset or
+// an invalidate() when the sprite changes.
+constexpr TextureKey PLAYER_TEXTURE_KEY = 1ull << 63;
+
+// Rasterise one chunk of the tile layer; empty tiles stay transparent.
+// Exposed top edges get a lighter strip (autotile mask, terrain.h); liquids
+// get it at their surface.
+SDL_Texture* buildTileChunk(SDL_Renderer* renderer, const Terrain& terrain, int cx, int cy) {
+    static const uint32_t FILL[TILE_ID_COUNT] = { 0, 0xFF6B4A2Fu, 0xFF9A7B4Fu, 0xFF464646u,    // by TileId
+                                                  0xFFD8C078u, 0xB02860D0u, 0xFFD04010u };
+    static const uint32_t EDGE[TILE_ID_COUNT] = { 0, 0xFF4FA83Cu, 0xFFC8A870u, 0xFF5A5A5Au,
+                                                  0xFFE8D498u, 0xC060A0F0u, 0xFFFFA030u };
+    std::vector<uint32_t> pixels((size_t)RENDER_CHUNK_PIXELS * RENDER_CHUNK_PIXELS, 0);
+    for (int ty = 0; ty < RENDER_CHUNK_TILES; ++ty) {
+        for (int tx = 0; tx < RENDER_CHUNK_TILES; ++tx) {
+            int x = cx * RENDER_CHUNK_TILES + tx, y = cy * RENDER_CHUNK_TILES + ty;
+            if (x >= terrain.width || y >= terrain.height) continue;
+            uint8_t id = terrain.get(x, y);
+            if (id == TILE_EMPTY || id >= TILE_ID_COUNT) continue;
+            bool exposedTop = tileSolid(id) ? !(terrain.autotile[(size_t)y * terrain.width + x] & AUTOTILE_N)
+                                            : terrain.get(x, y - 1) == TILE_EMPTY;
+            for (int py = 0; py < TILE_SIZE; ++py) {
+                uint32_t* row = &pixels[(size_t)(ty * TILE_SIZE + py) * RENDER_CHUNK_PIXELS + tx * TILE_SIZE];
+                std::fill(row, row + TILE_SIZE, exposedTop && py < 3 ? EDGE[id] : FILL[id]);
             }
         }
-        position = newPos;
-        // State update
-        if (!onGround) {
-            state = (velocity.y < 0.0f) ? PlayerState::JumpRise : PlayerState::Fall;
-        } else {
-            state = (std::abs(velocity.x) > 1.0f) ? PlayerState::Run : PlayerState::Idle;
-        }
     }
+    SDL_Texture* texture = captureCreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC,
+                                                RENDER_CHUNK_PIXELS, RENDER_CHUNK_PIXELS);
+    if (!texture) return nullptr;
+    captureUpdateTexture(texture, nullptr, pixels.data(), RENDER_CHUNK_PIXELS * sizeof(uint32_t));
+    captureTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    return texture;
+}
+
+// Section 12 – Live metrics for soak rigs (metrics_shm.h, --metrics)
+struct GameMetrics {
+    MetricsExport out;
+    int frameMs, tickMs;
+    int frames, ticks, crates, cratesAsleep, ropeParticles, cellsActive, terrainPending;
+    int texHitRate, texResidentKB, texEvictionsPerSecond, poolHitRate, sdlAllocs;
+    int liveBytes[(size_t)MemTag::Count];
 
-    void draw(SDL_Renderer* renderer, float scale, Vec2 cam) const {
-        SDL_Rect dst;
-        dst.x = (int)((position.x - cam.x) * scale);
-        dst.y = (int)((position.y - cam.y) * scale);
-        dst.w = (int)(PLAYER_W * scale);
-        dst.h = (int)(PLAYER_H * scale);
-        SDL_Surface* surface = SDL_CreateRGBSurfaceFrom(
-            (void*)PLAYER_PIXELS.data(),
-            PLAYER_W, PLAYER_H,
-            32,
-            PLAYER_W * sizeof(uint32_t),
-            0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
-        SDL_Texture* tex = SDL_CreateTextureFromSurface(renderer, surface);
-        SDL_FreeSurface(surface);
-        SDL_RenderCopy(renderer, tex, nullptr, &dst);
-        SDL_DestroyTexture(tex);
+    GameMetrics() {
+        frameMs = out.histogram("frame_ms", 1.0 / 64.0);
+        tickMs = out.histogram("tick_ms", 1.0 / 64.0);
+        frames = out.counter("frames");
+        ticks = out.counter("ticks");
+        crates = out.counter("crates");
+        cratesAsleep = out.counter("crates_asleep");
+        ropeParticles = out.counter("rope_particles");
+        cellsActive = out.counter("cell_chunks_active");
+        terrainPending = out.counter("terrain_chunks_pending");
+        texHitRate = out.counter("texture_hit_rate");
+        texResidentKB = out.counter("texture_resident_kb");
+        texEvictionsPerSecond = out.counter("texture_evictions_per_s");
+        poolHitRate = out.counter("sdl_pool_hit_rate");
+        sdlAllocs = out.counter("sdl_allocs");
+        for (size_t t = 0; t < (size_t)MemTag::Count; ++t) {
+            liveBytes[t] = out.counter((std::string("sdl_live_bytes_") + memTagName((MemTag)t)).c_str());
+        }
     }
 };
 
+// Section 4 – Input: sample the keyboard into the simulation's input struct
+PlayerInput readPlayerInput() {
+    const Uint8* keys = SDL_GetKeyboardState(nullptr);
+    PlayerInput input;
+    input.left  = keys[SDL_SCANCODE_LEFT] || keys[SDL_SCANCODE_A];
+    input.right = keys[SDL_SCANCODE_RIGHT] || keys[SDL_SCANCODE_D];
+    input.jump  = keys[SDL_SCANCODE_SPACE];
+    input.bomb  = keys[SDL_SCANCODE_X];
+    return input;
+}
+
+SDL_Texture* buildPlayerTexture(SDL_Renderer* renderer, const uint32_t* pixels) {
+    SDL_Texture* texture = captureCreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC,
+                                                PLAYER_W, PLAYER_H);
+    if (!texture) return nullptr;
+    captureUpdateTexture(texture, nullptr, pixels, PLAYER_W * sizeof(uint32_t));
+    captureTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    return texture;
+}
+
+void drawPlayer(SDL_Renderer* renderer, const Player& player, SDL_Texture* texture, float scale, const WorldPos& cam) {
+    if (!texture) return;
+    SDL_Rect dst;
+    dst.x = (int)(player.position.x.relativeTo(cam.x) * scale);
+    dst.y = (int)(player.position.y.relativeTo(cam.y) * scale);
+    dst.w = (int)(PLAYER_W * scale);
+    dst.h = (int)(PLAYER_H * scale);
+    captureCopy(renderer, texture, nullptr, &dst);
+}
+
 // Entry point
-int main(int, char**) {
+int main(int argc, char** argv) {
+    const TickRate tick = parseTickRate(argc, argv);
+    // Must precede every other SDL call (sdl_alloc.h)
+    if (!installSdlAllocator()) {
+        SDL_Log("SDL_SetMemoryFunctions failed; SDL allocations are not pooled");
+    }
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) != 0) {
         SDL_Log("SDL_Init failed: %s", SDL_GetError());
         return 1;
@@ -240,18 +193,74 @@ int main(int, char**) {
     std::unique_ptr<SDL_Window, decltype(&SDL_DestroyWindow)>
         window(SDL_CreateWindow("2D Platformer",
                                 SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
-                                NATIVE_W * 2, NATIVE_H * 2, SDL_WINDOW_SHOWN),
+                                NATIVE_W * 2, NATIVE_H * 2,
+                                SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI),
                &SDL_DestroyWindow);
     std::unique_ptr<SDL_Renderer, decltype(&SDL_DestroyRenderer)>
-        renderer(SDL_CreateRenderer(window.get(), -1, SDL_RENDERER_ACCELERATED),
+        renderer(SDL_CreateRenderer(window.get(), -1,
+                                    SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE),
                  &SDL_DestroyRenderer);
     if (!window || !renderer) {
         SDL_Log("Failed to create window or renderer");
         return 1;
     }
-    Player player;
-    player.position = { 100.0f, 100.0f };
-    Camera camera;
+    const char* capturePath = parseCapturePath(argc, argv);
+    if (capturePath && !renderCapture().open(capturePath)) {
+        SDL_Log("Failed to create render capture %s", capturePath);
+    }
+    AssetPack assets;
+    const char* assetPath = parseAssetPackPath(argc, argv);
+    if (!assets.open(assetPath) && std::strcmp(assetPath, ASSET_PACK_DEFAULT_PATH) != 0) {
+        SDL_Log("Failed to open asset pack %s", assetPath);
+    }
+    std::vector<uint32_t> playerSprite;
+    const uint32_t* playerPixels = loadPlayerSprite(assets, playerSprite);
+    RenderTarget target;
+    if (!target.create(renderer.get(), NATIVE_W, NATIVE_H)) {
+        return 1;
+    }
+    std::unique_ptr<GameWorld> world(new GameWorld);
+    world->reset();
+    // Rendering reads the simulation through these
+    Terrain& terrain = world->terrain;
+    const Player& player = world->player;
+    const Camera& camera = world->camera;
+    const CrateWorld& crates = world->crates;
+    const RopeWorld& ropes = world->ropes;
+    const CellWorld& cells = world->cells;
+    std::vector<uint32_t> rebuiltChunks;
+    Minimap minimap;
+    if (!minimap.create(renderer.get(), terrain.solidity)) {
+        return 1;
+    }
+    TextureCache textures;
+    textures.renderer = renderer.get();
+    textures.budgetBytes = TEXTURE_BUDGET_BYTES;
+    for (int cy = 0; cy < RENDER_CHUNKS_Y; ++cy) {
+        for (int cx = 0; cx < RENDER_CHUNKS_X; ++cx) {
+            textures.define(tileChunkKey(cx, cy), [&terrain, cx, cy](SDL_Renderer* r) { return buildTileChunk(r, terrain, cx, cy); });
+        }
+    }
+    textures.define(PLAYER_TEXTURE_KEY, [playerPixels](SDL_Renderer* r) { return buildPlayerTexture(r, playerPixels); });
+    StatsOverlay overlay;
+    const char* profilePrefix = parseProfilePrefix(argc, argv);
+    SamplingProfiler profiler;
+    if (profilePrefix && !profiler.start()) SDL_Log("Sampling profiler unavailable on this platform");
+    JobSystem jobs;
+    jobs.threadStart = [](unsigned) { SamplingProfiler::registerThread(); };
+    jobs.start();
+    std::vector<SDL_Point> ropePoints;
+    const char* recordPath = parseRecordPath(argc, argv);
+    ReplayWriter recorder;
+    recorder.tickHz = (uint16_t)tick.hz;
+    SpectatorServer spectators;
+    if (uint16_t port = parseSpectatePort(argc, argv)) {
+        if (!spectators.start(port, (uint16_t)tick.hz)) SDL_Log("Failed to listen for spectators on port %u", (unsigned)port);
+    }
+    GameMetrics metrics;
+    if (const char* metricsName = parseMetricsName(argc, argv)) {
+        if (!metrics.out.open(metricsName)) SDL_Log("Failed to create metrics segment %s", metricsName);
+    }
     bool running = true;
     float accumulator = 0.0f;
     Uint64 prevTicks = SDL_GetPerformanceCounter();
@@ -260,34 +269,193 @@ int main(int, char**) {
         float frameTime = (currentTicks - prevTicks) / (float)SDL_GetPerformanceFrequency();
         prevTicks = currentTicks;
         accumulator += frameTime;
-        SDL_Event ev;
-        while (SDL_PollEvent(&ev)) {
-            if (ev.type == SDL_QUIT) running = false;
+        {
+            MemTagScope tag(MemTag::Events);
+            SDL_Event ev;
+            while (SDL_PollEvent(&ev)) {
+                if (ev.type == SDL_QUIT) running = false;
+                if (ev.type == SDL_KEYDOWN && ev.key.keysym.sym == SDLK_F3) overlay.visible = !overlay.visible;
+                if (ev.type == SDL_RENDER_DEVICE_RESET) {
+                    textures.releaseAll();
+                    if (!minimap.deviceReset(renderer.get())) SDL_Log("Failed to recreate the minimap texture");
+                }
+                target.handleEvent(ev);
+            }
         }
-        while (accumulator >= FIXED_DT) {
-            player.update(FIXED_DT);
-            camera.update(player.position, FIXED_DT);
-            accumulator -= FIXED_DT;
+        while (accumulator >= tick.dt) {
+            const Uint64 tickStart = SDL_GetPerformanceCounter();
+            PlayerInput input = readPlayerInput();
+            if (recordPath) recorder.record(input);
+            spectators.publishInput(packInput(input));
+            world->step(input, tick.dt, &jobs);
+            minimap.discover(player.position.x.tile(TILE_SIZE, PLAYER_W * 0.5f),
+                             player.position.y.tile(TILE_SIZE, PLAYER_H * 0.5f), MINIMAP_REVEAL_TILES);
+            if (spectators.active() && world->tick % (uint32_t)tick.hz == 0) {
+                spectators.publishSnapshot(spectatorSnapshot(*world));
+            }
+            accumulator -= tick.dt;
+            if (metrics.out.active()) {
+                metrics.out.observe(metrics.tickMs, (SDL_GetPerformanceCounter() - tickStart) * 1000.0 /
+                                                        SDL_GetPerformanceFrequency());
+                metrics.out.add(metrics.ticks, 1.0);
+            }
         }
-        SDL_SetRenderDrawColor(renderer.get(), 92, 148, 252, 255);
-        SDL_RenderClear(renderer.get());
-        // Draw ground offset by camera
-        SDL_SetRenderDrawColor(renderer.get(), 70, 70, 70, 255);
-        for (int y = 0; y < LEVEL_HEIGHT; ++y) {
-            for (int x = 0; x < LEVEL_WIDTH; ++x) {
-                if (getTile(x, y) == 1) {
-                    SDL_Rect r;
-                    r.x = (int)((x * TILE_SIZE - camera.position.x) * 2);
-                    r.y = (int)((y * TILE_SIZE - camera.position.y) * 2);
-                    r.w = TILE_SIZE * 2;
-                    r.h = TILE_SIZE * 2;
-                    SDL_RenderFillRect(renderer.get(), &r);
-                }
+        spectators.flushInputs();
+        // Terrain edits: rebuild a bounded number of chunks, then refresh
+        // exactly those chunk textures and minimap areas
+        terrain.update();
+        terrain.takeRebuilt(rebuiltChunks);
+        for (uint32_t c : rebuiltChunks) {
+            TileRect area = terrain.chunkTiles((int)c);
+            textures.invalidate(tileChunkKey((int)c % terrain.chunksX, (int)c / terrain.chunksX));
+            minimap.markTilesDirty(area.x0, area.y0, area.x1, area.y1);
+        }
+        target.refresh();
+        target.begin();
+        captureDrawColor(renderer.get(), 92, 148, 252, 255);
+        captureClear(renderer.get());
+        // Draw the visible tile chunks offset by camera
+        textures.beginFrame(frameTime);
+        int firstCX = std::max(0, (int)std::floor(camera.position.x.pixels() / RENDER_CHUNK_PIXELS));
+        int firstCY = std::max(0, (int)std::floor(camera.position.y.pixels() / RENDER_CHUNK_PIXELS));
+        int lastCX = std::min(RENDER_CHUNKS_X - 1, (int)std::floor((camera.position.x.pixels() + NATIVE_W) / RENDER_CHUNK_PIXELS));
+        int lastCY = std::min(RENDER_CHUNKS_Y - 1, (int)std::floor((camera.position.y.pixels() + NATIVE_H) / RENDER_CHUNK_PIXELS));
+        for (int cy = firstCY; cy <= lastCY; ++cy) {
+            for (int cx = firstCX; cx <= lastCX; ++cx) {
+                SDL_Texture* chunk = textures.get(tileChunkKey(cx, cy));
+                if (!chunk) continue;
+                SDL_Rect r;
+                r.x = (int)std::floor(WorldCoord::fromTile(cx * RENDER_CHUNK_TILES, TILE_SIZE).relativeTo(camera.position.x));
+                r.y = (int)std::floor(WorldCoord::fromTile(cy * RENDER_CHUNK_TILES, TILE_SIZE).relativeTo(camera.position.y));
+                r.w = RENDER_CHUNK_PIXELS;
+                r.h = RENDER_CHUNK_PIXELS;
+                captureCopy(renderer.get(), chunk, nullptr, &r);
             }
         }
-        player.draw(renderer.get(), 2.0f, camera.position);
-        SDL_RenderPresent(renderer.get());
+        // Prefetch the chunks the camera is heading into
+        int aheadX = camera.velocity.x > PREFETCH_SPEED ? lastCX + 1 : (camera.velocity.x < -PREFETCH_SPEED ? firstCX - 1 : -1);
+        int aheadY = camera.velocity.y > PREFETCH_SPEED ? lastCY + 1 : (camera.velocity.y < -PREFETCH_SPEED ? firstCY - 1 : -1);
+        if (aheadX >= 0 && aheadX < RENDER_CHUNKS_X) {
+            for (int cy = firstCY; cy <= lastCY; ++cy) textures.prefetch(tileChunkKey(aheadX, cy));
+        }
+        if (aheadY >= 0 && aheadY < RENDER_CHUNKS_Y) {
+            for (int cx = firstCX; cx <= lastCX; ++cx) textures.prefetch(tileChunkKey(cx, aheadY));
+        }
+        // Coins not yet collected
+        captureDrawColor(renderer.get(), 255, 215, 0, 255);
+        for (int i = 0; i < COIN_COUNT; ++i) {
+            if (world->coins & (1u << i)) continue;
+            SDL_Rect r;
+            r.x = (int)std::floor(WorldCoord::fromTile(LEVEL_COINS[i].x, TILE_SIZE).relativeTo(camera.position.x)) + 4;
+            r.y = (int)std::floor(WorldCoord::fromTile(LEVEL_COINS[i].y, TILE_SIZE).relativeTo(camera.position.y)) + 4;
+            r.w = TILE_SIZE - 8;
+            r.h = TILE_SIZE - 8;
+            captureFillRect(renderer.get(), &r);
+        }
+        // Crates (Section 14)
+        captureDrawColor(renderer.get(), 150, 100, 50, 255);
+        for (size_t i = 0; i < crates.crateCount(); ++i) {
+            const PhysicsBodies& b = crates.physics.bodies;
+            SDL_Rect r;
+            r.x = (int)std::floor(crates.origin.worldX(b.x[i] - b.halfW[i]).relativeTo(camera.position.x));
+            r.y = (int)std::floor(crates.origin.worldY(b.y[i] - b.halfH[i]).relativeTo(camera.position.y));
+            r.w = (int)(b.halfW[i] * 2.0f);
+            r.h = (int)(b.halfH[i] * 2.0f);
+            captureFillRect(renderer.get(), &r);
+        }
+        // Armed bomb
+        if (terrain.bombArmed) {
+            captureDrawColor(renderer.get(), 120, 20, 20, 255);
+            SDL_Rect r;
+            r.x = (int)std::floor(terrain.bomb.x.relativeTo(camera.position.x)) - 4;
+            r.y = (int)std::floor(terrain.bomb.y.relativeTo(camera.position.y)) - 4;
+            r.w = r.h = 8;
+            captureFillRect(renderer.get(), &r);
+        }
+        // Ropes and bridges
+        captureDrawColor(renderer.get(), 200, 170, 110, 255);
+        for (const VerletRope& r : ropes.verlet.ropes) {
+            ropePoints.clear();
+            for (uint32_t k = r.first; k < r.first + r.count; ++k) {
+                ropePoints.push_back({ (int)std::floor(ropes.origin.worldX(ropes.verlet.x[k]).relativeTo(camera.position.x)),
+                                       (int)std::floor(ropes.origin.worldY(ropes.verlet.y[k]).relativeTo(camera.position.y)) });
+            }
+            captureDrawLines(renderer.get(), ropePoints.data(), (int)ropePoints.size());
+        }
+        {
+            MemTagScope tag(MemTag::Surface);
+            drawPlayer(renderer.get(), player, textures.get(PLAYER_TEXTURE_KEY), 1.0f, camera.position);
+        }
+        // Minimap: only chunks with new terrain or newly discovered area are re-uploaded
+        minimap.update();
+        for (int i = 0; i < COIN_COUNT; ++i) {
+            if (!(world->coins & (1u << i))) minimap.addMarker(MinimapMarker::Pickup, LEVEL_COINS[i].x, LEVEL_COINS[i].y);
+        }
+        minimap.addMarker(MinimapMarker::Player, player.position.x.tile(TILE_SIZE, PLAYER_W * 0.5f),
+                          player.position.y.tile(TILE_SIZE, PLAYER_H * 0.5f));
+        minimap.draw(renderer.get(), NATIVE_W - minimap.width * MINIMAP_SCALE - 4, 4, MINIMAP_SCALE);
+        // Stats overlay (F3)
+        overlay.print("FRAME %.1f MS", frameTime * 1000.0f);
+        overlay.print("TEX %zu/%zu KB HIT %.1f%% EVICT/S %.1f", textures.residentBytes >> 10,
+                      textures.budgetBytes >> 10, textures.stats.hitRate * 100.0f, textures.stats.evictionsPerSecond);
+        overlay.print("TERRAIN RECTS %zu NAV %zu/%zu PENDING %zu", terrain.rectCount, terrain.nav.nodeCount,
+                      terrain.nav.edgeTotal, terrain.pending());
+        overlay.print("BODIES %zu SLEEP %u", crates.crateCount(), crates.physics.sleepingBodies);
+        overlay.print("CELLS ACTIVE %zu CHANGED %zu", cells.activeChunks, cells.changedChunks);
+        overlay.print("SDL POOL REUSE %.1f%%", sdlAllocator().poolHitRate() * 100.0);
+        if (spectators.active()) {
+            overlay.print("SPECTATORS %u PORT %u", spectators.clients.load(std::memory_order_relaxed), (unsigned)spectators.port);
+        }
+        overlay.draw(renderer.get(), 4, 4, 1);
+        {
+            MemTagScope tag(MemTag::Render);
+            target.present();
+        }
+        if (metrics.out.active()) {
+            MetricsExport& m = metrics.out;
+            m.observe(metrics.frameMs, frameTime * 1000.0);
+            m.add(metrics.frames, 1.0);
+            m.set(metrics.crates, (double)crates.crateCount());
+            m.set(metrics.cratesAsleep, crates.physics.sleepingBodies);
+            m.set(metrics.ropeParticles, (double)ropes.verlet.particleCount());
+            m.set(metrics.cellsActive, (double)cells.activeChunks);
+            m.set(metrics.terrainPending, (double)terrain.pending());
+            m.set(metrics.texHitRate, textures.stats.hitRate);
+            m.set(metrics.texResidentKB, (double)(textures.residentBytes >> 10));
+            m.set(metrics.texEvictionsPerSecond, textures.stats.evictionsPerSecond);
+            const PoolAllocator& pool = sdlAllocator();
+            m.set(metrics.poolHitRate, pool.poolHitRate());
+            uint64_t allocs = 0;
+            for (size_t t = 0; t < (size_t)MemTag::Count; ++t) {
+                allocs += pool.tags[t].allocs.load(std::memory_order_relaxed);
+                m.set(metrics.liveBytes[t], (double)pool.tags[t].liveBytes.load(std::memory_order_relaxed));
+            }
+            m.set(metrics.sdlAllocs, (double)allocs);
+            m.publish();
+        }
+        profiler.drain();
+    }
+    if (profilePrefix) {
+        profiler.stop();
+        std::string prefix = profilePrefix;
+        if (!profiler.writeFolded((prefix + ".folded").c_str()) ||
+            !profiler.writeFlameGraph((prefix + ".svg").c_str(), "platformer")) {
+            SDL_Log("Failed to write profile %s", profilePrefix);
+        }
+    }
+    if (recordPath && !recorder.save(recordPath)) {
+        SDL_Log("Failed to write replay %s", recordPath);
+    }
+    spectators.stop();
+    if (capturePath && !renderCapture().close()) {
+        SDL_Log("Failed to write render capture %s", capturePath);
     }
+    textures.destroy();
+    minimap.destroy();
+    target.destroy();
+    renderer.reset();
+    window.reset();
     SDL_Quit();
+    if (parseAllocReport(argc, argv)) sdlAllocator().report(stdout);
     return 0;
 }
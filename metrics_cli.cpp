@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+#include "metrics_shm.h"
+
+// Live Metrics Viewer (Section 12 – HUD / Debug)
+// Attaches read-only to a game's metrics segment (metrics_shm.h; start the
+// game with --metrics or --metrics=NAME) and shows it every interval:
+//   default  a table of counters (value and rate per second) and, for each
+//            histogram, the samples, mean, p50, p99 and max of the interval
+//   --graph  a scrolling bar graph of one counter or histogram mean
+//   --csv    one line per interval, for logging on soak rigs
+//   --once   print one table and exit
+// Waits for the segment to appear, and re-attaches when the game restarts
+// or dies mid-publish (no publish, or no consistent read, for two seconds);
+// --csv repeats its header after re-attaching, as the counters may differ.
+// Never writes to the segment.
+//
+// Build: g++ -O2 -std=c++17 metrics_cli.cpp -o metrics_cli   (add -lrt on old glibc)
+// Usage: metrics_cli [name] [-i ms] [--graph metric] [--csv] [--once]
+
+constexpr int GRAPH_ROWS = 12;
+constexpr int GRAPH_COLS = 72;
+constexpr double STALE_SECONDS = 2.0;   // no publish (or no consistent read) for this long: re-attach
+
+// Bucket upper bound below which `fraction` of the interval's samples fall
+static double percentile(const uint64_t* delta, uint64_t total, double base, double fraction) {
+    if (total == 0) return 0.0;
+    uint64_t target = (uint64_t)std::ceil(total * fraction), seen = 0;
+    for (int b = 0; b < METRICS_BUCKETS; ++b) {
+        seen += delta[b];
+        if (seen >= target) return base * std::ldexp(1.0, b);
+    }
+    return base * std::ldexp(1.0, METRICS_BUCKETS - 1);
+}
+
+struct IntervalStats {
+    uint64_t samples;
+    double mean, p50, p99, max;
+};
+
+static IntervalStats interval(const MetricsSnapshot::Histogram& now, const MetricsSnapshot::Histogram* prev) {
+    uint64_t delta[METRICS_BUCKETS];
+    for (int b = 0; b < METRICS_BUCKETS; ++b) delta[b] = now.buckets[b] - (prev ? prev->buckets[b] : 0);
+    IntervalStats s;
+    s.samples = now.count - (prev ? prev->count : 0);
+    s.mean = s.samples ? (now.sum - (prev ? prev->sum : 0.0)) / s.samples : 0.0;
+    s.p50 = percentile(delta, s.samples, now.base, 0.50);
+    s.p99 = percentile(delta, s.samples, now.base, 0.99);
+    s.max = now.max;    // running maximum since start
+    return s;
+}
+
+static const MetricsSnapshot::Histogram* findHistogram(const MetricsSnapshot& s, const std::string& name) {
+    for (const MetricsSnapshot::Histogram& h : s.histograms) {
+        if (h.name == name) return &h;
+    }
+    return nullptr;
+}
+
+static void printTable(const MetricsSnapshot& now, const MetricsSnapshot* prev, double seconds) {
+    std::printf("pid %llu  publish %llu  (%.1f/s)\n", (unsigned long long)now.pid,
+                (unsigned long long)now.publishCount,
+                prev && seconds > 0.0 ? (now.publishCount - prev->publishCount) / seconds : 0.0);
+    std::printf("%-28s %14s %14s\n", "counter", "value", "per second");
+    for (size_t i = 0; i < now.counters.size(); ++i) {
+        double rate = prev && i < prev->counters.size() && seconds > 0.0 ? (now.counters[i] - prev->counters[i]) / seconds : 0.0;
+        std::printf("%-28s %14.3f %14.3f\n", now.counterNames[i].c_str(), now.counters[i], rate);
+    }
+    std::printf("%-28s %10s %10s %10s %10s %10s\n", "histogram", "samples", "mean", "p50<=", "p99<=", "max");
+    for (const MetricsSnapshot::Histogram& h : now.histograms) {
+        IntervalStats s = interval(h, prev ? findHistogram(*prev, h.name) : nullptr);
+        std::printf("%-28s %10llu %10.3f %10.3f %10.3f %10.3f\n", h.name.c_str(), (unsigned long long)s.samples,
+                    s.mean, s.p50, s.p99, s.max);
+    }
+}
+
+// Counter value, or the interval mean of a histogram; false if unknown
+static bool sample(const MetricsSnapshot& now, const MetricsSnapshot* prev, const std::string& name, double& out) {
+    for (size_t i = 0; i < now.counters.size(); ++i) {
+        if (now.counterNames[i] == name) { out = now.counters[i]; return true; }
+    }
+    if (const MetricsSnapshot::Histogram* h = findHistogram(now, name)) {
+        out = interval(*h, prev ? findHistogram(*prev, name) : nullptr).mean;
+        return true;
+    }
+    return false;
+}
+
+static void printGraph(const std::string& name, const std::deque<double>& history) {
+    double lo = *std::min_element(history.begin(), history.end());
+    double hi = *std::max_element(history.begin(), history.end());
+    if (hi - lo < 1e-9) hi = lo + 1.0;
+    std::printf("%s  now %.3f  min %.3f  max %.3f\n", name.c_str(), history.back(), lo, hi);
+    for (int row = GRAPH_ROWS - 1; row >= 0; --row) {
+        double level = lo + (hi - lo) * (row + 0.5) / GRAPH_ROWS;
+        std::printf("%10.3f |", lo + (hi - lo) * (row + 1) / GRAPH_ROWS);
+        for (double v : history) std::putchar(v >= level ? '#' : ' ');
+        std::putchar('\n');
+    }
+    std::printf("%10s +%s\n", "", std::string(history.size(), '-').c_str());
+}
+
+int main(int argc, char** argv) {
+    const char* name = METRICS_DEFAULT_NAME;
+    int intervalMs = 500;
+    const char* graph = nullptr;
+    bool csv = false, once = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-i") == 0 && i + 1 < argc) intervalMs = std::max(10, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--graph") == 0 && i + 1 < argc) graph = argv[++i];
+        else if (std::strcmp(argv[i], "--csv") == 0) csv = true;
+        else if (std::strcmp(argv[i], "--once") == 0) once = true;
+        else if (argv[i][0] != '-') name = argv[i];
+        else {
+            std::fprintf(stderr, "usage: %s [name] [-i ms] [--graph metric] [--csv] [--once]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    MetricsReader reader;
+    MetricsSnapshot now, prev;
+    bool havePrev = false, headerDone = false;
+    std::deque<double> history;
+    auto lastChange = std::chrono::steady_clock::now();
+    auto prevTime = lastChange;
+    for (bool waiting = false;;) {
+        if (!reader.shm.segment) {
+            if (!reader.attach(name)) {
+                if (once) {
+                    std::fprintf(stderr, "no metrics segment %s\n", name);
+                    return 1;
+                }
+                if (!waiting) std::fprintf(stderr, "waiting for %s...\n", name);
+                waiting = true;
+                std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+                continue;
+            }
+            waiting = false;
+            havePrev = false;
+            headerDone = false;
+            history.clear();
+            lastChange = std::chrono::steady_clock::now();
+        }
+        const bool consistent = reader.read(now);
+        auto t = std::chrono::steady_clock::now();
+        const double seconds = std::chrono::duration<double>(t - prevTime).count();
+        if (consistent && havePrev && now.publishCount != prev.publishCount) lastChange = t;
+        if (std::chrono::duration<double>(t - lastChange).count() > STALE_SECONDS) {
+            // Publisher gone, restarted, or died mid-publish leaving seq odd:
+            // the old mapping stays valid but dead
+            reader.shm.close();
+            continue;
+        }
+        if (!consistent) {
+            if (once) {
+                std::fprintf(stderr, "no consistent read of %s\n", name);
+                return 1;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+            continue;
+        }
+
+        if (csv) {
+            if (!headerDone) {
+                std::printf("publish");
+                for (const std::string& n : now.counterNames) std::printf(",%s", n.c_str());
+                for (const MetricsSnapshot::Histogram& h : now.histograms) {
+                    std::printf(",%s.mean,%s.p99", h.name.c_str(), h.name.c_str());
+                }
+                std::printf("\n");
+                headerDone = true;
+            }
+            std::printf("%llu", (unsigned long long)now.publishCount);
+            for (double v : now.counters) std::printf(",%.6g", v);
+            for (const MetricsSnapshot::Histogram& h : now.histograms) {
+                IntervalStats s = interval(h, havePrev ? findHistogram(prev, h.name) : nullptr);
+                std::printf(",%.6g,%.6g", s.mean, s.p99);
+            }
+            std::printf("\n");
+        } else if (graph) {
+            double v;
+            if (!sample(now, havePrev ? &prev : nullptr, graph, v)) {
+                std::fprintf(stderr, "no counter or histogram named %s\n", graph);
+                return 1;
+            }
+            history.push_back(v);
+            if (history.size() > (size_t)GRAPH_COLS) history.pop_front();
+            std::printf("\x1b[H\x1b[2J");
+            printGraph(graph, history);
+        } else {
+            if (!once) std::printf("\x1b[H\x1b[2J");
+            printTable(now, havePrev ? &prev : nullptr, seconds);
+        }
+        std::fflush(stdout);
+        if (once) return 0;
+        std::swap(prev, now);
+        havePrev = true;
+        prevTime = t;
+        std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+    }
+}
@@ -0,0 +1,363 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//----------------------------------------------------------------------------
+// Live Metrics Export (Section 12 – HUD / Debug)
+//----------------------------------------------------------------------------
+// Counters and histograms published into a named shared-memory segment
+// (POSIX shm_open, a named file mapping on Windows), so tools such as
+// metrics_cli can watch a running game without touching it.
+//
+// The game fills a private staging copy during the frame (set(), add(),
+// observe()) and publish() copies it into the segment under a seqlock:
+// the sequence number goes odd, the values are stored, it goes even again.
+// That is a fixed number of stores with no locks, retries or syscalls, so
+// publishing is wait-free however many readers are attached.  A reader
+// copies the values between two reads of the sequence number and retries
+// if a publish overlapped (odd, or changed).  Every shared word is a
+// lock-free std::atomic, which is address-free and so valid across
+// processes.
+//
+// Names live outside the seqlock.  A name is written before its count is
+// released, and names never change, so a reader that loads the count with
+// acquire can read that many names at any time.  Counters are doubles;
+// histograms count values into power-of-two buckets above a per-histogram
+// base (bucket 0 is below base, bucket i covers [base·2^(i-1), base·2^i))
+// and are cumulative since start, so readers take deltas.
+//
+
+constexpr uint32_t METRICS_MAGIC          = 0x5254454Du;   // "METR"
+constexpr uint32_t METRICS_VERSION        = 1;
+constexpr int      METRICS_MAX_COUNTERS   = 64;
+constexpr int      METRICS_MAX_HISTOGRAMS = 8;
+constexpr int      METRICS_BUCKETS        = 32;
+constexpr int      METRICS_NAME_BYTES     = 32;
+constexpr const char* METRICS_DEFAULT_NAME = "/platformer-metrics";
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "metrics need lock-free 64-bit atomics");
+
+inline uint64_t metricsBits(double v) {
+    uint64_t u;
+    std::memcpy(&u, &v, sizeof(u));
+    return u;
+}
+
+inline double metricsDouble(uint64_t u) {
+    double v;
+    std::memcpy(&v, &u, sizeof(v));
+    return v;
+}
+
+struct MetricsHistogramSlot {
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sum;       // double bits
+    std::atomic<uint64_t> max;       // double bits
+    std::atomic<uint64_t> buckets[METRICS_BUCKETS];
+};
+
+struct MetricsSegment {
+    // Written once; magic last, with release
+    std::atomic<uint32_t> magic;
+    uint32_t version;
+    uint64_t pid;
+    std::atomic<uint32_t> counterCount;
+    std::atomic<uint32_t> histogramCount;
+    char counterNames[METRICS_MAX_COUNTERS][METRICS_NAME_BYTES];
+    char histogramNames[METRICS_MAX_HISTOGRAMS][METRICS_NAME_BYTES];
+    double histogramBase[METRICS_MAX_HISTOGRAMS];
+    // Seqlock-protected values, on their own cache lines
+    alignas(64) std::atomic<uint64_t> seq;
+    std::atomic<uint64_t> publishCount;
+    std::atomic<uint64_t> timestampNs;    // steady clock at publish
+    std::atomic<uint64_t> counters[METRICS_MAX_COUNTERS];
+    MetricsHistogramSlot histograms[METRICS_MAX_HISTOGRAMS];
+};
+
+// Shared-memory mapping; the publisher creates (and finally unlinks) the
+// segment, readers attach read-only.
+struct MetricsMapping {
+    MetricsSegment* segment{ nullptr };
+    std::string name;
+    bool owner{ false };
+#if defined(_WIN32)
+    HANDLE mapping{ nullptr };
+#endif
+
+    MetricsMapping() = default;
+    MetricsMapping(const MetricsMapping&) = delete;
+    MetricsMapping& operator=(const MetricsMapping&) = delete;
+    ~MetricsMapping() { close(); }
+
+    bool create(const char* segmentName) {
+        close();
+        const size_t size = sizeof(MetricsSegment);
+#if defined(_WIN32)
+        mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, (DWORD)size, segmentName);
+        if (!mapping) return false;
+        void* p = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+        if (!p) { close(); return false; }
+        std::memset(p, 0, size);
+#else
+        // A stale segment from a crashed run is replaced, not reused
+        shm_unlink(segmentName);
+        int fd = shm_open(segmentName, O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0) return false;
+        if (ftruncate(fd, (off_t)size) != 0) { ::close(fd); shm_unlink(segmentName); return false; }
+        void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) { shm_unlink(segmentName); return false; }
+#endif
+        segment = new (p) MetricsSegment();
+        name = segmentName;
+        owner = true;
+        return true;
+    }
+
+    bool attach(const char* segmentName) {
+        close();
+        const size_t size = sizeof(MetricsSegment);
+#if defined(_WIN32)
+        mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, segmentName);
+        if (!mapping) return false;
+        void* p = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+        if (!p) { close(); return false; }
+#else
+        int fd = shm_open(segmentName, O_RDONLY, 0);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < size) { ::close(fd); return false; }
+        void* p = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+#endif
+        segment = (MetricsSegment*)p;
+        name = segmentName;
+        owner = false;
+        if (segment->magic.load(std::memory_order_acquire) != METRICS_MAGIC || segment->version != METRICS_VERSION) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (segment) {
+#if defined(_WIN32)
+            UnmapViewOfFile(segment);
+#else
+            munmap((void*)segment, sizeof(MetricsSegment));
+            if (owner) shm_unlink(name.c_str());
+#endif
+        }
+#if defined(_WIN32)
+        if (mapping) CloseHandle(mapping);
+        mapping = nullptr;
+#endif
+        segment = nullptr;
+        owner = false;
+    }
+};
+
+// Game side.  Register metrics, then per frame update and publish().
+// Everything but publish() only touches the staging copy.
+struct MetricsExport {
+    struct Histogram {
+        double base{ 1.0 };
+        uint64_t count{ 0 };
+        double sum{ 0.0 };
+        double max{ 0.0 };
+        uint64_t buckets[METRICS_BUCKETS]{};
+    };
+
+    MetricsMapping shm;
+    int counterCount{ 0 };
+    int histogramCount{ 0 };
+    double counters[METRICS_MAX_COUNTERS]{};
+    Histogram histograms[METRICS_MAX_HISTOGRAMS];
+    std::string counterNames[METRICS_MAX_COUNTERS];
+    std::string histogramNames[METRICS_MAX_HISTOGRAMS];
+    uint64_t publishCount{ 0 };
+
+    bool open(const char* segmentName) {
+        if (!shm.create(segmentName)) return false;
+        MetricsSegment* s = shm.segment;
+        s->version = METRICS_VERSION;
+#if defined(_WIN32)
+        s->pid = (uint64_t)GetCurrentProcessId();
+#else
+        s->pid = (uint64_t)getpid();
+#endif
+        for (int i = 0; i < counterCount; ++i) exportCounterName(i);
+        for (int i = 0; i < histogramCount; ++i) exportHistogramName(i);
+        s->magic.store(METRICS_MAGIC, std::memory_order_release);
+        return true;
+    }
+
+    bool active() const { return shm.segment != nullptr; }
+
+    // Register a counter; returns its id, or -1 when full.  Names longer
+    // than METRICS_NAME_BYTES - 1 are cut.
+    int counter(const char* name) {
+        if (counterCount == METRICS_MAX_COUNTERS) return -1;
+        counterNames[counterCount] = name;
+        if (active()) exportCounterName(counterCount);
+        return counterCount++;
+    }
+
+    // Register a histogram with bucket 1 starting at `base`.
+    int histogram(const char* name, double base) {
+        if (histogramCount == METRICS_MAX_HISTOGRAMS) return -1;
+        histogramNames[histogramCount] = name;
+        histograms[histogramCount].base = base;
+        if (active()) exportHistogramName(histogramCount);
+        return histogramCount++;
+    }
+
+    void set(int id, double value) { if (id >= 0) counters[id] = value; }
+    void add(int id, double value) { if (id >= 0) counters[id] += value; }
+
+    void observe(int id, double value) {
+        if (id < 0) return;
+        Histogram& h = histograms[id];
+        ++h.count;
+        h.sum += value;
+        h.max = std::max(h.max, value);
+        int b = 0;
+        if (value >= h.base) b = std::min(METRICS_BUCKETS - 1, 1 + (int)std::floor(std::log2(value / h.base)));
+        ++h.buckets[b];
+    }
+
+    // Wait-free: stores only.
+    void publish() {
+        MetricsSegment* s = shm.segment;
+        if (!s) return;
+        const uint64_t seq = s->seq.load(std::memory_order_relaxed);
+        s->seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        s->publishCount.store(++publishCount, std::memory_order_relaxed);
+        s->timestampNs.store((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                 std::chrono::steady_clock::now().time_since_epoch()).count(),
+                             std::memory_order_relaxed);
+        for (int i = 0; i < counterCount; ++i) s->counters[i].store(metricsBits(counters[i]), std::memory_order_relaxed);
+        for (int i = 0; i < histogramCount; ++i) {
+            const Histogram& h = histograms[i];
+            MetricsHistogramSlot& out = s->histograms[i];
+            out.count.store(h.count, std::memory_order_relaxed);
+            out.sum.store(metricsBits(h.sum), std::memory_order_relaxed);
+            out.max.store(metricsBits(h.max), std::memory_order_relaxed);
+            for (int b = 0; b < METRICS_BUCKETS; ++b) out.buckets[b].store(h.buckets[b], std::memory_order_relaxed);
+        }
+        s->seq.store(seq + 2, std::memory_order_release);
+    }
+
+    void close() { shm.close(); }
+
+    void exportCounterName(int i) {
+        MetricsSegment* s = shm.segment;
+        std::strncpy(s->counterNames[i], counterNames[i].c_str(), METRICS_NAME_BYTES - 1);
+        s->counterCount.store((uint32_t)i + 1, std::memory_order_release);
+    }
+
+    void exportHistogramName(int i) {
+        MetricsSegment* s = shm.segment;
+        std::strncpy(s->histogramNames[i], histogramNames[i].c_str(), METRICS_NAME_BYTES - 1);
+        s->histogramBase[i] = histograms[i].base;
+        s->histogramCount.store((uint32_t)i + 1, std::memory_order_release);
+    }
+};
+
+// Tool side: a consistent copy of one publish.
+struct MetricsSnapshot {
+    struct Histogram {
+        std::string name;
+        double base;
+        uint64_t count;
+        double sum;
+        double max;
+        uint64_t buckets[METRICS_BUCKETS];
+    };
+    uint64_t pid{ 0 };
+    uint64_t publishCount{ 0 };
+    uint64_t timestampNs{ 0 };
+    std::vector<std::string> counterNames;
+    std::vector<double> counters;
+    std::vector<Histogram> histograms;
+};
+
+struct MetricsReader {
+    MetricsMapping shm;
+    uint64_t retries{ 0 };      // snapshots that overlapped a publish
+
+    bool attach(const char* segmentName) { return shm.attach(segmentName); }
+
+    // Returns false if no consistent copy was had within `maxAttempts`
+    // (the publisher never blocks, so this only happens under heavy load).
+    bool read(MetricsSnapshot& out, int maxAttempts = 1000) {
+        const MetricsSegment* s = shm.segment;
+        if (!s) return false;
+        const uint32_t nc = std::min<uint32_t>(s->counterCount.load(std::memory_order_acquire), METRICS_MAX_COUNTERS);
+        const uint32_t nh = std::min<uint32_t>(s->histogramCount.load(std::memory_order_acquire), METRICS_MAX_HISTOGRAMS);
+        out.pid = s->pid;
+        out.counterNames.resize(nc);
+        for (uint32_t i = 0; i < nc; ++i) out.counterNames[i].assign(s->counterNames[i], strnlen(s->counterNames[i], METRICS_NAME_BYTES));
+        out.counters.resize(nc);
+        out.histograms.resize(nh);
+        for (uint32_t i = 0; i < nh; ++i) {
+            out.histograms[i].name.assign(s->histogramNames[i], strnlen(s->histogramNames[i], METRICS_NAME_BYTES));
+            out.histograms[i].base = s->histogramBase[i];
+        }
+        for (int attempt = 0; attempt < maxAttempts; ++attempt) {
+            const uint64_t before = s->seq.load(std::memory_order_acquire);
+            if (before & 1) {
+                ++retries;
+                continue;
+            }
+            out.publishCount = s->publishCount.load(std::memory_order_relaxed);
+            out.timestampNs = s->timestampNs.load(std::memory_order_relaxed);
+            for (uint32_t i = 0; i < nc; ++i) out.counters[i] = metricsDouble(s->counters[i].load(std::memory_order_relaxed));
+            for (uint32_t i = 0; i < nh; ++i) {
+                const MetricsHistogramSlot& h = s->histograms[i];
+                MetricsSnapshot::Histogram& o = out.histograms[i];
+                o.count = h.count.load(std::memory_order_relaxed);
+                o.sum = metricsDouble(h.sum.load(std::memory_order_relaxed));
+                o.max = metricsDouble(h.max.load(std::memory_order_relaxed));
+                for (int b = 0; b < METRICS_BUCKETS; ++b) o.buckets[b] = h.buckets[b].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (s->seq.load(std::memory_order_relaxed) == before) return true;
+            ++retries;
+        }
+        return false;
+    }
+};
+
+// "--metrics" publishes under METRICS_DEFAULT_NAME, "--metrics=NAME" under
+// NAME.  Returns nullptr if not given.
+inline const char* parseMetricsName(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--metrics=", 10) == 0) return argv[i] + 10;
+        if (std::strcmp(argv[i], "--metrics") == 0) return METRICS_DEFAULT_NAME;
+    }
+    return nullptr;
+}
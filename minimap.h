@@ -0,0 +1,225 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "render_capture.h"
+#include "solidity.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MINIMAP_HAS_SSE2 1
+#endif
+
+//----------------------------------------------------------------------------
+// Minimap (Section 12 – HUD)
+//----------------------------------------------------------------------------
+// Each minimap pixel covers MINIMAP_FACTOR × MINIMAP_FACTOR tiles and is
+// shaded by how many of them are solid.  The pixels come straight from the
+// solidity bitmap: two bitmap rows are expanded to bytes, summed and folded
+// pairwise with SSE2, 32 tiles (16 pixels) per step, and written to a
+// texture that lives for the whole level.
+//
+// The texture is split into chunks of MINIMAP_CHUNK_TILES².  Only chunks that
+// were marked dirty (terrain edits via markTilesDirty) or gained discovered
+// pixels (discover) are rebuilt and uploaded in update(); a frame with no
+// changes costs nothing.  Undiscovered pixels are fully transparent.  After
+// SDL_RENDER_DEVICE_RESET, deviceReset() recreates the texture and rebuilds
+// every chunk from the bitmap and the discovered mask, which live in memory.
+//
+// Entity markers are collected into per-kind rect arrays each frame and
+// drawn with one SDL_RenderFillRects call per kind after the map texture.
+//
+
+constexpr int MINIMAP_FACTOR      = 2;    // tiles per minimap pixel, each axis
+constexpr int MINIMAP_CHUNK_TILES = 32;   // tiles per chunk edge; one SIMD step wide
+constexpr int MINIMAP_CHUNK_PIXELS = MINIMAP_CHUNK_TILES / MINIMAP_FACTOR;
+
+enum class MinimapMarker : uint8_t {
+    Player,
+    Enemy,
+    Pickup,
+    Count
+};
+
+struct Minimap {
+    const SolidityBitmap* tiles{ nullptr };
+    SDL_Texture* texture{ nullptr };
+    int width{ 0 }, height{ 0 };              // minimap pixels actually covered by the level
+    int chunksX{ 0 }, chunksY{ 0 };
+    std::vector<uint8_t> discovered;          // 0x00 / 0xFF per pixel, chunk-padded rows
+    std::vector<uint8_t> dirty;               // per chunk
+    std::vector<uint32_t> staging;            // one chunk of ARGB pixels
+    std::array<std::vector<SDL_Rect>, (size_t)MinimapMarker::Count> markers;
+    uint64_t chunksUploaded{ 0 };
+
+    static constexpr SDL_Color MARKER_COLORS[(size_t)MinimapMarker::Count] = {
+        { 255, 255, 255, 255 }, { 230, 60, 60, 255 }, { 255, 215, 0, 255 }
+    };
+
+    int stride() const { return chunksX * MINIMAP_CHUNK_PIXELS; }
+
+    bool create(SDL_Renderer* renderer, const SolidityBitmap& bitmap) {
+        destroy();
+        tiles = &bitmap;
+        width  = (bitmap.width  + MINIMAP_FACTOR - 1) / MINIMAP_FACTOR;
+        height = (bitmap.height + MINIMAP_FACTOR - 1) / MINIMAP_FACTOR;
+        chunksX = (bitmap.width  + MINIMAP_CHUNK_TILES - 1) / MINIMAP_CHUNK_TILES;
+        chunksY = (bitmap.height + MINIMAP_CHUNK_TILES - 1) / MINIMAP_CHUNK_TILES;
+        discovered.assign((size_t)stride() * chunksY * MINIMAP_CHUNK_PIXELS, 0);
+        dirty.assign((size_t)chunksX * chunksY, 1);
+        staging.resize((size_t)MINIMAP_CHUNK_PIXELS * MINIMAP_CHUNK_PIXELS);
+        return createTexture(renderer);
+    }
+
+    void destroy() {
+        if (texture) captureDestroyTexture(texture);
+        texture = nullptr;
+    }
+
+    // The renderer lost every texture: make a new one and re-upload it all.
+    bool deviceReset(SDL_Renderer* renderer) {
+        destroy();
+        std::fill(dirty.begin(), dirty.end(), (uint8_t)1);
+        return createTexture(renderer);
+    }
+
+    bool createTexture(SDL_Renderer* renderer) {
+        texture = captureCreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC,
+                                       chunksX * MINIMAP_CHUNK_PIXELS, chunksY * MINIMAP_CHUNK_PIXELS);
+        if (!texture) return false;
+        captureTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        return true;
+    }
+
+    // Tiles in [x0, x1] × [y0, y1] changed solidity.
+    void markTilesDirty(int x0, int y0, int x1, int y1) {
+        int cx0 = std::max(0, x0 / MINIMAP_CHUNK_TILES), cx1 = std::min(chunksX - 1, x1 / MINIMAP_CHUNK_TILES);
+        int cy0 = std::max(0, y0 / MINIMAP_CHUNK_TILES), cy1 = std::min(chunksY - 1, y1 / MINIMAP_CHUNK_TILES);
+        for (int cy = cy0; cy <= cy1; ++cy)
+            for (int cx = cx0; cx <= cx1; ++cx) dirty[(size_t)cy * chunksX + cx] = 1;
+    }
+
+    // Reveal a square of minimap pixels around a tile position.
+    void discover(int tileX, int tileY, int radiusTiles) {
+        int px = tileX / MINIMAP_FACTOR, py = tileY / MINIMAP_FACTOR, r = radiusTiles / MINIMAP_FACTOR;
+        int x0 = std::max(0, px - r), x1 = std::min(width - 1, px + r);
+        int y0 = std::max(0, py - r), y1 = std::min(height - 1, py + r);
+        for (int y = y0; y <= y1; ++y) {
+            uint8_t* row = &discovered[(size_t)y * stride()];
+            for (int x = x0; x <= x1; ++x) {
+                if (row[x]) continue;
+                row[x] = 0xFF;
+                dirty[(size_t)(y / MINIMAP_CHUNK_PIXELS) * chunksX + x / MINIMAP_CHUNK_PIXELS] = 1;
+            }
+        }
+    }
+
+    // 32 tiles of row `y` starting at chunk column `cx` (0 past the map edge).
+    uint32_t rowBits(int cx, int y) const {
+        if (y >= tiles->height) return 0;
+        int x = cx * MINIMAP_CHUNK_TILES;
+        uint64_t word = tiles->words[(size_t)y * tiles->wordsPerRow + (x >> 6)];
+        uint32_t bits = (uint32_t)(word >> (x & 63));
+        int valid = tiles->width - x;
+        return valid >= 32 ? bits : bits & ((1u << valid) - 1);
+    }
+
+#if defined(MINIMAP_HAS_SSE2)
+    // Byte i = 0xFF if bit i of `bits` is set
+    static __m128i expandBits(uint16_t bits) {
+        const __m128i select = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, (char)128,
+                                             1, 2, 4, 8, 16, 32, 64, (char)128);
+        __m128i v = _mm_unpacklo_epi64(_mm_set1_epi8((char)(bits & 0xFF)), _mm_set1_epi8((char)(bits >> 8)));
+        return _mm_cmpeq_epi8(_mm_and_si128(v, select), select);
+    }
+
+    // 16 tiles from each of two rows -> 8 coverage counts (0..4) in 16-bit lanes
+    static __m128i coverage8(uint16_t top, uint16_t bottom) {
+        const __m128i one = _mm_set1_epi8(1);
+        __m128i sum = _mm_add_epi8(_mm_and_si128(expandBits(top), one), _mm_and_si128(expandBits(bottom), one));
+        return _mm_add_epi16(_mm_and_si128(sum, _mm_set1_epi16(0x00FF)), _mm_srli_epi16(sum, 8));
+    }
+#endif
+
+    // Shade 16 pixels from two 32-tile rows; `alpha` is 16 discovered bytes.
+    static void shadeRow(uint32_t top, uint32_t bottom, const uint8_t* alpha, uint32_t* out) {
+#if defined(MINIMAP_HAS_SSE2)
+        const __m128i scale = _mm_set1_epi16(63);
+        __m128i lo = _mm_mullo_epi16(coverage8((uint16_t)top, (uint16_t)bottom), scale);
+        __m128i hi = _mm_mullo_epi16(coverage8((uint16_t)(top >> 16), (uint16_t)(bottom >> 16)), scale);
+        __m128i shade = _mm_packus_epi16(lo, hi);
+        __m128i a = _mm_loadu_si128((const __m128i*)alpha);
+        // Memory order B,G,R,A = ARGB8888 on little endian
+        __m128i gg = _mm_unpacklo_epi8(shade, shade), ga = _mm_unpacklo_epi8(shade, a);
+        _mm_storeu_si128((__m128i*)(out + 0), _mm_unpacklo_epi16(gg, ga));
+        _mm_storeu_si128((__m128i*)(out + 4), _mm_unpackhi_epi16(gg, ga));
+        gg = _mm_unpackhi_epi8(shade, shade);
+        ga = _mm_unpackhi_epi8(shade, a);
+        _mm_storeu_si128((__m128i*)(out + 8), _mm_unpacklo_epi16(gg, ga));
+        _mm_storeu_si128((__m128i*)(out + 12), _mm_unpackhi_epi16(gg, ga));
+#else
+        for (int i = 0; i < 16; ++i) {
+            uint32_t count = ((top >> (2 * i)) & 1) + ((top >> (2 * i + 1)) & 1) +
+                             ((bottom >> (2 * i)) & 1) + ((bottom >> (2 * i + 1)) & 1);
+            uint32_t g = count * 63;
+            out[i] = (uint32_t)alpha[i] << 24 | g << 16 | g << 8 | g;
+        }
+#endif
+    }
+
+    void buildChunk(int cx, int cy) {
+        for (int py = 0; py < MINIMAP_CHUNK_PIXELS; ++py) {
+            int ty = cy * MINIMAP_CHUNK_TILES + py * MINIMAP_FACTOR;
+            const uint8_t* alpha = &discovered[(size_t)(cy * MINIMAP_CHUNK_PIXELS + py) * stride() +
+                                               cx * MINIMAP_CHUNK_PIXELS];
+            shadeRow(rowBits(cx, ty), rowBits(cx, ty + 1), alpha, &staging[(size_t)py * MINIMAP_CHUNK_PIXELS]);
+        }
+    }
+
+    // Rebuild and upload dirty chunks only.
+    void update() {
+        if (!texture) return;
+        for (int cy = 0; cy < chunksY; ++cy) {
+            for (int cx = 0; cx < chunksX; ++cx) {
+                uint8_t& d = dirty[(size_t)cy * chunksX + cx];
+                if (!d) continue;
+                d = 0;
+                buildChunk(cx, cy);
+                SDL_Rect r = { cx * MINIMAP_CHUNK_PIXELS, cy * MINIMAP_CHUNK_PIXELS,
+                               MINIMAP_CHUNK_PIXELS, MINIMAP_CHUNK_PIXELS };
+                captureUpdateTexture(texture, &r, staging.data(), MINIMAP_CHUNK_PIXELS * sizeof(uint32_t));
+                ++chunksUploaded;
+            }
+        }
+    }
+
+    void clearMarkers() {
+        for (auto& list : markers) list.clear();
+    }
+
+    // Queue a marker at a tile position; drawn as a scale×scale square.
+    void addMarker(MinimapMarker kind, int tileX, int tileY) {
+        markers[(size_t)kind].push_back({ tileX / MINIMAP_FACTOR, tileY / MINIMAP_FACTOR, 1, 1 });
+    }
+
+    // Map at (x, y) with each minimap pixel drawn scale × scale, then markers.
+    void draw(SDL_Renderer* renderer, int x, int y, int scale) {
+        if (!texture) return;
+        SDL_Rect src = { 0, 0, width, height };
+        SDL_Rect dst = { x, y, width * scale, height * scale };
+        captureCopy(renderer, texture, &src, &dst);
+        for (size_t k = 0; k < markers.size(); ++k) {
+            std::vector<SDL_Rect>& list = markers[k];
+            if (list.empty()) continue;
+            for (SDL_Rect& r : list) {
+                r = { x + r.x * scale, y + r.y * scale, scale, scale };
+            }
+            const SDL_Color& c = MARKER_COLORS[k];
+            captureDrawColor(renderer, c.r, c.g, c.b, c.a);
+            captureFillRects(renderer, list.data(), (int)list.size());
+        }
+        clearMarkers();
+    }
+};
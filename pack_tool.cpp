@@ -0,0 +1,121 @@
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "asset_pack.h"
+#include "mapped_file.h"
+
+// Asset Pack Tool (Tools / Assets)
+// Builds, lists and unpacks asset_pack.h archives.  `create` adds every
+// file named on the command line, recursing into directories; an asset's
+// name is its path relative to --root (default: the current directory)
+// with '/' separators, e.g. "sprites/player.argb".  Entries are stored LZ
+// compressed when that saves at least a quarter, unless --store is given
+// (art the game should use in place, straight from the mapping).
+//
+// Build: g++ -O2 -std=c++17 pack_tool.cpp -o pack_tool
+// Usage: pack_tool create <out.pak> [--store] [--root dir] <file|dir>...
+//        pack_tool list <pack>
+//        pack_tool extract <pack> <name> <out>
+
+static bool addFile(AssetPackWriter& pack, const std::filesystem::path& path, const std::filesystem::path& root,
+                    bool compress) {
+    std::error_code ec;
+    const std::string name = std::filesystem::relative(path, root, ec).generic_string();
+    if (ec || name.empty() || name.compare(0, 2, "..") == 0) {
+        std::fprintf(stderr, "%s is outside %s\n", path.string().c_str(), root.string().c_str());
+        return false;
+    }
+    MappedFile file;
+    if (!file.open(path.string().c_str())) {
+        std::fprintf(stderr, "Cannot read %s\n", path.string().c_str());
+        return false;
+    }
+    if (!pack.add(name, file.data, file.size, compress)) {
+        std::fprintf(stderr, "Cannot add %s: duplicate name, hash collision or too large\n", name.c_str());
+        return false;
+    }
+    return true;
+}
+
+static int create(int argc, char** argv) {
+    namespace fs = std::filesystem;
+    const char* out = argv[0];
+    fs::path root = fs::current_path();
+    bool compress = true;
+    AssetPackWriter pack;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--store") == 0) { compress = false; continue; }
+        if (std::strcmp(argv[i], "--root") == 0 && i + 1 < argc) { root = argv[++i]; continue; }
+        std::error_code ec;
+        if (fs::is_directory(argv[i], ec)) {
+            for (const fs::directory_entry& e : fs::recursive_directory_iterator(argv[i], ec)) {
+                if (e.is_regular_file(ec) && !addFile(pack, e.path(), root, compress)) return 1;
+            }
+        } else if (!addFile(pack, argv[i], root, compress)) {
+            return 1;
+        }
+    }
+    if (!pack.save(out)) {
+        std::fprintf(stderr, "Failed to write %s\n", out);
+        return 1;
+    }
+    size_t raw = 0, stored = 0, compressed = 0;
+    for (const AssetPackWriter::Pending& p : pack.entries) {
+        raw += p.rawSize;
+        stored += p.data.size();
+        compressed += p.compression != AssetCompression::None;
+    }
+    std::printf("%s: %zu assets (%zu compressed), %zu -> %zu bytes of data\n", out, pack.entries.size(), compressed,
+                raw, stored);
+    return 0;
+}
+
+static int list(const char* path) {
+    AssetPack pack;
+    if (!pack.open(path)) {
+        std::fprintf(stderr, "%s is not an asset pack\n", path);
+        return 1;
+    }
+    std::printf("%-16s %10s %10s %5s  %s\n", "hash", "offset", "size", "lz", "name");
+    for (size_t i = 0; i < pack.entryCount; ++i) {
+        AssetView v;
+        if (!pack.entry(i, v)) {
+            std::fprintf(stderr, "Entry %zu is corrupt\n", i);
+            return 1;
+        }
+        std::printf("%016llx %10zu %10zu %5s  %.*s\n", (unsigned long long)v.hash, (size_t)(v.data - pack.file.data),
+                    v.rawSize, v.compression == AssetCompression::None ? "" : "yes", (int)v.nameSize, v.name);
+    }
+    return 0;
+}
+
+static int extract(const char* path, const char* name, const char* out) {
+    AssetPack pack;
+    AssetView v;
+    if (!pack.open(path) || !pack.find(name, v)) {
+        std::fprintf(stderr, "%s not found in %s\n", name, path);
+        return 1;
+    }
+    std::vector<uint8_t> data(v.rawSize);
+    if (!assetDecode(v, data.data())) {
+        std::fprintf(stderr, "%s is corrupt\n", name);
+        return 1;
+    }
+    FILE* f = std::fopen(out, "wb");
+    bool ok = f && std::fwrite(data.data(), 1, data.size(), f) == data.size();
+    if (f) ok = std::fclose(f) == 0 && ok;
+    if (!ok) std::fprintf(stderr, "Failed to write %s\n", out);
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 3 && std::strcmp(argv[1], "create") == 0) return create(argc - 2, argv + 2);
+    if (argc == 3 && std::strcmp(argv[1], "list") == 0) return list(argv[2]);
+    if (argc == 5 && std::strcmp(argv[1], "extract") == 0) return extract(argv[2], argv[3], argv[4]);
+    std::fprintf(stderr, "Usage: pack_tool create <out.pak> [--store] [--root dir] <file|dir>...\n"
+                         "       pack_tool list <pack>\n"
+                         "       pack_tool extract <pack> <name> <out>\n");
+    return 2;
+}
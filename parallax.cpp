@@ -1,6 +1,8 @@
 #include <SDL2/SDL.h>
 #include <cmath>
 #include <array>
+#include "parallax_bake.h"
+#include "tick_rate.h"
 
 // Parallax Demo implementing Section 1 (Rendering & Assets) and Section 2 (Camera)
 // of the design specification. This program demonstrates a simple parallax
@@ -12,23 +14,24 @@
 
 constexpr int NATIVE_W = 480;   // Native render target width (Section 0)
 constexpr int NATIVE_H = 270;   // Native render target height (Section 0)
-constexpr float DT      = 1.0f / 60.0f; // Fixed timestep (60 Hz)
-
-// Structure representing a parallax layer (Section 1)
-struct ParallaxLayer {
-    float speed;      // Relative speed factor (0..1)
-    SDL_Color color;  // Solid fill color for this layer
-};
-
-// Define four parallax layers with increasing speeds (Section 1)
-static const std::array<ParallaxLayer, 4> PARALLAX = {{
-    {0.05f, {135, 206, 235, 255}}, // Sky layer (back)
-    {0.20f, {100, 149, 237, 255}}, // Far clouds
-    {0.45f, {70, 130, 180, 255}},  // Mid trees
-    {0.75f, {65, 105, 225, 255}}   // Near foliage
+
+constexpr uint64_t LEVEL_SEED = 0x9A7A11A8ull; // Seed for the procedural layer art
+
+// Define four parallax layers with increasing speeds (Section 1).  Each one is
+// painted procedurally (see parallax_bake.h) using its color as the palette.
+static const std::array<ParallaxLayerDesc, 4> PARALLAX = {{
+    {0.05f, {135, 206, 235, 255}, ParallaxKind::Sky},     // Sky layer (back)
+    {0.20f, {100, 149, 237, 255}, ParallaxKind::Clouds},  // Far clouds
+    {0.45f, {70, 130, 180, 255},  ParallaxKind::Hills},   // Mid trees
+    {0.75f, {65, 105, 225, 255},  ParallaxKind::Foliage}  // Near foliage
 }};
 
 int main(int argc, char* argv[]) {
+    const float DT = parseTickRate(argc, argv).dt;
+    // Bake the layer art on a worker thread while SDL starts up (Section 1)
+    ParallaxBaker<4> parallax;
+    parallax.start(PARALLAX, LEVEL_SEED, NATIVE_W, NATIVE_H);
+
     // Initialize SDL (Section 1)
     if (SDL_Init(SDL_INIT_VIDEO) != 0) {
         SDL_Log("SDL_Init Error: %s", SDL_GetError());
@@ -58,6 +61,12 @@ int main(int argc, char* argv[]) {
     }
     // Set logical size to native resolution so scaling is automatic (Section 0)
     SDL_RenderSetLogicalSize(renderer, NATIVE_W, NATIVE_H);
+    if (!parallax.upload(renderer)) {
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroyWindow(window);
+        SDL_Quit();
+        return 1;
+    }
 
     float playerX  = NATIVE_W / 2.0f;
     const float playerY  = NATIVE_H - 40.0f;  // Stand on ground near bottom
@@ -77,6 +86,8 @@ int main(int argc, char* argv[]) {
         while (SDL_PollEvent(&e)) {
             if (e.type == SDL_QUIT) {
                 quit = true;
+            } else if (e.type == SDL_RENDER_DEVICE_RESET && !parallax.deviceReset(renderer)) {
+                SDL_Log("Failed to recreate the parallax layers");
             }
         }
         // Input state (Section 4)
@@ -98,8 +109,8 @@ int main(int argc, char* argv[]) {
 
             // Smooth camera follow (Section 2)
             float targetCamX = playerX - NATIVE_W * 0.5f;
-            // Simple smoothing factor for critical damping approximation
-            const float smoothFactor = 0.10f;
+            // Exponential smoothing expressed per second (tick_rate.h)
+            const float smoothFactor = approachFactor(CAMERA_FOLLOW_RATE, DT);
             cameraX += (targetCamX - cameraX) * smoothFactor;
 
             accumulator -= DT;
@@ -110,17 +121,12 @@ int main(int argc, char* argv[]) {
         SDL_RenderClear(renderer);
 
         // Draw parallax layers (Section 1)
-        for (const auto& layer : PARALLAX) {
+        for (size_t i = 0; i < PARALLAX.size(); ++i) {
             // Compute horizontal offset based on camera position and layer speed
-            float offset = fmodf(cameraX * layer.speed, static_cast<float>(NATIVE_W));
+            float offset = fmodf(cameraX * PARALLAX[i].speed, static_cast<float>(NATIVE_W));
             if (offset < 0) offset += NATIVE_W;
-            // Set layer color
-            SDL_SetRenderDrawColor(renderer, layer.color.r, layer.color.g, layer.color.b, layer.color.a);
-            // Draw two rectangles to tile the layer across the screen
-            SDL_Rect rect1{ static_cast<int>(-offset), 0, NATIVE_W, NATIVE_H };
-            SDL_Rect rect2{ rect1.x + NATIVE_W, 0, NATIVE_W, NATIVE_H };
-            SDL_RenderFillRect(renderer, &rect1);
-            SDL_RenderFillRect(renderer, &rect2);
+            // One copy from the doubled, wrap-around layer texture
+            parallax.draw(renderer, i, offset);
         }
 
         // Draw simple ground
@@ -142,6 +148,7 @@ int main(int argc, char* argv[]) {
     }
 
     // Cleanup
+    parallax.destroy();
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
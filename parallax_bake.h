@@ -0,0 +1,270 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "rng.h"
+
+//----------------------------------------------------------------------------
+// Procedural Parallax Art (Section 1 – Rendering & Assets)
+//----------------------------------------------------------------------------
+// Each background layer is painted procedurally from the level seed: a
+// gradient sky, fBm value-noise clouds, a hill ridge with tree silhouettes
+// and a band of near foliage.  All noise lattices are periodic in x with the
+// layer width, so a baked layer tiles seamlessly.
+//
+// Painting happens on a worker thread while the level loads; only the final
+// texture upload runs on the render thread (SDL textures are not
+// thread-safe).  The upload is twice the layer width with the image
+// repeated, so drawing a scrolled layer at runtime is a single RenderCopy
+// with a shifted source rect – no per-frame generation and no seam logic.
+// The pixels are freed after the upload; the baker keeps the layer
+// descriptions and seed, so deviceReset() can repaint and upload again
+// when the driver drops the textures.
+//
+
+enum class ParallaxKind : uint8_t {
+    Sky,
+    Clouds,
+    Hills,
+    Foliage
+};
+
+struct ParallaxLayerDesc {
+    float speed;
+    SDL_Color color;
+    ParallaxKind kind;
+};
+
+namespace parallax_detail {
+
+inline uint32_t argb(float r, float g, float b, float a) {
+    auto c = [](float v) { return (uint32_t)(v < 0.0f ? 0.0f : (v > 255.0f ? 255.0f : v)); };
+    return c(a) << 24 | c(r) << 16 | c(g) << 8 | c(b);
+}
+
+inline float smooth(float t) { return t * t * (3.0f - 2.0f * t); }
+
+inline float smoothstep(float e0, float e1, float v) {
+    float t = (v - e0) / (e1 - e0);
+    t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+    return smooth(t);
+}
+
+// One octave of value noise whose lattice wraps every `periodX` cells.
+// Lattice values are drawn once from the counter RNG (keyed by layer,
+// octave and lattice coordinate) and then bilinearly interpolated.
+struct NoiseOctave {
+    int cell{ 1 };
+    int periodX{ 1 };
+    int rows{ 1 };
+    std::vector<float> lattice;
+
+    void init(uint64_t seed, uint32_t layer, uint32_t octave, int cellSize, int width, int height) {
+        cell = cellSize;
+        periodX = width / cellSize;
+        rows = height / cellSize + 2;
+        lattice.resize((size_t)periodX * rows);
+        for (int y = 0; y < rows; ++y) {
+            for (int x = 0; x < periodX; ++x) {
+                RngBlock b = rngBlock(seed, RngSystem::Parallax, layer, (uint32_t)x, octave << 16 | (uint32_t)y);
+                lattice[(size_t)y * periodX + x] = rngToFloat(b.v[0]);
+            }
+        }
+    }
+
+    float sample(int px, int py) const {
+        int ix = px / cell, iy = py / cell;
+        float fx = smooth((px - ix * cell) / (float)cell);
+        float fy = smooth((py - iy * cell) / (float)cell);
+        int x0 = ix % periodX, x1 = (ix + 1) % periodX;
+        const float* r0 = &lattice[(size_t)iy * periodX];
+        const float* r1 = r0 + periodX;
+        float a = r0[x0] + (r0[x1] - r0[x0]) * fx;
+        float b = r1[x0] + (r1[x1] - r1[x0]) * fx;
+        return a + (b - a) * fy;
+    }
+};
+
+// Four-octave fBm in [0, 1); base cell must divide the width down to cell/8.
+struct Fbm {
+    std::array<NoiseOctave, 4> octaves;
+
+    void init(uint64_t seed, uint32_t layer, int baseCell, int width, int height) {
+        for (int o = 0; o < 4; ++o) octaves[o].init(seed, layer, (uint32_t)o, baseCell >> o, width, height);
+    }
+
+    float sample(int x, int y) const {
+        float sum = 0.0f, amp = 0.5f, norm = 0.0f;
+        for (const auto& o : octaves) {
+            sum += o.sample(x, y) * amp;
+            norm += amp;
+            amp *= 0.5f;
+        }
+        return sum / norm;
+    }
+};
+
+inline void paintSky(const ParallaxLayerDesc& d, uint64_t seed, uint32_t layer, int w, int h, uint32_t* px) {
+    Fbm n;
+    n.init(seed, layer, 96, w, h);
+    for (int y = 0; y < h; ++y) {
+        float t = y / (float)(h - 1);
+        float k = 0.65f + 0.45f * t;   // darker zenith, brighter horizon
+        for (int x = 0; x < w; ++x) {
+            float grain = (n.sample(x, y) - 0.5f) * 6.0f;
+            px[y * w + x] = argb(d.color.r * k + grain, d.color.g * k + grain, d.color.b * k + grain, 255.0f);
+        }
+    }
+}
+
+inline void paintClouds(const ParallaxLayerDesc& d, uint64_t seed, uint32_t layer, int w, int h, uint32_t* px) {
+    Fbm n;
+    n.init(seed, layer, 96, w, h);
+    for (int y = 0; y < h; ++y) {
+        // Clouds live in the upper part of the screen
+        float band = 1.0f - smoothstep(0.25f * h, 0.6f * h, (float)y);
+        for (int x = 0; x < w; ++x) {
+            float v = n.sample(x, y) * band;
+            float a = smoothstep(0.38f, 0.52f, v);
+            float shade = 0.85f + 0.3f * v;
+            px[y * w + x] = argb(255.0f * shade * 0.9f + d.color.r * 0.1f,
+                                 255.0f * shade * 0.9f + d.color.g * 0.1f,
+                                 255.0f * shade * 0.9f + d.color.b * 0.1f,
+                                 a * 220.0f);
+        }
+    }
+}
+
+// Ridge profile (hills) or bush band (foliage) plus per-slot silhouettes.
+inline void paintRidge(const ParallaxLayerDesc& d, uint64_t seed, uint32_t layer, int w, int h, uint32_t* px,
+                       float baseY, float amplitude, int slotW, bool trees) {
+    Fbm n;
+    n.init(seed, layer, 120, w, 16);
+    std::vector<float> ridge(w);
+    for (int x = 0; x < w; ++x) ridge[x] = baseY - amplitude * n.sample(x, 0);
+    // Stamp one tree or bush per slot; slots wrap with the layer width
+    int slots = w / slotW;
+    for (int s = 0; s < slots; ++s) {
+        RngStream r(seed, RngSystem::Parallax, layer, 0x10000u + (uint32_t)s);
+        if (r.nextFloat() < (trees ? 0.35f : 0.2f)) continue;
+        int cx = s * slotW + (int)r.range(0.0f, (float)slotW);
+        float size = r.range(0.5f, 1.0f) * slotW;
+        float base = ridge[(cx % w + w) % w];
+        for (int dx = -(int)size; dx <= (int)size; ++dx) {
+            int x = ((cx + dx) % w + w) % w;
+            float u = std::fabs((float)dx) / size;
+            float lift = trees ? (1.0f - u) * size * 2.2f               // conifer triangle
+                               : std::sqrt(1.0f - u * u) * size * 0.8f;   // round bush
+            float top = base - lift;
+            if (top < ridge[x]) ridge[x] = top;
+        }
+    }
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            float edge = y - ridge[x];
+            float a = edge < 0.0f ? 0.0f : (edge < 1.0f ? edge : 1.0f);
+            float k = 0.8f + 0.2f * (1.0f - (float)y / h);
+            px[y * w + x] = argb(d.color.r * k, d.color.g * k, d.color.b * k, a * 255.0f);
+        }
+    }
+}
+
+} // namespace parallax_detail
+
+// Paint one layer into w×h ARGB8888 pixels.  Pure function of its inputs.
+inline void bakeParallaxLayer(const ParallaxLayerDesc& d, uint64_t seed, uint32_t layer,
+                              int w, int h, uint32_t* px) {
+    using namespace parallax_detail;
+    switch (d.kind) {
+        case ParallaxKind::Sky:     paintSky(d, seed, layer, w, h, px); break;
+        case ParallaxKind::Clouds:  paintClouds(d, seed, layer, w, h, px); break;
+        case ParallaxKind::Hills:   paintRidge(d, seed, layer, w, h, px, h * 0.62f, h * 0.22f, 24, true); break;
+        case ParallaxKind::Foliage: paintRidge(d, seed, layer, w, h, px, h * 0.86f, h * 0.10f, 40, false); break;
+    }
+}
+
+// Bakes a set of layers on a worker thread; upload() must be called from
+// the render thread and turns the pixels into wrap-around textures.
+template <size_t N>
+struct ParallaxBaker {
+    std::array<ParallaxLayerDesc, N> descs{};
+    uint64_t bakeSeed{ 0 };
+    std::array<std::vector<uint32_t>, N> pixels;
+    std::array<SDL_Texture*, N> textures{};
+    int width{ 0 };
+    int height{ 0 };
+    std::thread worker;
+
+    ~ParallaxBaker() {
+        if (worker.joinable()) worker.join();
+    }
+
+    void start(const std::array<ParallaxLayerDesc, N>& layers, uint64_t seed, int w, int h) {
+        descs = layers;
+        bakeSeed = seed;
+        width = w;
+        height = h;
+        worker = std::thread([this] { bake(); });
+    }
+
+    void bake() {
+        for (size_t i = 0; i < N; ++i) {
+            pixels[i].resize((size_t)width * height);
+            bakeParallaxLayer(descs[i], bakeSeed, (uint32_t)i, width, height, pixels[i].data());
+        }
+    }
+
+    // Joins the worker and creates the textures.  Returns false if any
+    // texture could not be created.
+    bool upload(SDL_Renderer* renderer) {
+        if (worker.joinable()) worker.join();
+        std::vector<uint32_t> wrapped((size_t)width * 2 * height);
+        for (size_t i = 0; i < N; ++i) {
+            for (int y = 0; y < height; ++y) {
+                const uint32_t* src = &pixels[i][(size_t)y * width];
+                std::copy(src, src + width, &wrapped[(size_t)y * width * 2]);
+                std::copy(src, src + width, &wrapped[(size_t)y * width * 2 + width]);
+            }
+            textures[i] = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+                                            SDL_TEXTUREACCESS_STATIC, width * 2, height);
+            if (!textures[i]) {
+                SDL_Log("SDL_CreateTexture (parallax) failed: %s", SDL_GetError());
+                return false;
+            }
+            SDL_UpdateTexture(textures[i], nullptr, wrapped.data(), width * 2 * (int)sizeof(uint32_t));
+            SDL_SetTextureBlendMode(textures[i], SDL_BLENDMODE_BLEND);
+            pixels[i].clear();
+            pixels[i].shrink_to_fit();
+        }
+        return true;
+    }
+
+    void destroy() {
+        if (worker.joinable()) worker.join();
+        for (auto& t : textures) {
+            if (t) SDL_DestroyTexture(t);
+            t = nullptr;
+        }
+    }
+
+    // On SDL_RENDER_DEVICE_RESET, from the render thread: the textures are
+    // gone, so repaint the layers here (the same pixels, they are a pure
+    // function of the descriptions and seed) and upload them again.
+    bool deviceReset(SDL_Renderer* renderer) {
+        destroy();
+        bake();
+        return upload(renderer);
+    }
+
+    // One textured copy per layer: the doubled texture absorbs the wrap.
+    void draw(SDL_Renderer* renderer, size_t layer, float offset) const {
+        int ox = (int)offset;
+        SDL_Rect src{ ox, 0, width, height };
+        SDL_Rect dst{ 0, 0, width, height };
+        SDL_RenderCopy(renderer, textures[layer], &src, &dst);
+    }
+};
@@ -0,0 +1,523 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "contact_solver.h"
+#include "solidity.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PHYSICS_HAS_SSE2 1
+#endif
+
+//----------------------------------------------------------------------------
+// Rigid Box Physics (Section 14 – Dynamic Bodies)
+//----------------------------------------------------------------------------
+// Axis-aligned boxes without rotation (crates, boulders) that fall, stack,
+// slide with friction, get pushed by kinematic bodies (the player, moving
+// platforms) and ride them.  Body data is SoA, in float pixels relative
+// to a movable origin rather than WorldCoords (SimOrigin, sim.h): the
+// tile contacts add the origin's tile (setTileOrigin) to index the bitmap,
+// and shift() moves every body when the origin moves.
+//
+// Each step:
+//   1. gravity on awake dynamic bodies
+//   2. contacts: body/body pairs from the spatial grid (contact_solver.h)
+//      and body/tile pairs from the solidity bitmap, both speculative, so
+//      resting and about-to-touch boxes are handled alike
+//   3. sequential impulses: a normal impulse (clamped >= 0, with
+//      Baumgarte push-out) and a Coulomb friction impulse per contact,
+//      warm-started from the previous step's impulses so tall stacks
+//      stay put; contacts with a kinematic body are capped by its
+//      pushLimit, giving it finite strength
+//   4. integrate positions, then island sleeping
+//
+// The solver works in rows of four contacts.  Contacts are greedily
+// coloured so no two in a colour share a dynamic body, and every colour is
+// padded to a multiple of four with inert contacts; a row can then gather
+// four contacts' velocities, solve them in SSE2 lanes and scatter back
+// without conflicts.  Tile contacts use a shared static slot.
+//
+// Sleeping: a dynamic body that stays below SLEEP_SPEED accumulates
+// sleepTime; an island (bodies connected by contacts) whose every member
+// has slept SLEEP_DELAY goes to sleep at once.  Sleeping bodies cost one
+// broadphase entry and behave as static to their awake neighbours unless
+// a moving body touches them, which wakes them.
+//
+
+constexpr float PHYSICS_GRAVITY        = 2100.0f;   // matches the player (Section 7/8)
+constexpr float PHYSICS_MAX_FALL       = 900.0f;
+constexpr float CONTACT_SLOP           = 0.5f;      // px of allowed penetration
+constexpr float CONTACT_BAUMGARTE      = 0.2f;
+constexpr float CONTACT_MARGIN         = 2.0f;      // speculative distance, px
+constexpr float SLEEP_SPEED            = 4.0f;      // px/s
+constexpr float SLEEP_DELAY            = 0.5f;      // s
+
+struct PhysicsBodies {
+    std::vector<float> x, y;            // centres, relative to the world's origin
+    std::vector<float> vx, vy;
+    std::vector<float> halfW, halfH;
+    std::vector<float> invMass;         // 0 for kinematic bodies
+    std::vector<float> friction;
+    std::vector<float> pushLimit;       // kinematic: max impulse per contact per step
+    std::vector<float> sleepTime;
+    std::vector<uint8_t> awake;
+    std::vector<uint8_t> kinematic;
+
+    size_t size() const { return x.size(); }
+
+    uint32_t add(float cx, float cy, float hw, float hh, float mass, float mu, bool isKinematic) {
+        x.push_back(cx); y.push_back(cy);
+        vx.push_back(0.0f); vy.push_back(0.0f);
+        halfW.push_back(hw); halfH.push_back(hh);
+        invMass.push_back(isKinematic || mass <= 0.0f ? 0.0f : 1.0f / mass);
+        friction.push_back(mu);
+        pushLimit.push_back(std::numeric_limits<float>::infinity());
+        sleepTime.push_back(0.0f);
+        awake.push_back(1);
+        kinematic.push_back(isKinematic ? 1 : 0);
+        return (uint32_t)x.size() - 1;
+    }
+
+    void clear() {
+        x.clear(); y.clear(); vx.clear(); vy.clear(); halfW.clear(); halfH.clear();
+        invMass.clear(); friction.clear(); pushLimit.clear(); sleepTime.clear(); awake.clear(); kinematic.clear();
+    }
+
+    bool dynamic(uint32_t i) const { return !kinematic[i]; }
+};
+
+// Contact rows, SoA.  `a` is always a dynamic body; `b` may be the static slot.
+struct PhysicsContacts {
+    std::vector<uint32_t> a, b;
+    std::vector<float> nx, ny;          // from a towards b
+    std::vector<float> separation;      // negative = penetrating
+    std::vector<float> mass;            // 1 / (invMass a + invMass b)
+    std::vector<float> mu;
+    std::vector<float> maxImpulse;      // cap on the accumulated normal impulse
+    std::vector<float> bias;
+    std::vector<float> normalImpulse, tangentImpulse;
+    std::vector<uint64_t> key;          // identifies the contact across steps
+
+    size_t size() const { return a.size(); }
+
+    void clear() {
+        a.clear(); b.clear(); nx.clear(); ny.clear(); separation.clear(); mass.clear();
+        mu.clear(); maxImpulse.clear(); bias.clear(); normalImpulse.clear(); tangentImpulse.clear();
+        key.clear();
+    }
+
+    void push(uint64_t k, uint32_t ia, uint32_t ib, float nX, float nY, float sep, float m, float f, float maxN) {
+        key.push_back(k);
+        a.push_back(ia); b.push_back(ib);
+        nx.push_back(nX); ny.push_back(nY);
+        separation.push_back(sep);
+        mass.push_back(m);
+        mu.push_back(f);
+        maxImpulse.push_back(maxN);
+        bias.push_back(0.0f);
+        normalImpulse.push_back(0.0f);
+        tangentImpulse.push_back(0.0f);
+    }
+};
+
+struct PhysicsWorld {
+    static constexpr int MAX_COLORS = 64;
+    static constexpr uint64_t PADDING_KEY = ~0ull;
+
+    PhysicsBodies bodies;
+    const SolidityBitmap* tiles{ nullptr };
+    float tileSize{ 16.0f };
+    int tileOriginX{ 0 };                  // bitmap tile at body position (0, 0)
+    int tileOriginY{ 0 };
+    int iterations{ 8 };
+
+    // Per-step scratch
+    ContactBodies shapes;                  // inflated boxes for the broadphase
+    ContactSolver broadphase;
+    std::vector<ContactPair> pairs;
+    PhysicsContacts raw;                   // contacts in discovery order
+    PhysicsContacts rows;                  // coloured, padded to rows of four
+    std::vector<uint32_t> rowColor;        // first contact of each colour in `rows`
+    std::vector<float> solveVx, solveVy, solveInvMass;   // bodies + static slot
+    std::vector<uint64_t> usedColors;
+    std::vector<uint8_t> colorOf;          // colour of each contact in `raw`
+    std::vector<uint32_t> perColor;        // contacts per colour, overflow last
+    std::vector<std::pair<uint64_t, std::pair<float, float>>> warmStart;  // last step's impulses by key
+    std::vector<uint32_t> island;
+    std::vector<float> islandSleep;
+    uint32_t sleepingBodies{ 0 };
+
+    void setTiles(const SolidityBitmap& bitmap, float size) {
+        tiles = &bitmap;
+        tileSize = size;
+    }
+
+    void setTileOrigin(int tx, int ty) {
+        tileOriginX = tx;
+        tileOriginY = ty;
+    }
+
+    // Move every body by (dx, dy) px, for an origin shift.  Contact keys
+    // are in bitmap tiles, so warm starting carries over.
+    void shift(float dx, float dy) {
+        for (float& v : bodies.x) v += dx;
+        for (float& v : bodies.y) v += dy;
+    }
+
+    void wake(uint32_t i) {
+        if (bodies.awake[i]) return;
+        bodies.awake[i] = 1;
+        bodies.sleepTime[i] = 0.0f;
+    }
+
+    static uint64_t pairKey(uint32_t i, uint32_t j) { return (uint64_t)i << 32 | j; }
+
+    // Tile contacts have bit 31 set; the map border (-1) is shifted in range.
+    // tx, ty are bitmap tiles.
+    uint64_t tileKey(uint32_t i, int tx, int ty) const {
+        uint32_t tile = (uint32_t)((ty + 1) * (tiles->width + 2) + (tx + 1)) & 0x7FFFFFFFu;
+        return (uint64_t)i << 32 | 0x80000000u | tile;
+    }
+
+    // Wake sleeping bodies overlapping a pixel area (e.g. terrain removed
+    // from under them).
+    void wakeArea(float x0, float y0, float x1, float y1) {
+        for (uint32_t i = 0; i < (uint32_t)bodies.size(); ++i) {
+            if (bodies.x[i] + bodies.halfW[i] < x0 || bodies.x[i] - bodies.halfW[i] > x1) continue;
+            if (bodies.y[i] + bodies.halfH[i] < y0 || bodies.y[i] - bodies.halfH[i] > y1) continue;
+            if (bodies.dynamic(i)) wake(i);
+        }
+    }
+
+    // Solver sees sleeping and kinematic bodies as infinitely heavy
+    bool solvable(uint32_t i) const { return bodies.dynamic(i) && bodies.awake[i]; }
+
+    bool moving(uint32_t i) const {
+        if (bodies.kinematic[i]) return bodies.vx[i] != 0.0f || bodies.vy[i] != 0.0f;
+        return bodies.awake[i] && bodies.sleepTime[i] == 0.0f;
+    }
+
+    void step(float dt) {
+        const uint32_t n = (uint32_t)bodies.size();
+        for (uint32_t i = 0; i < n; ++i) {
+            if (!solvable(i)) continue;
+            bodies.vy[i] = std::min(bodies.vy[i] + PHYSICS_GRAVITY * dt, PHYSICS_MAX_FALL);
+        }
+        findBodyContacts(dt);
+        findTileContacts(dt);
+        buildRows(dt);
+        solveRows();
+        for (uint32_t i = 0; i < n; ++i) {
+            if (!bodies.kinematic[i] && !bodies.awake[i]) continue;
+            bodies.x[i] += bodies.vx[i] * dt;
+            bodies.y[i] += bodies.vy[i] * dt;
+        }
+        updateSleep(dt);
+    }
+
+    void findBodyContacts(float dt) {
+        const uint32_t n = (uint32_t)bodies.size();
+        raw.clear();
+        shapes.clear();
+        for (uint32_t i = 0; i < n; ++i) {
+            float m = CONTACT_MARGIN + std::max(std::abs(bodies.vx[i]), std::abs(bodies.vy[i])) * dt;
+            // Broadphase only needs to know which bodies can start contacts
+            bool active = solvable(i) || moving(i);
+            shapes.add(bodies.x[i], bodies.y[i], bodies.halfW[i] + m, bodies.halfH[i] + m, active ? 1.0f : 0.0f);
+        }
+        broadphase.findContacts(shapes, pairs);
+        for (const ContactPair& p : pairs) {
+            uint32_t i = p.a, j = p.b;
+            // Moving bodies wake what they touch; slow ones lean on it instead
+            bool movingI = moving(i), movingJ = moving(j);
+            if (movingI && bodies.dynamic(j)) wake(j);
+            if (movingJ && bodies.dynamic(i)) wake(i);
+            if (!solvable(i) && !solvable(j)) continue;
+            if (!solvable(i)) std::swap(i, j);
+            addBoxContact(i, j);
+        }
+    }
+
+    void addBoxContact(uint32_t i, uint32_t j) {
+        float dx = bodies.x[j] - bodies.x[i], dy = bodies.y[j] - bodies.y[i];
+        float sepX = std::abs(dx) - (bodies.halfW[i] + bodies.halfW[j]);
+        float sepY = std::abs(dy) - (bodies.halfH[i] + bodies.halfH[j]);
+        float wi = bodies.invMass[i], wj = solvable(j) ? bodies.invMass[j] : 0.0f;
+        float mu = std::sqrt(bodies.friction[i] * bodies.friction[j]);
+        // A kinematic body can be given finite strength (the player cannot
+        // shove a crate through a wall); sleeping bodies hold like statics
+        float maxN = bodies.kinematic[j] ? bodies.pushLimit[j] : std::numeric_limits<float>::infinity();
+        if (sepX > sepY) raw.push(pairKey(i, j), i, j, dx < 0.0f ? -1.0f : 1.0f, 0.0f, sepX, 1.0f / (wi + wj), mu, maxN);
+        else             raw.push(pairKey(i, j), i, j, 0.0f, dy < 0.0f ? -1.0f : 1.0f, sepY, 1.0f / (wi + wj), mu, maxN);
+    }
+
+    void findTileContacts(float dt) {
+        if (!tiles) return;
+        const uint32_t n = (uint32_t)bodies.size();
+        const uint32_t staticSlot = n;
+        const float half = tileSize * 0.5f;
+        for (uint32_t i = 0; i < n; ++i) {
+            if (!solvable(i)) continue;
+            float mx = CONTACT_MARGIN + std::abs(bodies.vx[i]) * dt;
+            float my = CONTACT_MARGIN + std::abs(bodies.vy[i]) * dt;
+            int x0 = tileOriginX + (int)std::floor((bodies.x[i] - bodies.halfW[i] - mx) / tileSize);
+            int x1 = tileOriginX + (int)std::floor((bodies.x[i] + bodies.halfW[i] + mx) / tileSize);
+            int y0 = tileOriginY + (int)std::floor((bodies.y[i] - bodies.halfH[i] - my) / tileSize);
+            int y1 = tileOriginY + (int)std::floor((bodies.y[i] + bodies.halfH[i] + my) / tileSize);
+            for (int ty = y0; ty <= y1; ++ty) {
+                // One masked AND skips rows with nothing solid in reach
+                if (x0 >= 0 && x1 < tiles->width && !tiles->anySolid(x0, x1, ty)) continue;
+                for (int tx = x0; tx <= x1; ++tx) {
+                    if (!tiles->solid(tx, ty)) continue;
+                    float dx = ((tx - tileOriginX) * tileSize + half) - bodies.x[i];
+                    float dy = ((ty - tileOriginY) * tileSize + half) - bodies.y[i];
+                    float sepX = std::abs(dx) - (bodies.halfW[i] + half);
+                    float sepY = std::abs(dy) - (bodies.halfH[i] + half);
+                    float nX = 0.0f, nY = 0.0f, sep;
+                    if (sepX > sepY) { nX = dx < 0.0f ? -1.0f : 1.0f; sep = sepX; }
+                    else             { nY = dy < 0.0f ? -1.0f : 1.0f; sep = sepY; }
+                    // Only faces that are exposed: an inner edge between two
+                    // solid tiles must not catch a box sliding across them
+                    if (tiles->solid(tx - (int)nX, ty - (int)nY)) continue;
+                    raw.push(tileKey(i, tx, ty), i, staticSlot, nX, nY, sep, 1.0f / bodies.invMass[i], bodies.friction[i],
+                             std::numeric_limits<float>::infinity());
+                }
+            }
+        }
+    }
+
+    // Colour contacts, pad every colour to whole rows of four and prepare
+    // the solver's velocity arrays.
+    void buildRows(float dt) {
+        const uint32_t n = (uint32_t)bodies.size();
+        const uint32_t staticSlot = n;
+        const size_t count = raw.size();
+        usedColors.assign(n + 1, 0);
+        colorOf.resize(count);
+        perColor.assign(MAX_COLORS + 1, 0);
+        for (size_t c = 0; c < count; ++c) {
+            uint32_t a = raw.a[c], b = raw.b[c];
+            bool dynB = b != staticSlot && solvable(b);
+            uint64_t taken = usedColors[a] | (dynB ? usedColors[b] : 0);
+            int k = MAX_COLORS;
+            if (~taken) {
+                k = 0;
+                while (taken & (1ull << k)) ++k;
+                usedColors[a] |= 1ull << k;
+                if (dynB) usedColors[b] |= 1ull << k;
+            }
+            colorOf[c] = (uint8_t)k;
+            ++perColor[k];
+        }
+        rows.clear();
+        rowColor.clear();
+        for (int k = 0; k <= MAX_COLORS; ++k) {
+            if (!perColor[k]) continue;
+            for (size_t c = 0; c < count; ++c) {
+                if (colorOf[c] != k) continue;
+                rows.push(raw.key[c], raw.a[c], raw.b[c], raw.nx[c], raw.ny[c], raw.separation[c], raw.mass[c], raw.mu[c], raw.maxImpulse[c]);
+                // Overflow contacts may share bodies: one real contact per row
+                if (k == MAX_COLORS) padRow(staticSlot);
+            }
+            padRow(staticSlot);
+        }
+        for (size_t c = 0; c < rows.size(); ++c) {
+            float sep = rows.separation[c];
+            // Speculative: close the gap this step, push out past the slop
+            rows.bias[c] = sep > 0.0f ? sep / dt : CONTACT_BAUMGARTE / dt * std::min(0.0f, sep + CONTACT_SLOP);
+        }
+        solveVx.assign(bodies.vx.begin(), bodies.vx.end());
+        solveVy.assign(bodies.vy.begin(), bodies.vy.end());
+        solveInvMass.resize(n + 1);
+        for (uint32_t i = 0; i < n; ++i) solveInvMass[i] = solvable(i) ? bodies.invMass[i] : 0.0f;
+        solveVx.push_back(0.0f);
+        solveVy.push_back(0.0f);
+        solveInvMass[n] = 0.0f;
+        // Warm start: resting contacts begin from last step's impulses, so
+        // a tall stack does not have to rebuild its support every step
+        for (size_t c = 0; c < rows.size(); ++c) {
+            if (rows.key[c] == PADDING_KEY) continue;
+            auto it = std::lower_bound(warmStart.begin(), warmStart.end(), rows.key[c],
+                                       [](const std::pair<uint64_t, std::pair<float, float>>& e, uint64_t k) { return e.first < k; });
+            if (it == warmStart.end() || it->first != rows.key[c]) continue;
+            const uint32_t a = rows.a[c], b = rows.b[c];
+            const float pn = it->second.first, pt = it->second.second;
+            rows.normalImpulse[c] = pn;
+            rows.tangentImpulse[c] = pt;
+            const float px = pn * rows.nx[c] - pt * rows.ny[c];
+            const float py = pn * rows.ny[c] + pt * rows.nx[c];
+            solveVx[a] -= px * solveInvMass[a]; solveVy[a] -= py * solveInvMass[a];
+            solveVx[b] += px * solveInvMass[b]; solveVy[b] += py * solveInvMass[b];
+        }
+    }
+
+    // Fill the current row with inert contacts on the static slot.
+    void padRow(uint32_t staticSlot) {
+        while (rows.size() % 4) rows.push(PADDING_KEY, staticSlot, staticSlot, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f);
+    }
+
+    void solveRows() {
+        const size_t count = rows.size();
+        for (int it = 0; it < iterations; ++it) {
+            for (size_t c = 0; c < count; c += 4) solveRow(c);
+        }
+        warmStart.clear();
+        for (size_t c = 0; c < count; ++c) {
+            if (rows.key[c] != PADDING_KEY) warmStart.push_back({ rows.key[c], { rows.normalImpulse[c], rows.tangentImpulse[c] } });
+        }
+        std::sort(warmStart.begin(), warmStart.end());
+        const uint32_t n = (uint32_t)bodies.size();
+        for (uint32_t i = 0; i < n; ++i) {
+            if (!solvable(i)) continue;
+            bodies.vx[i] = solveVx[i];
+            bodies.vy[i] = solveVy[i];
+        }
+    }
+
+    void solveRow(size_t c) {
+        const uint32_t* A = &rows.a[c];
+        const uint32_t* B = &rows.b[c];
+#if defined(PHYSICS_HAS_SSE2)
+        __m128 vax = _mm_setr_ps(solveVx[A[0]], solveVx[A[1]], solveVx[A[2]], solveVx[A[3]]);
+        __m128 vay = _mm_setr_ps(solveVy[A[0]], solveVy[A[1]], solveVy[A[2]], solveVy[A[3]]);
+        __m128 vbx = _mm_setr_ps(solveVx[B[0]], solveVx[B[1]], solveVx[B[2]], solveVx[B[3]]);
+        __m128 vby = _mm_setr_ps(solveVy[B[0]], solveVy[B[1]], solveVy[B[2]], solveVy[B[3]]);
+        __m128 wa  = _mm_setr_ps(solveInvMass[A[0]], solveInvMass[A[1]], solveInvMass[A[2]], solveInvMass[A[3]]);
+        __m128 wb  = _mm_setr_ps(solveInvMass[B[0]], solveInvMass[B[1]], solveInvMass[B[2]], solveInvMass[B[3]]);
+        __m128 nx = _mm_loadu_ps(&rows.nx[c]);
+        __m128 ny = _mm_loadu_ps(&rows.ny[c]);
+        __m128 mass = _mm_loadu_ps(&rows.mass[c]);
+        __m128 bias = _mm_loadu_ps(&rows.bias[c]);
+        __m128 mu = _mm_loadu_ps(&rows.mu[c]);
+        __m128 accN = _mm_loadu_ps(&rows.normalImpulse[c]);
+        __m128 accT = _mm_loadu_ps(&rows.tangentImpulse[c]);
+
+        // Normal: vn + bias >= 0, 0 <= accumulated impulse <= maxImpulse
+        __m128 rvx = _mm_sub_ps(vbx, vax), rvy = _mm_sub_ps(vby, vay);
+        __m128 vn = _mm_add_ps(_mm_mul_ps(rvx, nx), _mm_mul_ps(rvy, ny));
+        __m128 lambda = _mm_mul_ps(_mm_sub_ps(_mm_setzero_ps(), _mm_add_ps(vn, bias)), mass);
+        __m128 newN = _mm_max_ps(_mm_add_ps(accN, lambda), _mm_setzero_ps());
+        newN = _mm_min_ps(newN, _mm_loadu_ps(&rows.maxImpulse[c]));
+        lambda = _mm_sub_ps(newN, accN);
+        accN = newN;
+        __m128 px = _mm_mul_ps(lambda, nx), py = _mm_mul_ps(lambda, ny);
+        vax = _mm_sub_ps(vax, _mm_mul_ps(px, wa)); vay = _mm_sub_ps(vay, _mm_mul_ps(py, wa));
+        vbx = _mm_add_ps(vbx, _mm_mul_ps(px, wb)); vby = _mm_add_ps(vby, _mm_mul_ps(py, wb));
+
+        // Friction along t = (-ny, nx), |impulse| <= mu * normal impulse
+        rvx = _mm_sub_ps(vbx, vax); rvy = _mm_sub_ps(vby, vay);
+        __m128 tx = _mm_sub_ps(_mm_setzero_ps(), ny), ty = nx;
+        __m128 vt = _mm_add_ps(_mm_mul_ps(rvx, tx), _mm_mul_ps(rvy, ty));
+        __m128 maxF = _mm_mul_ps(mu, accN);
+        __m128 newT = _mm_add_ps(accT, _mm_mul_ps(_mm_sub_ps(_mm_setzero_ps(), vt), mass));
+        newT = _mm_min_ps(_mm_max_ps(newT, _mm_sub_ps(_mm_setzero_ps(), maxF)), maxF);
+        lambda = _mm_sub_ps(newT, accT);
+        accT = newT;
+        px = _mm_mul_ps(lambda, tx); py = _mm_mul_ps(lambda, ty);
+        vax = _mm_sub_ps(vax, _mm_mul_ps(px, wa)); vay = _mm_sub_ps(vay, _mm_mul_ps(py, wa));
+        vbx = _mm_add_ps(vbx, _mm_mul_ps(px, wb)); vby = _mm_add_ps(vby, _mm_mul_ps(py, wb));
+
+        _mm_storeu_ps(&rows.normalImpulse[c], accN);
+        _mm_storeu_ps(&rows.tangentImpulse[c], accT);
+        alignas(16) float oax[4], oay[4], obx[4], oby[4];
+        _mm_store_ps(oax, vax); _mm_store_ps(oay, vay);
+        _mm_store_ps(obx, vbx); _mm_store_ps(oby, vby);
+        // Lanes touch distinct dynamic bodies; static and padding slots get
+        // back the value they were read with
+        for (int k = 0; k < 4; ++k) {
+            solveVx[A[k]] = oax[k]; solveVy[A[k]] = oay[k];
+            solveVx[B[k]] = obx[k]; solveVy[B[k]] = oby[k];
+        }
+#else
+        for (size_t k = c; k < c + 4; ++k) {
+            const uint32_t a = rows.a[k], b = rows.b[k];
+            const float wa = solveInvMass[a], wb = solveInvMass[b];
+            const float nx = rows.nx[k], ny = rows.ny[k];
+            float vn = (solveVx[b] - solveVx[a]) * nx + (solveVy[b] - solveVy[a]) * ny;
+            float newN = std::max(rows.normalImpulse[k] - (vn + rows.bias[k]) * rows.mass[k], 0.0f);
+            newN = std::min(newN, rows.maxImpulse[k]);
+            float lambda = newN - rows.normalImpulse[k];
+            rows.normalImpulse[k] = newN;
+            solveVx[a] -= lambda * nx * wa; solveVy[a] -= lambda * ny * wa;
+            solveVx[b] += lambda * nx * wb; solveVy[b] += lambda * ny * wb;
+            const float tx = -ny, ty = nx;
+            float vt = (solveVx[b] - solveVx[a]) * tx + (solveVy[b] - solveVy[a]) * ty;
+            float maxF = rows.mu[k] * newN;
+            float newT = std::min(std::max(rows.tangentImpulse[k] - vt * rows.mass[k], -maxF), maxF);
+            lambda = newT - rows.tangentImpulse[k];
+            rows.tangentImpulse[k] = newT;
+            solveVx[a] -= lambda * tx * wa; solveVy[a] -= lambda * ty * wa;
+            solveVx[b] += lambda * tx * wb; solveVy[b] += lambda * ty * wb;
+        }
+#endif
+    }
+
+    uint32_t findIsland(uint32_t i) {
+        while (island[i] != i) {
+            island[i] = island[island[i]];
+            i = island[i];
+        }
+        return i;
+    }
+
+    void updateSleep(float dt) {
+        const uint32_t n = (uint32_t)bodies.size();
+        island.resize(n);
+        islandSleep.assign(n, SLEEP_DELAY * 2.0f);
+        for (uint32_t i = 0; i < n; ++i) {
+            island[i] = i;
+            if (!solvable(i)) continue;
+            float speed2 = bodies.vx[i] * bodies.vx[i] + bodies.vy[i] * bodies.vy[i];
+            bodies.sleepTime[i] = speed2 < SLEEP_SPEED * SLEEP_SPEED ? bodies.sleepTime[i] + dt : 0.0f;
+        }
+        // Islands are linked through body/body contacts between awake bodies
+        for (size_t c = 0; c < raw.size(); ++c) {
+            uint32_t a = raw.a[c], b = raw.b[c];
+            if (b >= n || !solvable(b)) continue;
+            uint32_t ra = findIsland(a), rb = findIsland(b);
+            if (ra != rb) island[std::max(ra, rb)] = std::min(ra, rb);
+        }
+        for (uint32_t i = 0; i < n; ++i) {
+            if (!solvable(i)) continue;
+            uint32_t r = findIsland(i);
+            islandSleep[r] = std::min(islandSleep[r], bodies.sleepTime[i]);
+        }
+        sleepingBodies = 0;
+        for (uint32_t i = 0; i < n; ++i) {
+            if (solvable(i) && islandSleep[findIsland(i)] >= SLEEP_DELAY) {
+                bodies.awake[i] = 0;
+                bodies.vx[i] = 0.0f;
+                bodies.vy[i] = 0.0f;
+            }
+            if (bodies.dynamic(i) && !bodies.awake[i]) ++sleepingBodies;
+        }
+    }
+
+    // Push a kinematic box (e.g. the player, by centre) out of the dynamic
+    // bodies it overlaps; pushX/pushY return the total correction.
+    void separate(float& cx, float& cy, float hw, float hh, float& pushX, float& pushY) const {
+        pushX = 0.0f;
+        pushY = 0.0f;
+        const uint32_t n = (uint32_t)bodies.size();
+        for (uint32_t i = 0; i < n; ++i) {
+            if (bodies.kinematic[i]) continue;
+            float dx = cx - bodies.x[i], dy = cy - bodies.y[i];
+            float px = hw + bodies.halfW[i] - std::abs(dx);
+            float py = hh + bodies.halfH[i] - std::abs(dy);
+            if (px <= 0.0f || py <= 0.0f) continue;
+            if (px < py) {
+                float s = dx < 0.0f ? -px : px;
+                cx += s;
+                pushX += s;
+            } else {
+                float s = dy < 0.0f ? -py : py;
+                cy += s;
+                pushY += s;
+            }
+        }
+    }
+};
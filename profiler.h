@@ -0,0 +1,424 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <elf.h>
+#include <link.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <ucontext.h>
+#include "mapped_file.h"
+#define PROFILER_SUPPORTED 1
+#endif
+
+//----------------------------------------------------------------------------
+// Sampling Profiler (Section 0 – Diagnostics)
+//----------------------------------------------------------------------------
+// Opt-in statistical profiler: setitimer(ITIMER_PROF) raises SIGPROF for
+// every `1/hz` s of CPU time the process uses, on whichever thread is
+// running.  The handler walks the frame-pointer chain from the interrupted
+// context and drops the return addresses into a preallocated ring.  It
+// touches nothing else: no allocation, no locks, no libc calls, only
+// lock-free atomics on static storage, so it is async-signal-safe.
+//
+// Frame pointers are only followed inside the interrupted thread's stack,
+// whose bounds registerThread() records up front (the starting thread
+// registers itself; pass it to JobSystem::threadStart for workers).  An
+// unregistered thread contributes its program counter alone.  Build with
+// -fno-omit-frame-pointer for full stacks; without it the walk ends early
+// but stays safe.
+//
+// drain() (call once per frame) moves finished samples from the ring into
+// a map of unique stacks; a full ring drops samples and counts them.  At
+// the end, writeFolded() symbolises each unique address once — function
+// symbols from the executable's own ELF symbol table, dladdr() for shared
+// libraries, demangled — and writes the folded-stack format
+// ("root;caller;leaf count" per line).  writeFlameGraph() renders the same
+// data as a self-contained SVG, so no external tools are needed.
+//
+// Linux only (x86-64 and AArch64 unwinding); elsewhere start() fails.
+//
+
+constexpr int    PROFILER_MAX_DEPTH  = 64;
+constexpr size_t PROFILER_RING_SIZE  = 4096;     // samples between drains; power of two
+constexpr int    PROFILER_DEFAULT_HZ = 997;      // prime, so it does not beat with the frame rate
+
+struct ProfilerSample {
+    std::atomic<uint32_t> state;    // 0 free, 1 being written, 2 ready
+    uint32_t depth;
+    uintptr_t pc[PROFILER_MAX_DEPTH];   // leaf first
+};
+
+struct ProfilerThreadStack {
+    uintptr_t lo, hi;
+};
+
+inline ProfilerSample* g_profilerRing = nullptr;
+inline std::atomic<uint64_t> g_profilerNext{ 0 };
+inline std::atomic<uint64_t> g_profilerDropped{ 0 };
+inline thread_local ProfilerThreadStack g_profilerStack{ 0, 0 };
+
+// Flame graph of folded stacks ("a;b;c" → count) as a standalone SVG.
+// Frames are stacked root at the bottom; width is proportional to samples.
+inline bool writeFlameGraphSvg(const std::vector<std::pair<std::string, uint64_t>>& folded,
+                               const char* path, const char* title) {
+    struct Node {
+        std::string name;
+        uint64_t count{ 0 };
+        std::map<std::string, size_t> children;
+    };
+    std::vector<Node> nodes(1);
+    nodes[0].name = "all";
+    for (const auto& [stack, count] : folded) {
+        size_t n = 0;
+        nodes[0].count += count;
+        for (size_t begin = 0; begin <= stack.size();) {
+            size_t end = stack.find(';', begin);
+            if (end == std::string::npos) end = stack.size();
+            std::string frame = stack.substr(begin, end - begin);
+            begin = end + 1;
+            auto it = nodes[n].children.find(frame);
+            size_t child;
+            if (it == nodes[n].children.end()) {
+                child = nodes.size();
+                nodes[n].children.emplace(frame, child);
+                nodes.push_back(Node{ frame, 0, {} });
+            } else {
+                child = it->second;
+            }
+            nodes[child].count += count;
+            n = child;
+        }
+    }
+    int maxDepth = 0;
+    std::vector<std::pair<size_t, int>> work{ { 0, 0 } };
+    while (!work.empty()) {
+        auto [n, d] = work.back();
+        work.pop_back();
+        maxDepth = std::max(maxDepth, d);
+        for (const auto& c : nodes[n].children) work.push_back({ c.second, d + 1 });
+    }
+
+    auto escape = [](const std::string& s) {
+        std::string out;
+        for (char c : s) {
+            if (c == '<') out += "&lt;";
+            else if (c == '>') out += "&gt;";
+            else if (c == '&') out += "&amp;";
+            else if (c == '"') out += "&quot;";
+            else out += c;
+        }
+        return out;
+    };
+    FILE* f = std::fopen(path, "w");
+    if (!f) return false;
+    const double width = 1200.0, frameH = 16.0, top = 36.0;
+    const double height = top + (maxDepth + 1) * frameH + 8.0;
+    const double scale = nodes[0].count ? (width - 20.0) / (double)nodes[0].count : 0.0;
+    std::fprintf(f, "<?xml version=\"1.0\" standalone=\"no\"?>\n"
+                    "<svg version=\"1.1\" width=\"%.0f\" height=\"%.0f\" xmlns=\"http://www.w3.org/2000/svg\">\n"
+                    "<rect width=\"100%%\" height=\"100%%\" fill=\"#f8f4ec\"/>\n"
+                    "<text x=\"%.0f\" y=\"22\" font-family=\"Verdana\" font-size=\"15\" text-anchor=\"middle\">%s (%llu samples)</text>\n",
+                 width, height, width * 0.5, escape(title).c_str(), (unsigned long long)nodes[0].count);
+    // Children are laid out left to right in name order (map order)
+    std::vector<std::tuple<size_t, int, double>> stack{ { 0, 0, 10.0 } };
+    while (!stack.empty()) {
+        auto [n, d, x] = stack.back();
+        stack.pop_back();
+        const Node& node = nodes[n];
+        const double w = node.count * scale;
+        if (w < 0.1) continue;
+        const double y = height - 8.0 - (d + 1) * frameH;
+        uint32_t hash = 2166136261u;
+        for (char c : node.name) hash = (hash ^ (uint8_t)c) * 16777619u;
+        const std::string name = escape(node.name);
+        std::fprintf(f, "<g><title>%s (%llu samples, %.2f%%)</title>"
+                        "<rect x=\"%.2f\" y=\"%.1f\" width=\"%.2f\" height=\"%.1f\" fill=\"rgb(%u,%u,%u)\" rx=\"2\"/>",
+                     name.c_str(), (unsigned long long)node.count, 100.0 * node.count / nodes[0].count,
+                     x, y, w, frameH - 1.0, 205u + hash % 50u, 80u + (hash >> 8) % 130u, 40u + (hash >> 16) % 40u);
+        const size_t fit = (size_t)(w / 7.0);
+        if (fit >= 3) {
+            std::string label = node.name.size() <= fit ? node.name : node.name.substr(0, fit - 2) + "..";
+            std::fprintf(f, "<text x=\"%.2f\" y=\"%.1f\" font-family=\"Verdana\" font-size=\"11\">%s</text>",
+                         x + 3.0, y + frameH - 4.0, escape(label).c_str());
+        }
+        std::fprintf(f, "</g>\n");
+        double cx = x;
+        for (const auto& c : node.children) {
+            stack.push_back({ c.second, d + 1, cx });
+            cx += nodes[c.second].count * scale;
+        }
+    }
+    std::fprintf(f, "</svg>\n");
+    return std::fclose(f) == 0;
+}
+
+// "--profile" writes profile.folded / profile.svg, "--profile=PREFIX"
+// PREFIX.folded / PREFIX.svg.  Returns nullptr if not given.
+inline const char* parseProfilePrefix(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--profile=", 10) == 0) return argv[i] + 10;
+        if (std::strcmp(argv[i], "--profile") == 0) return "profile";
+    }
+    return nullptr;
+}
+
+#if defined(PROFILER_SUPPORTED)
+
+// Function names for code addresses: the executable's ELF symbol table
+// (covers static functions, unlike dladdr), then dladdr for libraries.
+struct ProfilerSymbols {
+    struct Symbol {
+        uintptr_t start, size;
+        const char* name;
+    };
+    MappedFile exe;
+    std::vector<Symbol> symbols;     // by start, relative to the load bias
+    uintptr_t bias{ 0 };
+
+    void load() {
+        symbols.clear();
+        dl_iterate_phdr([](dl_phdr_info* info, size_t, void* self) {
+            ((ProfilerSymbols*)self)->bias = info->dlpi_addr;   // first object is the executable
+            return 1;
+        }, this);
+        if (!exe.open("/proc/self/exe") || exe.size < sizeof(Elf64_Ehdr)) return;
+        const Elf64_Ehdr* eh = (const Elf64_Ehdr*)exe.data;
+        if (std::memcmp(eh->e_ident, ELFMAG, SELFMAG) != 0 || eh->e_ident[EI_CLASS] != ELFCLASS64) return;
+        if (eh->e_shoff + (uint64_t)eh->e_shnum * sizeof(Elf64_Shdr) > exe.size) return;
+        const Elf64_Shdr* sh = (const Elf64_Shdr*)(exe.data + eh->e_shoff);
+        for (uint32_t type : { (uint32_t)SHT_SYMTAB, (uint32_t)SHT_DYNSYM }) {
+            for (int i = 0; i < eh->e_shnum && symbols.empty(); ++i) {
+                if (sh[i].sh_type != type || sh[i].sh_link >= eh->e_shnum) continue;
+                const Elf64_Shdr& strs = sh[sh[i].sh_link];
+                if (sh[i].sh_offset + sh[i].sh_size > exe.size || strs.sh_offset + strs.sh_size > exe.size) continue;
+                const Elf64_Sym* sym = (const Elf64_Sym*)(exe.data + sh[i].sh_offset);
+                const char* names = (const char*)exe.data + strs.sh_offset;
+                for (size_t k = 0; k < sh[i].sh_size / sizeof(Elf64_Sym); ++k) {
+                    if (ELF64_ST_TYPE(sym[k].st_info) != STT_FUNC || !sym[k].st_value) continue;
+                    if (sym[k].st_name >= strs.sh_size) continue;
+                    symbols.push_back({ (uintptr_t)sym[k].st_value, (uintptr_t)sym[k].st_size, names + sym[k].st_name });
+                }
+            }
+            if (!symbols.empty()) break;
+        }
+        std::sort(symbols.begin(), symbols.end(), [](const Symbol& a, const Symbol& b) { return a.start < b.start; });
+    }
+
+    static std::string demangle(const char* name) {
+        int status = 0;
+        char* out = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+        std::string s = status == 0 && out ? out : name;
+        std::free(out);
+        return s;
+    }
+
+    std::string resolve(uintptr_t pc) const {
+        const uintptr_t rel = pc - bias;
+        auto it = std::upper_bound(symbols.begin(), symbols.end(), rel,
+                                   [](uintptr_t v, const Symbol& s) { return v < s.start; });
+        if (it != symbols.begin() && rel < (it - 1)->start + std::max<uintptr_t>((it - 1)->size, 1)) {
+            return demangle((it - 1)->name);
+        }
+        Dl_info info;
+        if (dladdr((void*)pc, &info)) {
+            if (info.dli_sname) return demangle(info.dli_sname);
+            if (info.dli_fname) {
+                const char* base = std::strrchr(info.dli_fname, '/');
+                char buf[64];
+                std::snprintf(buf, sizeof(buf), "+0x%zx", (size_t)(pc - (uintptr_t)info.dli_fbase));
+                return std::string(base ? base + 1 : info.dli_fname) + buf;
+            }
+        }
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "0x%zx", (size_t)pc);
+        return buf;
+    }
+};
+
+struct SamplingProfiler {
+    // Unique stacks, root first, with their sample counts
+    std::map<std::vector<uintptr_t>, uint64_t> stacks;
+    uint64_t samples{ 0 };
+    bool running{ false };
+    struct sigaction previous {};
+
+    SamplingProfiler() = default;
+    SamplingProfiler(const SamplingProfiler&) = delete;
+    SamplingProfiler& operator=(const SamplingProfiler&) = delete;
+    ~SamplingProfiler() { stop(); }
+
+    // Record the calling thread's stack bounds so its samples get unwound.
+    static void registerThread() {
+        pthread_attr_t attr;
+        if (pthread_getattr_np(pthread_self(), &attr) != 0) return;
+        void* base = nullptr;
+        size_t size = 0;
+        if (pthread_attr_getstack(&attr, &base, &size) == 0) {
+            g_profilerStack = { (uintptr_t)base, (uintptr_t)base + size };
+        }
+        pthread_attr_destroy(&attr);
+    }
+
+    static void onSignal(int, siginfo_t*, void* context) {
+        ProfilerSample* ring = g_profilerRing;
+        if (!ring) return;
+        ProfilerSample& s = ring[g_profilerNext.fetch_add(1, std::memory_order_relaxed) & (PROFILER_RING_SIZE - 1)];
+        uint32_t expected = 0;
+        if (!s.state.compare_exchange_strong(expected, 1, std::memory_order_acquire)) {
+            g_profilerDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        const ucontext_t* uc = (const ucontext_t*)context;
+#if defined(__x86_64__)
+        uintptr_t pc = (uintptr_t)uc->uc_mcontext.gregs[REG_RIP];
+        uintptr_t fp = (uintptr_t)uc->uc_mcontext.gregs[REG_RBP];
+        uintptr_t sp = (uintptr_t)uc->uc_mcontext.gregs[REG_RSP];
+#elif defined(__aarch64__)
+        uintptr_t pc = (uintptr_t)uc->uc_mcontext.pc;
+        uintptr_t fp = (uintptr_t)uc->uc_mcontext.regs[29];
+        uintptr_t sp = (uintptr_t)uc->uc_mcontext.sp;
+#else
+        uintptr_t pc = 0, fp = 0, sp = 0;
+#endif
+        uint32_t depth = 0;
+        s.pc[depth++] = pc;
+        // Each frame record is {caller's fp, return address}; it must lie in
+        // this thread's stack, above the last one, and be aligned
+        const ProfilerThreadStack bounds = g_profilerStack;
+        uintptr_t lo = std::max(sp, bounds.lo);
+        while (depth < PROFILER_MAX_DEPTH && fp >= lo && fp + 2 * sizeof(uintptr_t) <= bounds.hi &&
+               (fp & (sizeof(uintptr_t) - 1)) == 0) {
+            const uintptr_t* record = (const uintptr_t*)fp;
+            uintptr_t ret = record[1];
+            if (!ret) break;
+            s.pc[depth++] = ret;
+            lo = fp + 2 * sizeof(uintptr_t);
+            fp = record[0];
+        }
+        s.depth = depth;
+        s.state.store(2, std::memory_order_release);
+    }
+
+    bool start(int hz = PROFILER_DEFAULT_HZ) {
+        if (running) return false;
+        if (!g_profilerRing) g_profilerRing = new ProfilerSample[PROFILER_RING_SIZE]();
+        registerThread();
+        struct sigaction sa {};
+        sa.sa_sigaction = &SamplingProfiler::onSignal;
+        sa.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&sa.sa_mask);
+        if (sigaction(SIGPROF, &sa, &previous) != 0) return false;
+        itimerval timer{};
+        timer.it_interval.tv_usec = std::max(1, 1000000 / std::max(1, hz));
+        timer.it_value = timer.it_interval;
+        setitimer(ITIMER_PROF, &timer, nullptr);
+        running = true;
+        return true;
+    }
+
+    void stop() {
+        if (!running) return;
+        itimerval off{};
+        setitimer(ITIMER_PROF, &off, nullptr);
+        // A handler already running on another thread still finishes its
+        // sample; drain() skips slots that are not ready.  The ring is
+        // kept for the lifetime of the process so such a late write is safe.
+        // A SIGPROF raised just before the disarm may still be pending, and
+        // the default action would kill the process: leave it ignored
+        // instead of restoring SIG_DFL.
+        struct sigaction restore = previous;
+        if (!(restore.sa_flags & SA_SIGINFO) && restore.sa_handler == SIG_DFL) restore.sa_handler = SIG_IGN;
+        sigaction(SIGPROF, &restore, nullptr);
+        drain();
+        running = false;
+    }
+
+    uint64_t dropped() const { return g_profilerDropped.load(std::memory_order_relaxed); }
+
+    // Move ready samples out of the ring.  Not signal-safe; call from one
+    // thread, regularly enough that PROFILER_RING_SIZE samples do not
+    // pile up in between (4 s at the default rate).
+    void drain() {
+        ProfilerSample* ring = g_profilerRing;
+        if (!ring) return;
+        std::vector<uintptr_t> stack;
+        for (size_t i = 0; i < PROFILER_RING_SIZE; ++i) {
+            ProfilerSample& s = ring[i];
+            if (s.state.load(std::memory_order_acquire) != 2) continue;
+            stack.assign(s.pc, s.pc + s.depth);
+            s.state.store(0, std::memory_order_release);
+            // Return addresses point after the call; step back into it
+            for (size_t k = 1; k < stack.size(); ++k) --stack[k];
+            std::reverse(stack.begin(), stack.end());
+            ++stacks[stack];
+            ++samples;
+        }
+    }
+
+    // Symbolised stacks, merged where different addresses share names.
+    std::vector<std::pair<std::string, uint64_t>> folded() const {
+        ProfilerSymbols symbols;
+        symbols.load();
+        std::unordered_map<uintptr_t, std::string> names;
+        std::map<std::string, uint64_t> merged;
+        for (const auto& [stack, count] : stacks) {
+            std::string line;
+            for (uintptr_t pc : stack) {
+                auto it = names.find(pc);
+                if (it == names.end()) {
+                    std::string n = symbols.resolve(pc);
+                    std::replace(n.begin(), n.end(), ';', ':');
+                    std::replace(n.begin(), n.end(), '\n', ' ');
+                    it = names.emplace(pc, std::move(n)).first;
+                }
+                if (!line.empty()) line += ';';
+                line += it->second;
+            }
+            merged[line] += count;
+        }
+        return { merged.begin(), merged.end() };
+    }
+
+    bool writeFolded(const char* path) const {
+        FILE* f = std::fopen(path, "w");
+        if (!f) return false;
+        for (const auto& [stack, count] : folded()) {
+            std::fprintf(f, "%s %llu\n", stack.c_str(), (unsigned long long)count);
+        }
+        return std::fclose(f) == 0;
+    }
+
+    bool writeFlameGraph(const char* path, const char* title) const {
+        return writeFlameGraphSvg(folded(), path, title);
+    }
+};
+
+#else
+
+struct SamplingProfiler {
+    static void registerThread() {}
+    bool start(int = PROFILER_DEFAULT_HZ) { return false; }
+    void stop() {}
+    void drain() {}
+    uint64_t dropped() const { return 0; }
+    std::vector<std::pair<std::string, uint64_t>> folded() const { return {}; }
+    bool writeFolded(const char*) const { return false; }
+    bool writeFlameGraph(const char*, const char*) const { return false; }
+};
+
+#endif
@@ -0,0 +1,86 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+//----------------------------------------------------------------------------
+// Adaptive Quality Governor (Section 0 – Frame Budget)
+//----------------------------------------------------------------------------
+// Watches CPU frame times and steps presentation quality down when the 95th
+// percentile goes over budget, then back up once there is clear headroom.
+// Tiers are ordered so the cheapest-to-lose detail goes first: parallax
+// layer count, then how often entities far from the player are redrawn at
+// their current position.  Every tier changes something game.cpp draws.
+//
+// Hysteresis: a step down needs DOWN_WINDOWS consecutive windows over
+// budget, a step up needs UP_WINDOWS consecutive windows under
+// UP_THRESHOLD × budget, and every change discards the samples taken at the
+// old tier.  This keeps the governor from oscillating around the budget.
+//
+// Quality settings are presentation-only.  The fixed-step simulation must
+// never read them, so replays and networked peers stay deterministic no
+// matter which tier a machine is running at.
+//
+
+struct QualitySettings {
+    int parallaxLayers;        // layers drawn, sky always included
+    int farEntityDivisor;      // far-away entities are redrawn every Nth frame
+};
+
+// Tier 0 is full quality; each later tier gives up one more thing.
+constexpr std::array<QualitySettings, 4> QUALITY_TIERS = {{
+    { 4, 1 },
+    { 2, 1 },
+    { 2, 2 },
+    { 1, 4 },
+}};
+
+struct QualityGovernor {
+    static constexpr int   WINDOW        = 60;     // frames per evaluation
+    static constexpr int   DOWN_WINDOWS  = 2;
+    static constexpr int   UP_WINDOWS    = 5;
+    static constexpr float UP_THRESHOLD  = 0.75f;
+    static constexpr float PERCENTILE    = 0.95f;
+
+    float budgetMs{ 14.0f };
+    int tier{ 0 };
+    std::array<float, WINDOW> samples{};
+    int count{ 0 };
+    int overStreak{ 0 };
+    int underStreak{ 0 };
+    float lastPercentileMs{ 0.0f };
+
+    const QualitySettings& settings() const { return QUALITY_TIERS[tier]; }
+
+    // Record one frame's CPU time.  Returns true if the tier changed.
+    bool addFrame(float frameMs) {
+        samples[count++] = frameMs;
+        if (count < WINDOW) return false;
+        count = 0;
+        std::array<float, WINDOW> sorted = samples;
+        auto nth = sorted.begin() + (int)(PERCENTILE * (WINDOW - 1));
+        std::nth_element(sorted.begin(), nth, sorted.end());
+        lastPercentileMs = *nth;
+
+        if (lastPercentileMs > budgetMs) {
+            underStreak = 0;
+            if (++overStreak >= DOWN_WINDOWS && tier + 1 < (int)QUALITY_TIERS.size()) {
+                ++tier;
+                overStreak = 0;
+                return true;
+            }
+        } else if (lastPercentileMs < budgetMs * UP_THRESHOLD) {
+            overStreak = 0;
+            if (++underStreak >= UP_WINDOWS && tier > 0) {
+                --tier;
+                underStreak = 0;
+                return true;
+            }
+        } else {
+            // Inside the dead band: hold the current tier
+            overStreak = 0;
+            underStreak = 0;
+        }
+        return false;
+    }
+};
@@ -0,0 +1,356 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+//----------------------------------------------------------------------------
+// Render Command Capture (Section 1 – Rendering)
+//----------------------------------------------------------------------------
+// Records the exact per-frame stream of render calls – every texture
+// create/upload/destroy, render target switch, draw colour and blend mode,
+// clear, rect fill, polyline and copy – into a binary file that
+// render_replay plays back against the SDL accelerated renderer, the SDL
+// software renderer or the SSE2 software rasterizer (soft_raster.h) and
+// times frame by frame.  Start the game with --capture=PATH.
+//
+// Code that draws calls the capture*() wrappers below instead of the SDL
+// functions of the same name.  Each wrapper makes the SDL call, then, while
+// a capture is open, appends a record; the records of one frame are
+// buffered and written with a single fwrite at capturePresent().  With no
+// capture open the cost is one predictable branch per call.
+//
+// Textures are referred to by a capture-local id assigned when they are
+// created through captureCreateTexture(); pixel uploads are stored in full
+// (tightly packed ARGB8888), so a capture is self-contained.  Calls on
+// textures created outside the wrappers are recorded with id 0 and skipped
+// on replay.
+//
+// File layout (little-endian):
+//   char[4]  magic        "RCAP"
+//   uint16_t version      RENDER_CAPTURE_VERSION
+//   uint16_t reserved
+//   uint32_t frameCount   patched at close; 0 if the game died mid-capture
+//   uint32_t reserved
+//   records:
+//     uint8_t  op         CaptureOp
+//     uint32_t size       payload bytes that follow
+//     payload             see CaptureOp
+//
+
+constexpr char     RENDER_CAPTURE_MAGIC[4] = { 'R', 'C', 'A', 'P' };
+constexpr uint16_t RENDER_CAPTURE_VERSION  = 1;
+constexpr size_t   RENDER_CAPTURE_HEADER_SIZE = 16;
+constexpr size_t   RENDER_CAPTURE_RECORD_HEADER = 5;
+
+enum class CaptureOp : uint8_t {
+    CreateTexture = 1,   // u32 id, u32 format, i32 access, i32 w, i32 h
+    DestroyTexture,      // u32 id
+    UpdateTexture,       // u32 id, i32 x, y, w, h, then w*h ARGB8888 pixels
+    TextureBlend,        // u32 id, u32 SDL_BlendMode
+    SetTarget,           // u32 id (0 = the window)
+    DrawColor,           // u8 r, g, b, a
+    DrawBlend,           // u32 SDL_BlendMode
+    Clear,               // (empty)
+    FillRects,           // u32 count, count × i32 x, y, w, h
+    DrawLines,           // u32 count, count × i32 x, y
+    Copy,                // u32 id, u8 flags (1 src, 2 dst), i32 src x, y, w, h, i32 dst x, y, w, h
+    Present              // i32 output w, h
+};
+
+struct RenderCapture {
+    struct TextureInfo {
+        uint32_t id;
+        int width, height;
+    };
+
+    FILE* file{ nullptr };
+    std::vector<uint8_t> frame;           // records since the last present
+    std::unordered_map<const SDL_Texture*, TextureInfo> textures;
+    uint32_t nextTextureId{ 1 };
+    uint32_t frames{ 0 };
+    uint64_t bytesWritten{ 0 };
+    bool failed{ false };
+
+    bool active() const { return file != nullptr; }
+
+    bool open(const char* path) {
+        close();
+        file = std::fopen(path, "wb");
+        if (!file) return false;
+        uint8_t header[RENDER_CAPTURE_HEADER_SIZE] = {};
+        std::memcpy(header, RENDER_CAPTURE_MAGIC, 4);
+        std::memcpy(header + 4, &RENDER_CAPTURE_VERSION, 2);
+        failed = std::fwrite(header, 1, sizeof(header), file) != sizeof(header);
+        frames = 0;
+        bytesWritten = sizeof(header);
+        frame.clear();
+        return !failed;
+    }
+
+    // Writes any records after the last present and patches the frame count;
+    // false if any write failed.
+    bool close() {
+        if (!file) return true;
+        flush();
+        if (std::fseek(file, 8, SEEK_SET) != 0 || std::fwrite(&frames, 4, 1, file) != 1) failed = true;
+        if (std::fclose(file) != 0) failed = true;
+        file = nullptr;
+        textures.clear();
+        nextTextureId = 1;
+        return !failed;
+    }
+
+    void flush() {
+        if (frame.empty()) return;
+        if (std::fwrite(frame.data(), 1, frame.size(), file) != frame.size()) failed = true;
+        bytesWritten += frame.size();
+        frame.clear();
+    }
+
+    // Appends a record header; the payload follows through put()
+    void begin(CaptureOp op, uint32_t size) {
+        frame.push_back((uint8_t)op);
+        put(&size, 4);
+    }
+    void put(const void* data, size_t size) {
+        const uint8_t* p = (const uint8_t*)data;
+        frame.insert(frame.end(), p, p + size);
+    }
+    void putU32(uint32_t v) { put(&v, 4); }
+    void putRect(const SDL_Rect& r) {
+        int32_t v[4] = { r.x, r.y, r.w, r.h };
+        put(v, sizeof(v));
+    }
+
+    uint32_t idOf(const SDL_Texture* texture) const {
+        auto it = textures.find(texture);
+        return it == textures.end() ? 0 : it->second.id;
+    }
+
+    void created(const SDL_Texture* texture, uint32_t format, int access, int w, int h) {
+        TextureInfo info{ nextTextureId++, w, h };
+        textures[texture] = info;
+        begin(CaptureOp::CreateTexture, 20);
+        int32_t v[5] = { (int32_t)info.id, (int32_t)format, access, w, h };
+        put(v, sizeof(v));
+    }
+
+    void destroyed(const SDL_Texture* texture) {
+        auto it = textures.find(texture);
+        if (it == textures.end()) return;
+        begin(CaptureOp::DestroyTexture, 4);
+        putU32(it->second.id);
+        textures.erase(it);
+    }
+
+    void updated(const SDL_Texture* texture, const SDL_Rect* rect, const void* pixels, int pitch) {
+        auto it = textures.find(texture);
+        if (it == textures.end()) return;
+        SDL_Rect r = rect ? *rect : SDL_Rect{ 0, 0, it->second.width, it->second.height };
+        begin(CaptureOp::UpdateTexture, 20 + (uint32_t)r.w * r.h * 4);
+        putU32(it->second.id);
+        putRect(r);
+        for (int y = 0; y < r.h; ++y) put((const uint8_t*)pixels + (size_t)y * pitch, (size_t)r.w * 4);
+    }
+
+    void presented(int outputW, int outputH) {
+        begin(CaptureOp::Present, 8);
+        int32_t v[2] = { outputW, outputH };
+        put(v, sizeof(v));
+        ++frames;
+        flush();
+    }
+};
+
+inline RenderCapture& renderCapture() {
+    static RenderCapture instance;
+    return instance;
+}
+
+// --capture=PATH, or nullptr when not capturing
+inline const char* parseCapturePath(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--capture=", 10) == 0) return argv[i] + 10;
+    }
+    return nullptr;
+}
+
+// Drop-in replacements for the SDL render calls the game makes
+inline SDL_Texture* captureCreateTexture(SDL_Renderer* renderer, Uint32 format, int access, int w, int h) {
+    SDL_Texture* texture = SDL_CreateTexture(renderer, format, access, w, h);
+    RenderCapture& c = renderCapture();
+    if (texture && c.active()) c.created(texture, format, access, w, h);
+    return texture;
+}
+
+inline void captureDestroyTexture(SDL_Texture* texture) {
+    RenderCapture& c = renderCapture();
+    if (c.active()) c.destroyed(texture);
+    SDL_DestroyTexture(texture);
+}
+
+inline int captureUpdateTexture(SDL_Texture* texture, const SDL_Rect* rect, const void* pixels, int pitch) {
+    RenderCapture& c = renderCapture();
+    if (c.active()) c.updated(texture, rect, pixels, pitch);
+    return SDL_UpdateTexture(texture, rect, pixels, pitch);
+}
+
+inline int captureTextureBlendMode(SDL_Texture* texture, SDL_BlendMode mode) {
+    RenderCapture& c = renderCapture();
+    if (c.active()) {
+        c.begin(CaptureOp::TextureBlend, 8);
+        c.putU32(c.idOf(texture));
+        c.putU32((uint32_t)mode);
+    }
+    return SDL_SetTextureBlendMode(texture, mode);
+}
+
+inline int captureSetTarget(SDL_Renderer* renderer, SDL_Texture* texture) {
+    RenderCapture& c = renderCapture();
+    if (c.active()) {
+        c.begin(CaptureOp::SetTarget, 4);
+        c.putU32(texture ? c.idOf(texture) : 0);
+    }
+    return SDL_SetRenderTarget(renderer, texture);
+}
+
+inline int captureDrawColor(SDL_Renderer* renderer, Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
+    RenderCapture& c = renderCapture();
+    if (c.active()) {
+        const uint8_t v[4] = { r, g, b, a };
+        c.begin(CaptureOp::DrawColor, 4);
+        c.put(v, 4);
+    }
+    return SDL_SetRenderDrawColor(renderer, r, g, b, a);
+}
+
+inline int captureDrawBlendMode(SDL_Renderer* renderer, SDL_BlendMode mode) {
+    RenderCapture& c = renderCapture();
+    if (c.active()) {
+        c.begin(CaptureOp::DrawBlend, 4);
+        c.putU32((uint32_t)mode);
+    }
+    return SDL_SetRenderDrawBlendMode(renderer, mode);
+}
+
+inline int captureClear(SDL_Renderer* renderer) {
+    RenderCapture& c = renderCapture();
+    if (c.active()) c.begin(CaptureOp::Clear, 0);
+    return SDL_RenderClear(renderer);
+}
+
+inline int captureFillRects(SDL_Renderer* renderer, const SDL_Rect* rects, int count) {
+    RenderCapture& c = renderCapture();
+    if (c.active() && count > 0) {
+        c.begin(CaptureOp::FillRects, 4 + (uint32_t)count * 16);
+        c.putU32((uint32_t)count);
+        for (int i = 0; i < count; ++i) c.putRect(rects[i]);
+    }
+    return SDL_RenderFillRects(renderer, rects, count);
+}
+
+inline int captureFillRect(SDL_Renderer* renderer, const SDL_Rect* rect) {
+    RenderCapture& c = renderCapture();
+    if (c.active()) {
+        int w = 0, h = 0;
+        // A null rect fills the whole target
+        if (!rect) SDL_GetRendererOutputSize(renderer, &w, &h);
+        c.begin(CaptureOp::FillRects, 20);
+        c.putU32(1);
+        c.putRect(rect ? *rect : SDL_Rect{ 0, 0, w, h });
+    }
+    return SDL_RenderFillRect(renderer, rect);
+}
+
+inline int captureDrawLines(SDL_Renderer* renderer, const SDL_Point* points, int count) {
+    RenderCapture& c = renderCapture();
+    if (c.active() && count > 0) {
+        c.begin(CaptureOp::DrawLines, 4 + (uint32_t)count * 8);
+        c.putU32((uint32_t)count);
+        for (int i = 0; i < count; ++i) {
+            int32_t v[2] = { points[i].x, points[i].y };
+            c.put(v, sizeof(v));
+        }
+    }
+    return SDL_RenderDrawLines(renderer, points, count);
+}
+
+inline int captureCopy(SDL_Renderer* renderer, SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect* dst) {
+    RenderCapture& c = renderCapture();
+    if (c.active()) {
+        c.begin(CaptureOp::Copy, 37);
+        c.putU32(c.idOf(texture));
+        const uint8_t flags = (src ? 1 : 0) | (dst ? 2 : 0);
+        c.put(&flags, 1);
+        c.putRect(src ? *src : SDL_Rect{});
+        c.putRect(dst ? *dst : SDL_Rect{});
+    }
+    return SDL_RenderCopy(renderer, texture, src, dst);
+}
+
+inline void capturePresent(SDL_Renderer* renderer) {
+    RenderCapture& c = renderCapture();
+    if (c.active()) {
+        int w = 0, h = 0;
+        SDL_GetRendererOutputSize(renderer, &w, &h);
+        c.presented(w, h);
+    }
+    SDL_RenderPresent(renderer);
+}
+
+//----------------------------------------------------------------------------
+// Reading a capture back
+//----------------------------------------------------------------------------
+
+struct CaptureRecord {
+    CaptureOp op;
+    const uint8_t* data;
+    uint32_t size;
+
+    int32_t i32(size_t offset) const {
+        int32_t v;
+        std::memcpy(&v, data + offset, 4);
+        return v;
+    }
+    uint32_t u32(size_t offset) const { return (uint32_t)i32(offset); }
+    SDL_Rect rect(size_t offset) const { return { i32(offset), i32(offset + 4), i32(offset + 8), i32(offset + 12) }; }
+};
+
+// A view over a capture in memory (e.g. a MappedFile); records are read in
+// place with next().
+struct RenderCaptureView {
+    const uint8_t* data{ nullptr };
+    size_t size{ 0 };
+    size_t cursor{ 0 };
+    uint32_t frameCount{ 0 };
+
+    bool parse(const uint8_t* bytes, size_t length) {
+        if (length < RENDER_CAPTURE_HEADER_SIZE || std::memcmp(bytes, RENDER_CAPTURE_MAGIC, 4) != 0) return false;
+        uint16_t version;
+        std::memcpy(&version, bytes + 4, 2);
+        if (version != RENDER_CAPTURE_VERSION) return false;
+        std::memcpy(&frameCount, bytes + 8, 4);
+        data = bytes;
+        size = length;
+        rewind();
+        return true;
+    }
+
+    void rewind() { cursor = RENDER_CAPTURE_HEADER_SIZE; }
+
+    // False at the end of the stream or at a truncated record
+    bool next(CaptureRecord& r) {
+        if (size - cursor < RENDER_CAPTURE_RECORD_HEADER) return false;
+        uint32_t payload;
+        std::memcpy(&payload, data + cursor + 1, 4);
+        if (size - cursor - RENDER_CAPTURE_RECORD_HEADER < payload) return false;
+        r.op = (CaptureOp)data[cursor];
+        r.data = data + cursor + RENDER_CAPTURE_RECORD_HEADER;
+        r.size = payload;
+        cursor += RENDER_CAPTURE_RECORD_HEADER + payload;
+        return true;
+    }
+};
@@ -0,0 +1,144 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <vector>
+
+//----------------------------------------------------------------------------
+// Render Command Queue (Section 1 – Rendering)
+//----------------------------------------------------------------------------
+// Draw calls are recorded as plain commands instead of going straight to
+// SDL.  While recording, the queue folds every command (and the camera) into
+// a 64-bit FNV-1a hash.  At the end of the frame, shouldPresent() compares
+// that hash with the last frame actually presented: if they match and
+// nothing outside the stream (window exposure, resize, texture contents)
+// was invalidated, the frame would be pixel-identical and both the submit
+// and the present are skipped.  Loops use isIdle() to block in
+// SDL_WaitEventTimeout instead of spinning.
+//
+// The hash covers texture handles, not texture pixels: code that rewrites
+// a texture in place must call invalidate().
+//
+
+enum class RenderOp : uint8_t {
+    Clear,
+    SetColor,
+    FillRect,
+    Copy
+};
+
+struct RenderCommand {
+    RenderOp op;
+    SDL_Color color;
+    SDL_Texture* texture;
+    SDL_Rect src;
+    SDL_Rect dst;
+    bool hasSrc;
+    bool hasDst;
+};
+
+struct RenderQueue {
+    std::vector<RenderCommand> commands;
+    uint64_t hash{ FNV_OFFSET };
+    uint64_t presentedHash{ 0 };
+    bool forceRedraw{ true };
+    bool idle{ false };
+    uint64_t framesSkipped{ 0 };
+
+    static constexpr uint64_t FNV_OFFSET = 0xCBF29CE484222325ull;
+    static constexpr uint64_t FNV_PRIME  = 0x100000001B3ull;
+
+    void mix(const void* data, size_t size) {
+        const uint8_t* p = (const uint8_t*)data;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= p[i];
+            hash *= FNV_PRIME;
+        }
+    }
+    void mixRect(const SDL_Rect& r) {
+        int32_t v[4] = { r.x, r.y, r.w, r.h };
+        mix(v, sizeof(v));
+    }
+
+    // Start a new frame.  The camera is part of the frame identity.
+    void begin(float cameraX = 0.0f, float cameraY = 0.0f) {
+        commands.clear();
+        hash = FNV_OFFSET;
+        mix(&cameraX, sizeof(cameraX));
+        mix(&cameraY, sizeof(cameraY));
+    }
+
+    void clear(Uint8 r, Uint8 g, Uint8 b, Uint8 a = 255) {
+        push({ RenderOp::Clear, { r, g, b, a }, nullptr, {}, {}, false, false });
+    }
+    void setColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a = 255) {
+        push({ RenderOp::SetColor, { r, g, b, a }, nullptr, {}, {}, false, false });
+    }
+    void fillRect(const SDL_Rect& dst) {
+        push({ RenderOp::FillRect, {}, nullptr, {}, dst, false, true });
+    }
+    void copy(SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect* dst) {
+        push({ RenderOp::Copy, {}, texture, src ? *src : SDL_Rect{}, dst ? *dst : SDL_Rect{},
+               src != nullptr, dst != nullptr });
+    }
+
+    void push(const RenderCommand& c) {
+        commands.push_back(c);
+        uint8_t head[6] = { (uint8_t)c.op, c.color.r, c.color.g, c.color.b, c.color.a,
+                            (uint8_t)(c.hasSrc | c.hasDst << 1) };
+        mix(head, sizeof(head));
+        if (c.texture) mix(&c.texture, sizeof(c.texture));
+        if (c.hasSrc) mixRect(c.src);
+        if (c.hasDst) mixRect(c.dst);
+    }
+
+    // Something the command stream cannot see changed; redraw next frame.
+    void invalidate() { forceRedraw = true; }
+
+    // Feed window events through here so exposure/resize forces a redraw.
+    void handleEvent(const SDL_Event& ev) {
+        if (ev.type == SDL_WINDOWEVENT &&
+            (ev.window.event == SDL_WINDOWEVENT_EXPOSED ||
+             ev.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)) {
+            invalidate();
+        } else if (ev.type == SDL_RENDER_TARGETS_RESET || ev.type == SDL_RENDER_DEVICE_RESET) {
+            invalidate();
+        }
+    }
+
+    // True if this frame differs from the last presented one.  Updates idle
+    // state: a skipped frame means the caller may block for events.
+    bool shouldPresent() {
+        if (!forceRedraw && hash == presentedHash) {
+            idle = true;
+            ++framesSkipped;
+            return false;
+        }
+        idle = false;
+        return true;
+    }
+
+    bool isIdle() const { return idle; }
+
+    // Replay the recorded commands into SDL and remember what was presented.
+    void submit(SDL_Renderer* renderer) {
+        for (const RenderCommand& c : commands) {
+            switch (c.op) {
+                case RenderOp::Clear:
+                    SDL_SetRenderDrawColor(renderer, c.color.r, c.color.g, c.color.b, c.color.a);
+                    SDL_RenderClear(renderer);
+                    break;
+                case RenderOp::SetColor:
+                    SDL_SetRenderDrawColor(renderer, c.color.r, c.color.g, c.color.b, c.color.a);
+                    break;
+                case RenderOp::FillRect:
+                    SDL_RenderFillRect(renderer, &c.dst);
+                    break;
+                case RenderOp::Copy:
+                    SDL_RenderCopy(renderer, c.texture, c.hasSrc ? &c.src : nullptr, c.hasDst ? &c.dst : nullptr);
+                    break;
+            }
+        }
+        presentedHash = hash;
+        forceRedraw = false;
+    }
+};
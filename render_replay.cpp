@@ -0,0 +1,445 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "mapped_file.h"
+#include "render_capture.h"
+#include "soft_raster.h"
+
+// Render Capture Player (Section 1 – Rendering)
+// Plays a capture written by the game's --capture=PATH (render_capture.h)
+// against one backend and times every frame, from its first command to
+// the end of its present:
+//   accel     SDL's accelerated renderer in a hidden window
+//   software  SDL's software renderer drawing into a memory surface
+//   simd      the SSE2 software rasterizer (soft_raster.h)
+// Texture uploads are replayed where they happened, so frames that built
+// tile chunks cost what they cost in the game.  Prints frame-time
+// percentiles and a hash of the last frame (backends that agree pixel for
+// pixel print the same hash); --csv prints one line per frame instead,
+// --ppm writes the last frame as an image.  The accelerated renderer queues
+// work on the GPU; --sync reads a pixel back before each present so its
+// times include the GPU.
+//
+// Build: g++ -O2 -std=c++17 render_replay.cpp -o render_replay `sdl2-config --cflags --libs`
+// Usage: render_replay CAPTURE [--backend accel|software|simd] [--loops N] [--sync] [--csv] [--ppm PATH]
+
+// Capture ids and sizes come from the file; anything past these is treated
+// as corrupt rather than allocated.
+constexpr uint32_t MAX_TEXTURE_ID   = 1u << 20;
+constexpr int      MAX_TEXTURE_SIZE = 16384;
+
+static bool validTexture(uint32_t id, int w, int h) {
+    return id > 0 && id <= MAX_TEXTURE_ID && w > 0 && h > 0 && w <= MAX_TEXTURE_SIZE && h <= MAX_TEXTURE_SIZE;
+}
+
+struct SdlBackend {
+    SDL_Window* window{ nullptr };
+    SDL_Surface* surface{ nullptr };
+    SDL_Renderer* renderer{ nullptr };
+    std::vector<SDL_Texture*> textures;    // by capture id
+    int width{ 0 };
+    int height{ 0 };
+
+    bool create(bool accelerated, int w, int h) {
+        width = w;
+        height = h;
+        SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "0");
+        if (accelerated) {
+            window = SDL_CreateWindow("render_replay", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, w, h,
+                                      SDL_WINDOW_HIDDEN);
+            if (window) renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE);
+        } else {
+            surface = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888);
+            if (surface) renderer = SDL_CreateSoftwareRenderer(surface);
+        }
+        return renderer != nullptr;
+    }
+
+    void destroy() {
+        reset();
+        if (renderer) SDL_DestroyRenderer(renderer);
+        if (surface) SDL_FreeSurface(surface);
+        if (window) SDL_DestroyWindow(window);
+        renderer = nullptr;
+        surface = nullptr;
+        window = nullptr;
+    }
+
+    void reset() {
+        for (SDL_Texture* t : textures) {
+            if (t) SDL_DestroyTexture(t);
+        }
+        textures.clear();
+        if (renderer) SDL_SetRenderTarget(renderer, nullptr);
+    }
+
+    SDL_Texture* texture(uint32_t id) const { return id < textures.size() ? textures[id] : nullptr; }
+
+    void createTexture(uint32_t id, uint32_t format, int access, int w, int h) {
+        if (id >= textures.size()) textures.resize(id + 1, nullptr);
+        if (textures[id]) SDL_DestroyTexture(textures[id]);
+        textures[id] = SDL_CreateTexture(renderer, format, access, w, h);
+    }
+    void destroyTexture(uint32_t id) {
+        if (SDL_Texture* t = texture(id)) SDL_DestroyTexture(t);
+        if (id < textures.size()) textures[id] = nullptr;
+    }
+    void updateTexture(uint32_t id, const SDL_Rect& r, const uint8_t* pixels) {
+        if (SDL_Texture* t = texture(id)) SDL_UpdateTexture(t, &r, pixels, r.w * 4);
+    }
+    void textureBlend(uint32_t id, SDL_BlendMode mode) {
+        if (SDL_Texture* t = texture(id)) SDL_SetTextureBlendMode(t, mode);
+    }
+    void setTarget(uint32_t id) { SDL_SetRenderTarget(renderer, texture(id)); }
+    void drawColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a) { SDL_SetRenderDrawColor(renderer, r, g, b, a); }
+    void drawBlend(SDL_BlendMode mode) { SDL_SetRenderDrawBlendMode(renderer, mode); }
+    void clear() { SDL_RenderClear(renderer); }
+    void fillRects(const SDL_Rect* rects, int count) { SDL_RenderFillRects(renderer, rects, count); }
+    void drawLines(const SDL_Point* points, int count) { SDL_RenderDrawLines(renderer, points, count); }
+    void copy(uint32_t id, const SDL_Rect* src, const SDL_Rect* dst) {
+        if (SDL_Texture* t = texture(id)) SDL_RenderCopy(renderer, t, src, dst);
+    }
+    void present(bool sync) {
+        if (sync) {
+            uint32_t pixel;
+            SDL_Rect one = { 0, 0, 1, 1 };
+            SDL_RenderReadPixels(renderer, &one, SDL_PIXELFORMAT_ARGB8888, &pixel, 4);
+        }
+        SDL_RenderPresent(renderer);
+    }
+    // The window's pixels; call before present (the back buffer is undefined after)
+    void readPixels(std::vector<uint32_t>& out) {
+        out.assign((size_t)width * height, 0);
+        SDL_RenderReadPixels(renderer, nullptr, SDL_PIXELFORMAT_ARGB8888, out.data(), width * 4);
+    }
+};
+
+struct SoftBackend {
+    SoftSurface window;
+    std::vector<SoftSurface> textures;     // by capture id; textures[0] is unused
+    std::vector<uint8_t> textureBlends;
+    uint32_t targetId{ 0 };               // 0 = the window
+    uint32_t color{ 0xFF000000u };
+    bool blend{ false };
+    std::vector<uint32_t> scratch;
+
+    bool create(bool, int w, int h) {
+        window.resize(w, h);
+        return true;
+    }
+    void destroy() { reset(); }
+
+    void reset() {
+        textures.clear();
+        textureBlends.clear();
+        targetId = 0;
+        color = 0xFF000000u;
+        blend = false;
+    }
+
+    SoftSurface* texture(uint32_t id) {
+        return id > 0 && id < textures.size() && textures[id].width > 0 ? &textures[id] : nullptr;
+    }
+    SoftSurface& target() {
+        SoftSurface* t = texture(targetId);
+        return t ? *t : window;
+    }
+
+    void createTexture(uint32_t id, uint32_t, int, int w, int h) {
+        if (id >= textures.size()) {
+            textures.resize(id + 1);
+            textureBlends.resize(id + 1, 0);
+        }
+        textures[id].resize(w, h);
+        textureBlends[id] = 0;
+    }
+    void destroyTexture(uint32_t id) {
+        if (SoftSurface* t = texture(id)) *t = SoftSurface();
+    }
+    void updateTexture(uint32_t id, const SDL_Rect& r, const uint8_t* pixels) {
+        SoftSurface* t = texture(id);
+        if (!t) return;
+        SoftRect clip = { r.x, r.y, r.w, r.h };
+        if (!clipToSurface(*t, clip)) return;
+        for (int y = clip.y; y < clip.y + clip.h; ++y) {
+            std::memcpy(t->row(y) + clip.x, pixels + ((size_t)(y - r.y) * r.w + (clip.x - r.x)) * 4,
+                        (size_t)clip.w * 4);
+        }
+    }
+    void textureBlend(uint32_t id, SDL_BlendMode mode) {
+        if (texture(id)) textureBlends[id] = mode == SDL_BLENDMODE_BLEND;
+    }
+    void setTarget(uint32_t id) { targetId = id; }
+    void drawColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+        color = (uint32_t)a << 24 | (uint32_t)r << 16 | (uint32_t)g << 8 | b;
+    }
+    void drawBlend(SDL_BlendMode mode) { blend = mode == SDL_BLENDMODE_BLEND; }
+    void clear() { softClear(target(), color); }
+    void fillRects(const SDL_Rect* rects, int count) {
+        for (int i = 0; i < count; ++i) softFillRect(target(), { rects[i].x, rects[i].y, rects[i].w, rects[i].h }, color, blend);
+    }
+    void drawLines(const SDL_Point* points, int count) {
+        SoftSurface& out = target();
+        if (count == 1) softDrawLine(out, points[0].x, points[0].y, points[0].x, points[0].y, color, blend);
+        for (int i = 0; i + 1 < count; ++i) {
+            softDrawLine(out, points[i].x, points[i].y, points[i + 1].x, points[i + 1].y, color, blend);
+        }
+    }
+    void copy(uint32_t id, const SDL_Rect* src, const SDL_Rect* dst) {
+        SoftSurface* t = texture(id);
+        SoftSurface& out = target();
+        if (!t || t == &out) return;
+        SoftRect s = src ? SoftRect{ src->x, src->y, src->w, src->h } : SoftRect{};
+        SoftRect d = dst ? SoftRect{ dst->x, dst->y, dst->w, dst->h } : SoftRect{};
+        softCopy(out, *t, src ? &s : nullptr, dst ? &d : nullptr, textureBlends[id] != 0, scratch);
+    }
+    void present(bool) {}
+    void readPixels(std::vector<uint32_t>& out) { out = window.pixels; }
+};
+
+struct FrameTime {
+    double ms;
+    uint32_t records;
+    uint32_t uploadBytes;
+};
+
+// Replays the whole capture once; the last frame's pixels go to `lastFrame`
+// when it is non-null.
+template <typename Backend>
+static void replayOnce(RenderCaptureView& view, Backend& backend, bool sync, uint32_t frameCount,
+                       std::vector<FrameTime>& times, std::vector<uint32_t>* lastFrame) {
+    std::vector<SDL_Rect> rects;
+    std::vector<SDL_Point> points;
+    view.rewind();
+    backend.reset();
+    FrameTime frame{ 0.0, 0, 0 };
+    uint32_t frameIndex = 0;
+    auto start = std::chrono::steady_clock::now();
+    CaptureRecord r;
+    while (view.next(r)) {
+        ++frame.records;
+        switch (r.op) {
+        case CaptureOp::CreateTexture:
+            if (r.size >= 20 && validTexture(r.u32(0), r.i32(12), r.i32(16))) {
+                backend.createTexture(r.u32(0), r.u32(4), r.i32(8), r.i32(12), r.i32(16));
+            }
+            break;
+        case CaptureOp::DestroyTexture:
+            if (r.size >= 4) backend.destroyTexture(r.u32(0));
+            break;
+        case CaptureOp::UpdateTexture: {
+            if (r.size < 20) break;
+            SDL_Rect rect = r.rect(4);
+            if (rect.w <= 0 || rect.h <= 0 || r.size - 20 < (uint64_t)rect.w * rect.h * 4) break;
+            backend.updateTexture(r.u32(0), rect, r.data + 20);
+            frame.uploadBytes += r.size - 20;
+            break;
+        }
+        case CaptureOp::TextureBlend:
+            if (r.size >= 8) backend.textureBlend(r.u32(0), (SDL_BlendMode)r.u32(4));
+            break;
+        case CaptureOp::SetTarget:
+            if (r.size >= 4) backend.setTarget(r.u32(0));
+            break;
+        case CaptureOp::DrawColor:
+            if (r.size >= 4) backend.drawColor(r.data[0], r.data[1], r.data[2], r.data[3]);
+            break;
+        case CaptureOp::DrawBlend:
+            if (r.size >= 4) backend.drawBlend((SDL_BlendMode)r.u32(0));
+            break;
+        case CaptureOp::Clear:
+            backend.clear();
+            break;
+        case CaptureOp::FillRects: {
+            uint32_t count = r.size >= 4 ? r.u32(0) : 0;
+            if (count == 0 || (r.size - 4) / 16 < count) break;
+            rects.resize(count);
+            for (uint32_t i = 0; i < count; ++i) rects[i] = r.rect(4 + (size_t)i * 16);
+            backend.fillRects(rects.data(), (int)count);
+            break;
+        }
+        case CaptureOp::DrawLines: {
+            uint32_t count = r.size >= 4 ? r.u32(0) : 0;
+            if (count == 0 || (r.size - 4) / 8 < count) break;
+            points.resize(count);
+            for (uint32_t i = 0; i < count; ++i) points[i] = { r.i32(4 + (size_t)i * 8), r.i32(8 + (size_t)i * 8) };
+            backend.drawLines(points.data(), (int)count);
+            break;
+        }
+        case CaptureOp::Copy: {
+            if (r.size < 37) break;
+            const uint8_t flags = r.data[4];
+            SDL_Rect src = r.rect(5), dst = r.rect(21);
+            backend.copy(r.u32(0), flags & 1 ? &src : nullptr, flags & 2 ? &dst : nullptr);
+            break;
+        }
+        case CaptureOp::Present:
+            if (lastFrame && frameIndex + 1 == frameCount) backend.readPixels(*lastFrame);
+            backend.present(sync);
+            frame.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            times.push_back(frame);
+            frame = { 0.0, 0, 0 };
+            ++frameIndex;
+            start = std::chrono::steady_clock::now();
+            break;
+        default:
+            break;    // unknown records are skipped by size
+        }
+    }
+}
+
+static uint64_t hashPixels(const std::vector<uint32_t>& pixels) {
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (uint32_t p : pixels) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            h ^= (p >> shift) & 0xFF;
+            h *= 0x100000001B3ull;
+        }
+    }
+    return h;
+}
+
+static bool writePpm(const char* path, const std::vector<uint32_t>& pixels, int w, int h) {
+    FILE* f = std::fopen(path, "wb");
+    if (!f) return false;
+    std::fprintf(f, "P6\n%d %d\n255\n", w, h);
+    std::vector<uint8_t> row((size_t)w * 3);
+    bool ok = true;
+    for (int y = 0; y < h && ok; ++y) {
+        for (int x = 0; x < w; ++x) {
+            uint32_t p = pixels[(size_t)y * w + x];
+            row[x * 3] = (uint8_t)(p >> 16);
+            row[x * 3 + 1] = (uint8_t)(p >> 8);
+            row[x * 3 + 2] = (uint8_t)p;
+        }
+        ok = std::fwrite(row.data(), 1, row.size(), f) == row.size();
+    }
+    return std::fclose(f) == 0 && ok;
+}
+
+static double percentile(std::vector<double> sorted, double fraction) {
+    size_t i = std::min(sorted.size() - 1, (size_t)(fraction * (sorted.size() - 1) + 0.5));
+    return sorted[i];
+}
+
+template <typename Backend>
+static int run(RenderCaptureView& view, bool accelerated, int w, int h, uint32_t frameCount, int loops, bool sync,
+               bool csv, const char* ppm) {
+    Backend backend;
+    if (!backend.create(accelerated, w, h)) {
+        std::fprintf(stderr, "could not create the renderer: %s\n", SDL_GetError());
+        backend.destroy();
+        return 1;
+    }
+    std::vector<FrameTime> times;
+    std::vector<uint32_t> lastFrame;
+    for (int loop = 0; loop < loops; ++loop) {
+        replayOnce(view, backend, sync, frameCount, times, loop + 1 == loops ? &lastFrame : nullptr);
+    }
+    backend.destroy();
+    if (times.empty()) {
+        std::fprintf(stderr, "capture has no complete frames\n");
+        return 1;
+    }
+    if (csv) {
+        std::printf("loop,frame,ms,records,upload_bytes\n");
+        for (size_t i = 0; i < times.size(); ++i) {
+            std::printf("%zu,%zu,%.4f,%u,%u\n", i / frameCount, i % frameCount, times[i].ms, times[i].records,
+                        times[i].uploadBytes);
+        }
+    } else {
+        std::vector<double> ms;
+        double total = 0.0;
+        uint64_t uploads = 0, records = 0;
+        size_t worst = 0;
+        for (size_t i = 0; i < times.size(); ++i) {
+            ms.push_back(times[i].ms);
+            total += times[i].ms;
+            uploads += times[i].uploadBytes;
+            records += times[i].records;
+            if (times[i].ms > times[worst].ms) worst = i;
+        }
+        std::sort(ms.begin(), ms.end());
+        std::printf("%zu frames (%d loops), %.1f records/frame, %.2f MB uploaded\n", times.size(), loops,
+                    (double)records / times.size(), uploads / (1024.0 * 1024.0));
+        std::printf("%10s %10s %10s %10s %10s %10s\n", "mean ms", "p50", "p95", "p99", "max", "max frame");
+        std::printf("%10.4f %10.4f %10.4f %10.4f %10.4f %10zu\n", total / times.size(), percentile(ms, 0.50),
+                    percentile(ms, 0.95), percentile(ms, 0.99), ms.back(), worst % frameCount);
+    }
+    if (!lastFrame.empty()) {
+        std::fprintf(csv ? stderr : stdout, "last frame %dx%d hash %016llx\n", w, h,
+                     (unsigned long long)hashPixels(lastFrame));
+        if (ppm && !writePpm(ppm, lastFrame, w, h)) {
+            std::fprintf(stderr, "failed to write %s\n", ppm);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    const char* backendName = "simd";
+    const char* ppm = nullptr;
+    int loops = 1;
+    bool sync = false, csv = false, bad = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--backend") == 0 && i + 1 < argc) backendName = argv[++i];
+        else if (std::strcmp(argv[i], "--loops") == 0 && i + 1 < argc) loops = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--ppm") == 0 && i + 1 < argc) ppm = argv[++i];
+        else if (std::strcmp(argv[i], "--sync") == 0) sync = true;
+        else if (std::strcmp(argv[i], "--csv") == 0) csv = true;
+        else if (argv[i][0] != '-' && !path) path = argv[i];
+        else bad = true;
+    }
+    const bool accel = std::strcmp(backendName, "accel") == 0;
+    const bool software = std::strcmp(backendName, "software") == 0;
+    const bool simd = std::strcmp(backendName, "simd") == 0;
+    if (bad || !path || !(accel || software || simd)) {
+        std::fprintf(stderr, "usage: %s CAPTURE [--backend accel|software|simd] [--loops N] [--sync] [--csv] [--ppm PATH]\n",
+                     argv[0]);
+        return 1;
+    }
+    MappedFile file;
+    RenderCaptureView view;
+    if (!file.open(path) || !view.parse(file.data, file.size)) {
+        std::fprintf(stderr, "%s is not a render capture (version %u)\n", path, RENDER_CAPTURE_VERSION);
+        return 1;
+    }
+    // Frame count and window size from the presents (the header count is 0
+    // when the game did not exit cleanly)
+    uint32_t frameCount = 0;
+    int w = 0, h = 0;
+    CaptureRecord r;
+    while (view.next(r)) {
+        if (r.op != CaptureOp::Present || r.size < 8) continue;
+        if (frameCount++ == 0) {
+            w = r.i32(0);
+            h = r.i32(4);
+        }
+    }
+    if (frameCount == 0 || w <= 0 || h <= 0) {
+        std::fprintf(stderr, "%s has no complete frames\n", path);
+        return 1;
+    }
+    std::fprintf(csv ? stderr : stdout, "%s: %u frames at %dx%d, backend %s%s\n", path, frameCount, w, h, backendName,
+#if defined(SOFT_RASTER_HAS_SSE2)
+                 simd ? " (SSE2)" : ""
+#else
+                 simd ? " (scalar)" : ""
+#endif
+    );
+    if (SDL_Init(accel ? SDL_INIT_VIDEO : 0) != 0) {
+        std::fprintf(stderr, "SDL_Init failed: %s\n", SDL_GetError());
+        return 1;
+    }
+    int status = simd ? run<SoftBackend>(view, false, w, h, frameCount, loops, sync, csv, ppm)
+                      : run<SdlBackend>(view, accel, w, h, frameCount, loops, sync, csv, ppm);
+    SDL_Quit();
+    return status;
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cstdint>
+#include "render_capture.h"
+
+//----------------------------------------------------------------------------
+// Render Target Management (Section 0 – Native Resolution)
+//----------------------------------------------------------------------------
+// The game is drawn into a fixed NATIVE_W×NATIVE_H target texture which is
+// then copied to the window at the largest integer scale that fits the
+// renderer's output, letterboxed and centered.  Output size is queried in
+// pixels (SDL_GetRendererOutputSize) so HiDPI windows get their real scale.
+//
+// Window events only mark the target dirty; the output size is re-queried
+// once per frame while dirty and nothing is reallocated unless the pixel size
+// or integer scale actually changed.  The native texture itself never depends
+// on the window, so dragging a window edge never recreates it – it is only
+// rebuilt when the driver reports that target contents were lost.
+//
+
+struct RenderTarget {
+    SDL_Renderer* renderer{ nullptr };
+    SDL_Texture*  native{ nullptr };
+    int nativeW{ 0 };
+    int nativeH{ 0 };
+    int outputW{ 0 };
+    int outputH{ 0 };
+    int scale{ 0 };                 // integer upscale applied to the native target
+    SDL_Rect viewport{};            // destination rect of the native target in output pixels
+    bool dirty{ true };
+    bool lost{ false };
+
+    bool create(SDL_Renderer* r, int w, int h) {
+        renderer = r;
+        nativeW = w;
+        nativeH = h;
+        // Pixel art: nearest filtering for the upscale copy
+        SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "0");
+        native = captureCreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+                                      SDL_TEXTUREACCESS_TARGET, nativeW, nativeH);
+        if (!native) {
+            SDL_Log("SDL_CreateTexture (native target) failed: %s", SDL_GetError());
+            return false;
+        }
+        dirty = true;
+        refresh();
+        return true;
+    }
+
+    void destroy() {
+        if (native) captureDestroyTexture(native);
+        native = nullptr;
+    }
+
+    // Feed every polled event through here; it never touches the GPU.
+    void handleEvent(const SDL_Event& ev) {
+        if (ev.type == SDL_WINDOWEVENT) {
+            if (ev.window.event == SDL_WINDOWEVENT_SIZE_CHANGED ||
+                ev.window.event == SDL_WINDOWEVENT_DISPLAY_CHANGED) {
+                dirty = true;
+            }
+        } else if (ev.type == SDL_RENDER_TARGETS_RESET || ev.type == SDL_RENDER_DEVICE_RESET) {
+            lost = true;
+            dirty = true;
+        }
+    }
+
+    // Call once per frame before drawing.  Returns true if the integer scale
+    // changed (i.e. output-resolution caches must be rebuilt).
+    bool refresh() {
+        if (!dirty) return false;
+        dirty = false;
+        if (lost) {
+            lost = false;
+            destroy();
+            native = captureCreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+                                          SDL_TEXTUREACCESS_TARGET, nativeW, nativeH);
+        }
+        int w = 0, h = 0;
+        if (SDL_GetRendererOutputSize(renderer, &w, &h) != 0) return false;
+        if (w == outputW && h == outputH) return false;
+        outputW = w;
+        outputH = h;
+        int s = std::min(outputW / nativeW, outputH / nativeH);
+        if (s < 1) s = 1;
+        // Output smaller than native: shrink to fit rather than crop
+        int dstW = nativeW * s;
+        int dstH = nativeH * s;
+        if (dstW > outputW || dstH > outputH) {
+            if (outputW * nativeH < outputH * nativeW) {
+                dstW = outputW;
+                dstH = outputW * nativeH / nativeW;
+            } else {
+                dstH = outputH;
+                dstW = outputH * nativeW / nativeH;
+            }
+        }
+        viewport = { (outputW - dstW) / 2, (outputH - dstH) / 2, dstW, dstH };
+        if (s == scale) return false;
+        scale = s;
+        return true;
+    }
+
+    // Redirect drawing into the native target; coordinates are native pixels.
+    void begin() {
+        captureSetTarget(renderer, native);
+    }
+
+    // Upscale the native target into the letterboxed viewport and present.
+    void present() {
+        captureSetTarget(renderer, nullptr);
+        captureDrawColor(renderer, 0, 0, 0, 255);
+        captureClear(renderer);
+        captureCopy(renderer, native, nullptr, &viewport);
+        capturePresent(renderer);
+    }
+};
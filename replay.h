@@ -0,0 +1,112 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "sim.h"
+
+//----------------------------------------------------------------------------
+// Input Replays (Section 4 – Input Recording)
+//----------------------------------------------------------------------------
+// The simulation is deterministic for a given tick rate, so a replay only
+// stores the header and one byte of PlayerInput per tick; resimulating the
+// inputs through sim.h reproduces the run exactly.
+//
+// File layout (little endian, 24-byte header):
+//   char     magic[4]     "RPLY"
+//   uint16_t version      REPLAY_VERSION
+//   uint16_t tickHz       60, 120 or 240
+//   uint64_t levelSeed
+//   uint32_t levelId
+//   uint32_t tickCount
+//   uint8_t  input[tickCount]   bit 0 left, bit 1 right, bit 2 jump, bit 3 bomb
+//
+// ReplayView parses a replay in place (e.g. from a MappedFile) without
+// copying the input stream.
+//
+
+constexpr uint16_t REPLAY_VERSION = 3;   // 2: bomb input, crates, ropes, terrain; 3: sand and liquids
+constexpr size_t REPLAY_HEADER_SIZE = 24;
+
+enum ReplayInputBits : uint8_t {
+    REPLAY_LEFT  = 1u << 0,
+    REPLAY_RIGHT = 1u << 1,
+    REPLAY_JUMP  = 1u << 2,
+    REPLAY_BOMB  = 1u << 3
+};
+
+inline uint8_t packInput(const PlayerInput& in) {
+    return (uint8_t)((in.left ? REPLAY_LEFT : 0) | (in.right ? REPLAY_RIGHT : 0) | (in.jump ? REPLAY_JUMP : 0) |
+                     (in.bomb ? REPLAY_BOMB : 0));
+}
+
+inline PlayerInput unpackInput(uint8_t bits) {
+    PlayerInput in;
+    in.left  = (bits & REPLAY_LEFT) != 0;
+    in.right = (bits & REPLAY_RIGHT) != 0;
+    in.jump  = (bits & REPLAY_JUMP) != 0;
+    in.bomb  = (bits & REPLAY_BOMB) != 0;
+    return in;
+}
+
+struct ReplayView {
+    uint16_t tickHz{ 0 };
+    uint64_t levelSeed{ 0 };
+    uint32_t levelId{ 0 };
+    uint32_t tickCount{ 0 };
+    const uint8_t* inputs{ nullptr };
+
+    // False if the buffer is not a complete replay of a version we read.
+    bool parse(const uint8_t* data, size_t size) {
+        if (!data || size < REPLAY_HEADER_SIZE || std::memcmp(data, "RPLY", 4) != 0) return false;
+        uint16_t version;
+        std::memcpy(&version, data + 4, 2);
+        std::memcpy(&tickHz, data + 6, 2);
+        std::memcpy(&levelSeed, data + 8, 8);
+        std::memcpy(&levelId, data + 16, 4);
+        std::memcpy(&tickCount, data + 20, 4);
+        if (version != REPLAY_VERSION) return false;
+        if (size - REPLAY_HEADER_SIZE < tickCount) return false;
+        inputs = data + REPLAY_HEADER_SIZE;
+        return true;
+    }
+};
+
+// The 24-byte header above, for a stream of `tickCount` inputs
+inline void writeReplayHeader(uint8_t* out, uint16_t tickHz, uint64_t levelSeed, uint32_t levelId,
+                              uint32_t tickCount) {
+    std::memcpy(out, "RPLY", 4);
+    std::memcpy(out + 4, &REPLAY_VERSION, 2);
+    std::memcpy(out + 6, &tickHz, 2);
+    std::memcpy(out + 8, &levelSeed, 8);
+    std::memcpy(out + 16, &levelId, 4);
+    std::memcpy(out + 20, &tickCount, 4);
+}
+
+struct ReplayWriter {
+    uint16_t tickHz{ 60 };
+    uint64_t levelSeed{ 0 };
+    uint32_t levelId{ 0 };
+    std::vector<uint8_t> inputs;
+
+    void record(const PlayerInput& in) { inputs.push_back(packInput(in)); }
+
+    bool save(const char* path) const {
+        FILE* f = std::fopen(path, "wb");
+        if (!f) return false;
+        uint8_t header[REPLAY_HEADER_SIZE];
+        writeReplayHeader(header, tickHz, levelSeed, levelId, (uint32_t)inputs.size());
+        bool ok = std::fwrite(header, 1, sizeof(header), f) == sizeof(header) &&
+                  std::fwrite(inputs.data(), 1, inputs.size(), f) == inputs.size();
+        return std::fclose(f) == 0 && ok;
+    }
+};
+
+// Reads --record PATH from the command line; nullptr if absent.
+inline const char* parseRecordPath(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--record=", 9) == 0) return argv[i] + 9;
+        if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) return argv[i + 1];
+    }
+    return nullptr;
+}
@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+#include "game_world.h"
+#include "replay.h"
+#include "mapped_file.h"
+#include "job_system.h"
+#include "tick_rate.h"
+#include "profiler.h"
+
+// Replay Analytics (Section 4 – Input Recording)
+// Batch tool: memory-maps recorded replays, resimulates each one headless
+// through game_world.h (the game's own fixed tick) on every core and
+// aggregates per-tile statistics:
+//   visits  ticks the player's centre spent in the tile
+//   deaths  falls below the kill plane or into lava, at the last tile stood on
+//   coins   coins picked up in the tile
+//   stuck   the player held a direction for STUCK_SECONDS without moving
+//           more than STUCK_DISTANCE px (counted once per episode)
+// Each worker owns one histogram; they are merged after the batch, so the
+// hot loop never touches shared memory.  Output is a CSV per tile, a CSV
+// per coin (collection rate) and one PGM heatmap per statistic.  --profile
+// samples the batch (profiler.h) into <prefix>_profile.folded and .svg,
+// a flame graph of resimulating the demos.
+//
+// Build: g++ -O2 -std=c++17 -pthread -fno-omit-frame-pointer replay_analytics.cpp -o replay_analytics
+// Usage: replay_analytics [-j threads] [-o prefix] [--level id] [--profile] <file|dir>...
+//        Directories are scanned (non-recursively) for *.rply files.
+
+constexpr float STUCK_SECONDS  = 1.0f;
+constexpr float STUCK_DISTANCE = 4.0f;
+constexpr int   HEATMAP_SCALE  = 8;    // PGM pixels per tile
+
+struct TileHistogram {
+    static constexpr int TILES = LEVEL_WIDTH * LEVEL_HEIGHT;
+    std::vector<uint32_t> visits, deaths, coins, stuck;
+    std::vector<uint32_t> coinCollected;
+    uint64_t replays{ 0 }, rejected{ 0 }, ticks{ 0 };
+
+    TileHistogram()
+        : visits(TILES), deaths(TILES), coins(TILES), stuck(TILES), coinCollected(COIN_COUNT) {}
+
+    void merge(const TileHistogram& o) {
+        for (int i = 0; i < TILES; ++i) {
+            visits[i] += o.visits[i];
+            deaths[i] += o.deaths[i];
+            coins[i]  += o.coins[i];
+            stuck[i]  += o.stuck[i];
+        }
+        for (int i = 0; i < COIN_COUNT; ++i) coinCollected[i] += o.coinCollected[i];
+        replays += o.replays;
+        rejected += o.rejected;
+        ticks += o.ticks;
+    }
+};
+
+// Tile under the player's centre, clamped onto the map
+static int tileIndex(const Player& p) {
+    int tx = p.position.x.tile(TILE_SIZE, PLAYER_W * 0.5f);
+    int ty = p.position.y.tile(TILE_SIZE, PLAYER_H * 0.5f);
+    tx = std::clamp(tx, 0, LEVEL_WIDTH - 1);
+    ty = std::clamp(ty, 0, LEVEL_HEIGHT - 1);
+    return ty * LEVEL_WIDTH + tx;
+}
+
+static void resimulate(const ReplayView& replay, TileHistogram& h) {
+    if (!isSupportedTickRate(replay.tickHz)) { ++h.rejected; return; }
+    const float dt = TickRate::fromHz(replay.tickHz).dt;
+    const uint32_t stuckTicks = (uint32_t)std::lround(STUCK_SECONDS * replay.tickHz);
+    // Each replay edits its own copy of the terrain
+    std::unique_ptr<GameWorld> world(new GameWorld);
+    world->reset();
+    int lastGroundTile = tileIndex(world->player);
+    // Stuck tracking: where the current push started and for how long
+    double pushStartX = world->player.position.x.pixels();
+    uint32_t pushTicks = 0;
+    uint8_t pushDir = 0;
+    for (uint32_t t = 0; t < replay.tickCount; ++t) {
+        const PlayerInput in = unpackInput(replay.inputs[t]);
+        const GameTickEvents events = world->step(in, dt);
+        // Statistics for this tick are taken where the player got to, before
+        // any respawn
+        const Player& player = events.died ? events.beforeRespawn : world->player;
+        int tile = tileIndex(player);
+        ++h.visits[tile];
+        if (player.onGround) lastGroundTile = tile;
+
+        for (int i = 0; i < COIN_COUNT; ++i) {
+            if (!(events.coinsGained & (1u << i))) continue;
+            ++h.coinCollected[i];
+            ++h.coins[LEVEL_COINS[i].y * LEVEL_WIDTH + LEVEL_COINS[i].x];
+        }
+
+        uint8_t dir = in.left == in.right ? 0 : (in.left ? REPLAY_LEFT : REPLAY_RIGHT);
+        double x = player.position.x.pixels();
+        if (dir == 0 || dir != pushDir || std::abs(x - pushStartX) > STUCK_DISTANCE) {
+            pushDir = dir;
+            pushStartX = x;
+            pushTicks = 0;
+        } else if (++pushTicks == stuckTicks) {
+            ++h.stuck[tile];
+        }
+
+        if (events.died) {
+            ++h.deaths[lastGroundTile];
+            pushDir = 0;
+        }
+    }
+    h.ticks += replay.tickCount;
+    ++h.replays;
+}
+
+static void writeCsv(const std::string& prefix, const TileHistogram& h) {
+    std::string path = prefix + "_tiles.csv";
+    if (FILE* f = std::fopen(path.c_str(), "w")) {
+        std::fprintf(f, "x,y,visits,deaths,coins,stuck\n");
+        for (int y = 0; y < LEVEL_HEIGHT; ++y) {
+            for (int x = 0; x < LEVEL_WIDTH; ++x) {
+                int i = y * LEVEL_WIDTH + x;
+                if (!(h.visits[i] | h.deaths[i] | h.coins[i] | h.stuck[i])) continue;
+                std::fprintf(f, "%d,%d,%u,%u,%u,%u\n", x, y, h.visits[i], h.deaths[i], h.coins[i], h.stuck[i]);
+            }
+        }
+        std::fclose(f);
+    }
+    path = prefix + "_coins.csv";
+    if (FILE* f = std::fopen(path.c_str(), "w")) {
+        std::fprintf(f, "coin,x,y,collected,replays,rate\n");
+        for (int i = 0; i < COIN_COUNT; ++i) {
+            double rate = h.replays ? (double)h.coinCollected[i] / (double)h.replays : 0.0;
+            std::fprintf(f, "%d,%d,%d,%u,%llu,%.4f\n", i, LEVEL_COINS[i].x, LEVEL_COINS[i].y,
+                         h.coinCollected[i], (unsigned long long)h.replays, rate);
+        }
+        std::fclose(f);
+    }
+}
+
+// 8-bit heatmap, square-root scaled so rare events stay visible next to hot spots
+static void writePgm(const std::string& path, const std::vector<uint32_t>& counts) {
+    uint32_t peak = *std::max_element(counts.begin(), counts.end());
+    const int w = LEVEL_WIDTH * HEATMAP_SCALE, hgt = LEVEL_HEIGHT * HEATMAP_SCALE;
+    std::vector<uint8_t> pixels((size_t)w * hgt);
+    for (int y = 0; y < hgt; ++y) {
+        for (int x = 0; x < w; ++x) {
+            uint32_t c = counts[(y / HEATMAP_SCALE) * LEVEL_WIDTH + x / HEATMAP_SCALE];
+            pixels[(size_t)y * w + x] = peak ? (uint8_t)std::lround(255.0 * std::sqrt((double)c / peak)) : 0;
+        }
+    }
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return;
+    std::fprintf(f, "P5\n%d %d\n255\n", w, hgt);
+    std::fwrite(pixels.data(), 1, pixels.size(), f);
+    std::fclose(f);
+}
+
+static void collectInputs(const char* arg, std::vector<std::string>& files) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    if (fs::is_directory(arg, ec)) {
+        for (const fs::directory_entry& e : fs::directory_iterator(arg, ec)) {
+            if (e.is_regular_file(ec) && e.path().extension() == ".rply") files.push_back(e.path().string());
+        }
+    } else {
+        files.push_back(arg);
+    }
+}
+
+int main(int argc, char** argv) {
+    unsigned threads = 0;
+    std::string prefix = "replays";
+    long levelFilter = -1;
+    bool profile = false;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-j") == 0 && i + 1 < argc) threads = (unsigned)std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) prefix = argv[++i];
+        else if (std::strcmp(argv[i], "--level") == 0 && i + 1 < argc) levelFilter = std::atol(argv[++i]);
+        else if (std::strcmp(argv[i], "--profile") == 0) profile = true;
+        else collectInputs(argv[i], files);
+    }
+    if (files.empty()) {
+        std::fprintf(stderr, "usage: %s [-j threads] [-o prefix] [--level id] [--profile] <replay|dir>...\n", argv[0]);
+        return 1;
+    }
+    // Stable order so runs over the same set are reproducible
+    std::sort(files.begin(), files.end());
+
+    SamplingProfiler profiler;
+    if (profile && !profiler.start()) std::fprintf(stderr, "sampling profiler unavailable on this platform\n");
+    JobSystem jobs;
+    jobs.threadStart = [](unsigned) { SamplingProfiler::registerThread(); };
+    jobs.start(threads);
+    std::vector<TileHistogram> perWorker(jobs.workerCount());
+    std::atomic<uint64_t> unreadable{ 0 };
+    auto start = std::chrono::steady_clock::now();
+    jobs.parallelFor(files.size(), 4, [&](size_t begin, size_t end, unsigned worker) {
+        TileHistogram& h = perWorker[worker];
+        for (size_t i = begin; i < end; ++i) {
+            MappedFile file;
+            ReplayView replay;
+            if (!file.open(files[i].c_str())) { ++unreadable; continue; }
+            if (!replay.parse(file.data, file.size)) { ++h.rejected; continue; }
+            if (levelFilter >= 0 && replay.levelId != (uint32_t)levelFilter) continue;
+            resimulate(replay, h);
+            // Worker 0 is always this thread, the only one allowed to drain
+            if (worker == 0) profiler.drain();
+        }
+    });
+    profiler.stop();
+    TileHistogram total;
+    for (const TileHistogram& h : perWorker) total.merge(h);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    writeCsv(prefix, total);
+    writePgm(prefix + "_visits.pgm", total.visits);
+    writePgm(prefix + "_deaths.pgm", total.deaths);
+    writePgm(prefix + "_coins.pgm", total.coins);
+    writePgm(prefix + "_stuck.pgm", total.stuck);
+    if (profile) {
+        profiler.writeFolded((prefix + "_profile.folded").c_str());
+        profiler.writeFlameGraph((prefix + "_profile.svg").c_str(), "replay_analytics");
+    }
+
+    std::printf("%llu replays (%llu rejected, %llu unreadable), %llu ticks in %.2f s on %u threads (%.1f Mticks/s)\n",
+                (unsigned long long)total.replays, (unsigned long long)total.rejected,
+                (unsigned long long)unreadable.load(), (unsigned long long)total.ticks, seconds,
+                jobs.workerCount(), seconds > 0.0 ? total.ticks / seconds / 1e6 : 0.0);
+    return 0;
+}
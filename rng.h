@@ -0,0 +1,164 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define RNG_HAS_SSE2 1
+#endif
+
+//----------------------------------------------------------------------------
+// Counter-Based Deterministic RNG (Section 0 – Determinism)
+//----------------------------------------------------------------------------
+// Randomness is a pure function of (seed, system, entity id, tick, draw index)
+// using Philox4x32-10.  There is no shared state to advance, so a value never
+// depends on which thread asked for it or in which order entities were
+// updated: the same spawn, jitter or AI roll comes out on every machine and
+// at every thread count.
+//
+// Each Philox block yields four 32-bit words.  `RngStream` hands them out one
+// at a time for a single (system, entity, tick) and bumps the draw index when
+// a block is exhausted.  `philoxBatch` produces the first block for many
+// entities at once, four at a time with SSE2, and is bit-identical to the
+// scalar path.
+//
+
+// Systems that draw random numbers.  Values are part of the replay format:
+// append new entries, never renumber.
+enum class RngSystem : uint32_t {
+    Spawn       = 1,
+    Particle    = 2,
+    ScreenShake = 3,
+    AI          = 4,
+    Parallax    = 5,
+};
+
+struct RngBlock {
+    uint32_t v[4];
+};
+
+namespace rng_detail {
+constexpr uint32_t PHILOX_M0 = 0xD2511F53u;
+constexpr uint32_t PHILOX_M1 = 0xCD9E8D57u;
+constexpr uint32_t PHILOX_W0 = 0x9E3779B9u;
+constexpr uint32_t PHILOX_W1 = 0xBB67AE85u;
+constexpr int      PHILOX_ROUNDS = 10;
+}
+
+// One Philox4x32-10 block for counter c and 64-bit key (the level/game seed).
+inline RngBlock philox4x32(uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3, uint64_t seed) {
+    using namespace rng_detail;
+    uint32_t k0 = (uint32_t)seed;
+    uint32_t k1 = (uint32_t)(seed >> 32);
+    for (int r = 0; r < PHILOX_ROUNDS; ++r) {
+        uint64_t p0 = (uint64_t)PHILOX_M0 * c0;
+        uint64_t p1 = (uint64_t)PHILOX_M1 * c2;
+        uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+        uint32_t n1 = (uint32_t)p1;
+        uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+        uint32_t n3 = (uint32_t)p0;
+        c0 = n0; c1 = n1; c2 = n2; c3 = n3;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    return RngBlock{ { c0, c1, c2, c3 } };
+}
+
+// Counter layout: (entity, tick, system, draw index).
+inline RngBlock rngBlock(uint64_t seed, RngSystem system, uint32_t entity, uint32_t tick, uint32_t index = 0) {
+    return philox4x32(entity, tick, (uint32_t)system, index, seed);
+}
+
+// Map 32 random bits to a float in [0, 1) using the top 24 bits.
+inline float rngToFloat(uint32_t bits) {
+    return (float)(bits >> 8) * (1.0f / 16777216.0f);
+}
+
+// Sequential draws for one (system, entity, tick).  Cheap to construct; make
+// one wherever randomness is needed instead of storing it.
+struct RngStream {
+    uint64_t  seed;
+    RngSystem system;
+    uint32_t  entity;
+    uint32_t  tick;
+    uint32_t  index{ 0 };
+    RngBlock  block{};
+    int       used{ 4 };
+
+    RngStream(uint64_t s, RngSystem sys, uint32_t e, uint32_t t)
+        : seed(s), system(sys), entity(e), tick(t) {}
+
+    uint32_t nextU32() {
+        if (used == 4) {
+            block = rngBlock(seed, system, entity, tick, index++);
+            used = 0;
+        }
+        return block.v[used++];
+    }
+    // Uniform float in [0, 1)
+    float nextFloat() { return rngToFloat(nextU32()); }
+    // Uniform float in [lo, hi)
+    float range(float lo, float hi) { return lo + (hi - lo) * nextFloat(); }
+    // Uniform integer in [0, n) (n > 0), multiply-shift without modulo bias
+    uint32_t below(uint32_t n) { return (uint32_t)(((uint64_t)nextU32() * n) >> 32); }
+};
+
+#ifdef RNG_HAS_SSE2
+namespace rng_detail {
+// Full 32×32→64 multiply of four lanes by a constant, split into hi/lo words.
+inline void mulhilo4(__m128i a, __m128i m, __m128i& hi, __m128i& lo) {
+    __m128i p02 = _mm_mul_epu32(a, m);                     // lanes 0, 2
+    __m128i p13 = _mm_mul_epu32(_mm_srli_epi64(a, 32), m); // lanes 1, 3
+    __m128i s02 = _mm_shuffle_epi32(p02, _MM_SHUFFLE(3, 1, 2, 0)); // lo0 lo2 hi0 hi2
+    __m128i s13 = _mm_shuffle_epi32(p13, _MM_SHUFFLE(3, 1, 2, 0)); // lo1 lo3 hi1 hi3
+    lo = _mm_unpacklo_epi32(s02, s13);
+    hi = _mm_unpackhi_epi32(s02, s13);
+}
+}
+#endif
+
+// First Philox block for each of `count` entities at the same tick/index.
+// out must hold count * 4 words; out[i*4 + k] == rngBlock(..., entities[i], ...).v[k].
+inline void philoxBatch(uint64_t seed, RngSystem system, uint32_t tick, uint32_t index,
+                        const uint32_t* entities, size_t count, uint32_t* out) {
+    size_t i = 0;
+#ifdef RNG_HAS_SSE2
+    using namespace rng_detail;
+    const __m128i m0 = _mm_set1_epi32((int)PHILOX_M0);
+    const __m128i m1 = _mm_set1_epi32((int)PHILOX_M1);
+    for (; i + 4 <= count; i += 4) {
+        __m128i c0 = _mm_loadu_si128((const __m128i*)(entities + i));
+        __m128i c1 = _mm_set1_epi32((int)tick);
+        __m128i c2 = _mm_set1_epi32((int)(uint32_t)system);
+        __m128i c3 = _mm_set1_epi32((int)index);
+        uint32_t k0 = (uint32_t)seed;
+        uint32_t k1 = (uint32_t)(seed >> 32);
+        for (int r = 0; r < PHILOX_ROUNDS; ++r) {
+            __m128i hi0, lo0, hi1, lo1;
+            mulhilo4(c0, m0, hi0, lo0);
+            mulhilo4(c2, m1, hi1, lo1);
+            c0 = _mm_xor_si128(_mm_xor_si128(hi1, c1), _mm_set1_epi32((int)k0));
+            c1 = lo1;
+            c2 = _mm_xor_si128(_mm_xor_si128(hi0, c3), _mm_set1_epi32((int)k1));
+            c3 = lo0;
+            k0 += PHILOX_W0;
+            k1 += PHILOX_W1;
+        }
+        // Transpose lanes (entities) into per-entity blocks
+        __m128i t0 = _mm_unpacklo_epi32(c0, c1);
+        __m128i t1 = _mm_unpacklo_epi32(c2, c3);
+        __m128i t2 = _mm_unpackhi_epi32(c0, c1);
+        __m128i t3 = _mm_unpackhi_epi32(c2, c3);
+        _mm_storeu_si128((__m128i*)(out + i * 4 + 0),  _mm_unpacklo_epi64(t0, t1));
+        _mm_storeu_si128((__m128i*)(out + i * 4 + 4),  _mm_unpackhi_epi64(t0, t1));
+        _mm_storeu_si128((__m128i*)(out + i * 4 + 8),  _mm_unpacklo_epi64(t2, t3));
+        _mm_storeu_si128((__m128i*)(out + i * 4 + 12), _mm_unpackhi_epi64(t2, t3));
+    }
+#endif
+    for (; i < count; ++i) {
+        RngBlock b = rngBlock(seed, system, entities[i], tick, index);
+        out[i * 4 + 0] = b.v[0];
+        out[i * 4 + 1] = b.v[1];
+        out[i * 4 + 2] = b.v[2];
+        out[i * 4 + 3] = b.v[3];
+    }
+}
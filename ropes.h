@@ -0,0 +1,140 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include "sim.h"
+#include "solidity.h"
+#include "verlet.h"
+
+//----------------------------------------------------------------------------
+// Level Ropes (Section 14 – Dynamic Bodies)
+//----------------------------------------------------------------------------
+// Binds LEVEL_ROPES and the player to a VerletSystem.  Call step() every
+// tick after Player::update:
+//   - an airborne player whose hand passes a rope particle grabs it; the
+//     particle takes the player's velocity and mass and the player then
+//     follows it (state Swing), pumping the swing with left/right
+//   - pressing jump lets go with the rope's velocity plus a jump
+//   - a bridge (rope pinned at both ends) is a one-way platform: a falling
+//     player lands on the link under their centre and weighs it down
+//
+// Particles are relative to `origin` (sim.h), which follows the player like
+// the crates' does, so ropes work anywhere in a long level.  SDL-free and
+// deterministic like crates.h, so replays resimulate exactly.
+//
+
+constexpr float ROPE_GRAB_RADIUS   = 10.0f;    // px from the hand
+constexpr float ROPE_REGRAB_DELAY  = 0.3f;     // s after letting go
+constexpr float ROPE_PLAYER_MASS   = 6.0f;     // in link masses
+constexpr float ROPE_SWING_ACCEL   = 900.0f;   // px/s² from left/right
+constexpr float ROPE_JUMP_FACTOR   = 0.8f;     // of JUMP_V0 when letting go
+constexpr float ROPE_BRIDGE_SLACK  = 1.08f;
+constexpr float ROPE_STAND_PRESS   = 0.6f;     // px a standing player pushes a bridge link down per tick
+
+struct RopeWorld {
+    VerletSystem verlet;
+    SimOrigin origin;
+    uint32_t grabbed{ 0 };            // particle held by the player, 0 = none
+    float grabbedInvMass{ 0.0f };
+    float regrabTimer{ 0.0f };
+    bool prevJump{ false };
+
+    void reset(const SolidityBitmap& solidity) {
+        verlet.clear();
+        verlet.setTiles(solidity, (float)TILE_SIZE);
+        origin = SimOrigin{};
+        verlet.setTileOrigin(origin.tileX(), origin.tileY());
+        for (const RopeSpawn& r : LEVEL_ROPES) {
+            verlet.addRope(origin.localX(WorldCoord::fromPixels(r.ax)), origin.localY(WorldCoord::fromPixels(r.ay)),
+                           origin.localX(WorldCoord::fromPixels(r.bx)), origin.localY(WorldCoord::fromPixels(r.by)),
+                           r.links, r.bridge, r.bridge ? ROPE_BRIDGE_SLACK : 1.0f);
+        }
+        grabbed = 0;
+        regrabTimer = 0.0f;
+        prevJump = false;
+    }
+
+    float handX(const Player& p) const { return origin.localX(p.position.x) + PLAYER_W * 0.5f; }
+    float handY(const Player& p) const { return origin.localY(p.position.y) + 4.0f; }
+
+    void release(Player& player, float dt) {
+        player.velocity.x = verlet.velocityX(grabbed, dt);
+        player.velocity.y = verlet.velocityY(grabbed, dt) + JUMP_V0 * ROPE_JUMP_FACTOR;
+        player.state = PlayerState::JumpRise;
+        verlet.invMass[grabbed] = grabbedInvMass;
+        grabbed = 0;
+        regrabTimer = ROPE_REGRAB_DELAY;
+    }
+
+    void step(Player& player, const PlayerInput& input, float dt) {
+        const bool jumpPressed = input.jump && !prevJump;
+        prevJump = input.jump;
+        if (regrabTimer > 0.0f) regrabTimer -= dt;
+        float shiftX, shiftY;
+        if (origin.follow(player.position, shiftX, shiftY)) {
+            verlet.shift(shiftX, shiftY);
+            verlet.setTileOrigin(origin.tileX(), origin.tileY());
+        }
+
+        if (grabbed && jumpPressed) release(player, dt);
+        if (grabbed && (input.left ^ input.right)) {
+            // Verlet velocity is implicit: shifting the previous position
+            // accelerates the particle
+            verlet.px[grabbed] -= (input.left ? -1.0f : 1.0f) * ROPE_SWING_ACCEL * dt * dt;
+        }
+        verlet.step(dt);
+
+        if (!grabbed && !player.onGround && regrabTimer <= 0.0f) {
+            uint32_t i = verlet.nearestParticle(handX(player), handY(player), ROPE_GRAB_RADIUS);
+            if (i) {
+                grabbed = i;
+                grabbedInvMass = verlet.invMass[i];
+                verlet.invMass[i] = grabbedInvMass / ROPE_PLAYER_MASS;
+                // Carry the player's momentum into the rope
+                verlet.px[i] = verlet.x[i] - player.velocity.x * dt;
+                verlet.py[i] = verlet.y[i] - player.velocity.y * dt;
+            }
+        }
+        if (grabbed) {
+            player.position.x.local += verlet.x[grabbed] - handX(player);
+            player.position.y.local += verlet.y[grabbed] - handY(player);
+            player.position.normalize();
+            player.velocity.x = verlet.velocityX(grabbed, dt);
+            player.velocity.y = verlet.velocityY(grabbed, dt);
+            player.onGround = false;
+            player.coyoteTimer = 0.0f;
+            player.jumpBufferTimer = 0.0f;
+            player.state = PlayerState::Swing;
+            return;
+        }
+        standOnBridges(player, dt);
+    }
+
+    void standOnBridges(Player& player, float dt) {
+        if (player.velocity.y < 0.0f) return;
+        const float cx = handX(player);
+        const float bottom = origin.localY(player.position.y) + PLAYER_H;
+        const float prevBottom = bottom - player.velocity.y * dt;
+        for (const VerletRope& r : verlet.ropes) {
+            if (!r.bridge) continue;
+            for (uint32_t k = r.first; k + 1 < r.first + r.count; ++k) {
+                float x0 = verlet.x[k], x1 = verlet.x[k + 1];
+                if (cx < std::min(x0, x1) || cx >= std::max(x0, x1)) continue;
+                float t = (cx - x0) / (x1 - x0);
+                float surface = verlet.y[k] + (verlet.y[k + 1] - verlet.y[k]) * t;
+                // Land only when crossing from above (a little tolerance for
+                // the link sagging away under the player)
+                if (prevBottom > surface + 2.0f || bottom < surface) break;
+                player.position.y.local += surface - bottom;
+                player.position.normalize();
+                player.velocity.y = 0.0f;
+                player.onGround = true;
+                player.coyoteTimer = 0.1f;
+                player.state = std::abs(player.velocity.x) > 1.0f ? PlayerState::Run : PlayerState::Idle;
+                if (verlet.invMass[k] != 0.0f) verlet.y[k] += ROPE_STAND_PRESS * (1.0f - t);
+                if (verlet.invMass[k + 1] != 0.0f) verlet.y[k + 1] += ROPE_STAND_PRESS * t;
+                return;
+            }
+        }
+    }
+};
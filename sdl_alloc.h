@@ -0,0 +1,258 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+//----------------------------------------------------------------------------
+// Pooled Allocator for SDL (Section 0 – Memory)
+//----------------------------------------------------------------------------
+// installSdlAllocator() routes SDL's internal malloc/calloc/realloc/free
+// (surfaces, event queue, renderer bookkeeping, ...) through size-class
+// pools so that SDL churn is both cheap and visible.  It must be called
+// before any other SDL function: memory SDL allocated with the C runtime
+// cannot be freed through the pools.
+//
+// Requests up to the largest size class come from per-class free lists
+// carved out of 64 KiB slabs; slabs are never returned, so steady-state
+// churn (a surface created and freed every frame) recycles the same blocks.
+// Larger requests go to the system allocator.  Each block carries a 16-byte
+// header with its class and tag, which keeps payloads 16-byte aligned and
+// lets free/realloc run without a lookup.
+//
+// Accounting is per MemTag.  SDL cannot say who is allocating, so callers
+// set the current thread's tag with MemTagScope around SDL calls; anything
+// outside a scope is booked as Other.  A free is booked against the tag the
+// block was allocated under, whichever thread frees it.
+//
+
+enum class MemTag : uint8_t {
+    Other,
+    Events,
+    Render,
+    Surface,
+    Audio,
+    Count
+};
+
+inline const char* memTagName(MemTag tag) {
+    static const char* names[] = { "other", "events", "render", "surface", "audio" };
+    return names[(size_t)tag];
+}
+
+struct MemTagStats {
+    std::atomic<int64_t>  liveBytes{ 0 };
+    std::atomic<int64_t>  peakBytes{ 0 };
+    std::atomic<uint64_t> allocs{ 0 };
+    std::atomic<uint64_t> frees{ 0 };
+};
+
+struct PoolAllocator {
+    static constexpr int    CLASS_COUNT = 9;
+    static constexpr size_t CLASS_SIZES[CLASS_COUNT] = { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    static constexpr size_t SLAB_BYTES  = 64 * 1024;
+    static constexpr size_t HEADER      = 16;
+    static constexpr uint8_t LARGE      = 0xFF;   // class id for system allocations
+    static constexpr uint16_t MAGIC     = 0x5DA1;
+
+    struct Header {
+        uint32_t size;      // requested bytes
+        uint8_t  cls;
+        uint8_t  tag;
+        uint16_t magic;
+        uint8_t  pad[8];
+    };
+    static_assert(sizeof(Header) == HEADER, "header must keep payloads 16-byte aligned");
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    struct SizeClass {
+        std::atomic_flag lock = ATOMIC_FLAG_INIT;
+        FreeBlock* freeList{ nullptr };
+        std::atomic<uint64_t> slabs{ 0 };
+        std::atomic<uint64_t> hits{ 0 };      // served from the free list
+        std::atomic<uint64_t> carved{ 0 };    // served from fresh slab space
+        uint8_t* slabCursor{ nullptr };
+        uint8_t* slabEnd{ nullptr };
+    };
+
+    SizeClass classes[CLASS_COUNT];
+    MemTagStats tags[(size_t)MemTag::Count];
+    std::atomic<uint64_t> largeAllocs{ 0 };
+
+    static inline thread_local MemTag currentTag = MemTag::Other;
+
+    static int classFor(size_t size) {
+        for (int i = 0; i < CLASS_COUNT; ++i) {
+            if (size <= CLASS_SIZES[i]) return i;
+        }
+        return -1;
+    }
+
+    static Header* headerOf(void* p) { return (Header*)((uint8_t*)p - HEADER); }
+
+    void adjustLive(MemTag tag, int64_t delta) {
+        MemTagStats& s = tags[(size_t)tag];
+        int64_t live = s.liveBytes.fetch_add(delta, std::memory_order_relaxed) + delta;
+        int64_t peak = s.peakBytes.load(std::memory_order_relaxed);
+        while (live > peak && !s.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+    }
+
+    void* takeBlock(int c) {
+        SizeClass& sc = classes[c];
+        const size_t blockBytes = CLASS_SIZES[c] + HEADER;
+        while (sc.lock.test_and_set(std::memory_order_acquire)) {}
+        void* block = nullptr;
+        if (sc.freeList) {
+            block = sc.freeList;
+            sc.freeList = sc.freeList->next;
+            sc.hits.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            if (sc.slabCursor == nullptr || sc.slabCursor + blockBytes > sc.slabEnd) {
+                uint8_t* slab = (uint8_t*)std::malloc(SLAB_BYTES);
+                if (slab) {
+                    sc.slabCursor = slab;
+                    sc.slabEnd = slab + SLAB_BYTES;
+                    sc.slabs.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            if (sc.slabCursor && sc.slabCursor + blockBytes <= sc.slabEnd) {
+                block = sc.slabCursor;
+                sc.slabCursor += blockBytes;
+                sc.carved.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        sc.lock.clear(std::memory_order_release);
+        return block;
+    }
+
+    void giveBlock(int c, void* block) {
+        SizeClass& sc = classes[c];
+        while (sc.lock.test_and_set(std::memory_order_acquire)) {}
+        FreeBlock* f = (FreeBlock*)block;
+        f->next = sc.freeList;
+        sc.freeList = f;
+        sc.lock.clear(std::memory_order_release);
+    }
+
+    void* allocate(size_t size) {
+        if (size == 0) size = 1;
+        if (size > UINT32_MAX) return nullptr;
+        int c = classFor(size);
+        void* block = c >= 0 ? takeBlock(c) : std::malloc(size + HEADER);
+        if (!block) return nullptr;
+        if (c < 0) largeAllocs.fetch_add(1, std::memory_order_relaxed);
+        Header* h = (Header*)block;
+        h->size = (uint32_t)size;
+        h->cls = c >= 0 ? (uint8_t)c : LARGE;
+        h->tag = (uint8_t)currentTag;
+        h->magic = MAGIC;
+        tags[(size_t)currentTag].allocs.fetch_add(1, std::memory_order_relaxed);
+        adjustLive(currentTag, (int64_t)size);
+        return (uint8_t*)block + HEADER;
+    }
+
+    void release(void* p) {
+        if (!p) return;
+        Header* h = headerOf(p);
+        SDL_assert(h->magic == MAGIC);
+        tags[h->tag].frees.fetch_add(1, std::memory_order_relaxed);
+        adjustLive((MemTag)h->tag, -(int64_t)h->size);
+        h->magic = 0;
+        if (h->cls == LARGE) std::free(h);
+        else giveBlock(h->cls, h);
+    }
+
+    void* reallocate(void* p, size_t size) {
+        if (!p) return allocate(size);
+        if (size == 0) { release(p); return nullptr; }
+        Header* h = headerOf(p);
+        // Still fits the block it already has: adjust the books only
+        if (h->cls != LARGE && size <= CLASS_SIZES[h->cls]) {
+            adjustLive((MemTag)h->tag, (int64_t)size - (int64_t)h->size);
+            h->size = (uint32_t)size;
+            return p;
+        }
+        void* q = allocate(size);
+        if (!q) return nullptr;
+        std::memcpy(q, p, h->size < size ? h->size : size);
+        release(p);
+        return q;
+    }
+
+    // Fraction of pooled allocations served without touching fresh slab space.
+    double poolHitRate() const {
+        uint64_t hits = 0, carved = 0;
+        for (const SizeClass& sc : classes) {
+            hits += sc.hits.load(std::memory_order_relaxed);
+            carved += sc.carved.load(std::memory_order_relaxed);
+        }
+        return hits + carved ? (double)hits / (double)(hits + carved) : 0.0;
+    }
+
+    void report(FILE* out) const {
+        std::fprintf(out, "%-8s %12s %12s %10s %10s\n", "tag", "live bytes", "peak bytes", "allocs", "frees");
+        for (size_t t = 0; t < (size_t)MemTag::Count; ++t) {
+            const MemTagStats& s = tags[t];
+            std::fprintf(out, "%-8s %12lld %12lld %10llu %10llu\n", memTagName((MemTag)t),
+                         (long long)s.liveBytes.load(), (long long)s.peakBytes.load(),
+                         (unsigned long long)s.allocs.load(), (unsigned long long)s.frees.load());
+        }
+        std::fprintf(out, "%-8s %8s %10s %10s\n", "class", "slabs", "reused", "carved");
+        for (int c = 0; c < CLASS_COUNT; ++c) {
+            const SizeClass& sc = classes[c];
+            std::fprintf(out, "%8zu %8llu %10llu %10llu\n", CLASS_SIZES[c],
+                         (unsigned long long)sc.slabs.load(), (unsigned long long)sc.hits.load(),
+                         (unsigned long long)sc.carved.load());
+        }
+        std::fprintf(out, "large (system) allocations: %llu, pool reuse %.1f%%\n",
+                     (unsigned long long)largeAllocs.load(), poolHitRate() * 100.0);
+    }
+};
+
+// Trivially destructible, so SDL may still free through it during exit.
+inline PoolAllocator& sdlAllocator() {
+    static PoolAllocator instance;
+    return instance;
+}
+
+// Books allocations made on this thread to `tag` for the scope's lifetime.
+struct MemTagScope {
+    MemTag previous;
+    explicit MemTagScope(MemTag tag) : previous(PoolAllocator::currentTag) { PoolAllocator::currentTag = tag; }
+    ~MemTagScope() { PoolAllocator::currentTag = previous; }
+    MemTagScope(const MemTagScope&) = delete;
+    MemTagScope& operator=(const MemTagScope&) = delete;
+};
+
+namespace sdl_alloc_detail {
+inline void* SDLCALL poolMalloc(size_t size) { return sdlAllocator().allocate(size); }
+inline void* SDLCALL poolCalloc(size_t count, size_t size) {
+    if (size && count > SIZE_MAX / size) return nullptr;
+    void* p = sdlAllocator().allocate(count * size);
+    if (p) std::memset(p, 0, count * size);
+    return p;
+}
+inline void* SDLCALL poolRealloc(void* p, size_t size) { return sdlAllocator().reallocate(p, size); }
+inline void SDLCALL poolFree(void* p) { sdlAllocator().release(p); }
+}
+
+// True if --alloc-report was given: print report() to stdout on exit.
+inline bool parseAllocReport(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--alloc-report") == 0) return true;
+    }
+    return false;
+}
+
+// Call first thing in main(), before SDL_Init.
+inline bool installSdlAllocator() {
+    sdlAllocator();
+    return SDL_SetMemoryFunctions(sdl_alloc_detail::poolMalloc, sdl_alloc_detail::poolCalloc,
+                                  sdl_alloc_detail::poolRealloc, sdl_alloc_detail::poolFree) == 0;
+}
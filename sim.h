@@ -0,0 +1,409 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include "solidity.h"
+#include "world_pos.h"
+
+//----------------------------------------------------------------------------
+// Simulation Core
+//----------------------------------------------------------------------------
+// Tuning constants, level data, camera and player movement from the
+// platformer skeleton, with no SDL dependency.  main.cpp drives it from
+// keyboard input and renders it; headless tools (benchmarks, replays) include
+// it directly and feed PlayerInput themselves.  All update functions take dt
+// so the same code runs at any supported tick rate (tick_rate.h).
+//
+
+// Section 0 – Global Targets & Constraints
+constexpr int   TILE_SIZE       = 16;               // World units = pixels; tile = 16×16 px
+constexpr int   NATIVE_W        = 480;              // Native render target width
+constexpr int   NATIVE_H        = 270;              // Native render target height
+constexpr float GRAVITY         = 2100.0f;          // Gravity (Section 7/8)
+constexpr float MAX_RUN_SPEED   = 220.0f;           // Player Vmax (Section 7)
+constexpr float GROUND_ACCEL    = 2400.0f;
+constexpr float GROUND_DECEL    = 2800.0f;
+constexpr float AIR_ACCEL       = 1400.0f;
+constexpr float AIR_DECEL       = 1000.0f;
+constexpr float JUMP_V0         = -620.0f;          // Primary jump velocity (Section 8)
+constexpr int   TILES_PER_CHUNK = WORLD_CHUNK_SIZE / TILE_SIZE; // Floating-origin chunk (world_pos.h)
+
+// Section 13 – Collision Layers (bitmasks)
+enum CollisionLayer : uint8_t {
+    TILE_LAYER         = 0,
+    PLAYER_HURT_LAYER  = 1,
+    PLAYER_ATTACK_LAYER= 2,
+    ENEMY_HURT_LAYER   = 3,
+    ENEMY_ATTACK_LAYER = 4,
+    SENSOR_LAYER       = 5
+};
+
+// Simple 2‑D vector for positions/velocities
+struct Vec2 {
+    float x{}, y{};
+};
+
+// Section 5 – Player Visual Design (collision size)
+constexpr int PLAYER_W = 22;
+constexpr int PLAYER_H = 32;
+
+// Section 6 – Player State Machine (skeleton enumerations)
+enum class PlayerState {
+    Idle,
+    Run,
+    JumpRise,
+    JumpApex,
+    Fall,
+    Land,
+    Dash,
+    Hurt,
+    Dead,
+    Swing       // hanging from a rope (ropes.h)
+    // Additional states can be added here
+};
+
+// Section 15 – Level Definition (tile map)
+// Ground is destroyed by explosions, breakable tiles also crumble under the
+// player, bedrock is permanent.  Sand, water and lava move on their own
+// (cellular.h); sand is solid, the two liquids are not.  LEVEL_DATA is the
+// initial map; the live, editable copy is terrain.h.
+enum TileId : uint8_t {
+    TILE_EMPTY     = 0,
+    TILE_GROUND    = 1,
+    TILE_BREAKABLE = 2,
+    TILE_BEDROCK   = 3,
+    TILE_SAND      = 4,
+    TILE_WATER     = 5,
+    TILE_LAVA      = 6
+};
+constexpr int TILE_ID_COUNT = 7;
+
+inline bool tileSolid(uint8_t id) {
+    return id != TILE_EMPTY && id != TILE_WATER && id != TILE_LAVA;
+}
+
+constexpr int LEVEL_WIDTH  = 32;
+constexpr int LEVEL_HEIGHT = 16;
+inline const std::array<uint8_t, LEVEL_WIDTH * LEVEL_HEIGHT> LEVEL_DATA = []{
+    std::array<uint8_t, LEVEL_WIDTH * LEVEL_HEIGHT> data{};
+    for (int y = 0; y < LEVEL_HEIGHT; ++y) {
+        for (int x = 0; x < LEVEL_WIDTH; ++x) {
+            uint8_t t = TILE_EMPTY;
+            if (y == LEVEL_HEIGHT - 1) t = TILE_BEDROCK;
+            else if (y >= 13 && x >= 26 && x <= 30) t = TILE_GROUND;     // mound
+            else if (y == 10 && x >= 8 && x <= 11) t = TILE_BREAKABLE;   // crumbling ledge
+            else if (y >= 13 && x == 3) t = TILE_GROUND;                 // lava pit wall
+            else if (y == 14 && x <= 2) t = TILE_LAVA;                   // lava pit
+            else if (y >= 1 && y <= 3 && x >= 20 && x <= 22) t = TILE_SAND;   // falls at start
+            else if (y >= 11 && y <= 12 && x >= 27 && x <= 29) t = TILE_WATER; // runs off the mound
+            data[y * LEVEL_WIDTH + x] = t;
+        }
+    }
+    return data;
+}();
+
+// Spawn point, and the depth below which the player counts as dead
+constexpr double PLAYER_SPAWN_X = 100.0;
+constexpr double PLAYER_SPAWN_Y = 100.0;
+constexpr double KILL_PLANE_Y   = (LEVEL_HEIGHT + 2) * TILE_SIZE;
+
+// Simulation origin: bodies simulated against the tile map (crates and
+// boulders, rope particles) keep plain float pixels, because their solvers
+// run on float SoA and SIMD lanes, but relative to a chunk-aligned origin
+// rather than the map's corner.  The origin follows the player in whole
+// chunks (follow()), so bodies around the player are as precise as a
+// WorldCoord's local part however far into a level they are; a body left
+// far behind is only as precise as its distance from the player.  The
+// solvers index the solidity bitmap through tileX()/tileY(), the map tile
+// at the origin.  Convert at the boundary with localX()/localY() and, for
+// drawing, worldX(px).relativeTo(camera).
+constexpr int SIM_REBASE_CHUNKS = 1;    // chunks the player may be from the origin before it follows
+
+struct SimOrigin {
+    int32_t chunkX{ 0 };
+    int32_t chunkY{ 0 };
+
+    float localX(const WorldCoord& c) const { return (float)(c.chunk - chunkX) * WORLD_CHUNK_SIZE + c.local; }
+    float localY(const WorldCoord& c) const { return (float)(c.chunk - chunkY) * WORLD_CHUNK_SIZE + c.local; }
+
+    WorldCoord worldX(float px) const {
+        WorldCoord c{ chunkX, px };
+        c.normalize();
+        return c;
+    }
+
+    WorldCoord worldY(float py) const {
+        WorldCoord c{ chunkY, py };
+        c.normalize();
+        return c;
+    }
+
+    int tileX() const { return chunkX * TILES_PER_CHUNK; }
+    int tileY() const { return chunkY * TILES_PER_CHUNK; }
+
+    // Move onto the chunk of `p` once it is more than SIM_REBASE_CHUNKS
+    // away.  Returns whether it moved, and the whole-chunk shift every body
+    // position must get.
+    bool follow(const WorldPos& p, float& shiftX, float& shiftY) {
+        if (std::abs(p.x.chunk - chunkX) <= SIM_REBASE_CHUNKS && std::abs(p.y.chunk - chunkY) <= SIM_REBASE_CHUNKS) {
+            return false;
+        }
+        shiftX = (float)(chunkX - p.x.chunk) * WORLD_CHUNK_SIZE;
+        shiftY = (float)(chunkY - p.y.chunk) * WORLD_CHUNK_SIZE;
+        chunkX = p.x.chunk;
+        chunkY = p.y.chunk;
+        return true;
+    }
+};
+
+// Coins (tile coordinates).  Collection is tracked as one bit per coin.
+struct CoinTile {
+    int x, y;
+};
+constexpr int COIN_COUNT = 6;
+constexpr std::array<CoinTile, COIN_COUNT> LEVEL_COINS = {{
+    { 6, 14 }, { 10, 12 }, { 14, 14 }, { 18, 11 }, { 22, 14 }, { 27, 10 }
+}};
+
+// Section 14 – Dynamic Bodies: crates and boulders placed in the level
+// (bottom-left tile, size in px).  Simulated by crates.h.
+struct CrateSpawn {
+    int tileX, tileY;
+    int w, h;
+    float mass;
+};
+constexpr int CRATE_COUNT = 6;
+constexpr std::array<CrateSpawn, CRATE_COUNT> LEVEL_CRATES = {{
+    { 12, 14, 16, 16, 1.0f }, { 12, 13, 16, 16, 1.0f }, { 12, 12, 16, 16, 1.0f },
+    { 16, 14, 16, 16, 1.0f }, { 17, 14, 16, 16, 1.0f }, { 24, 14, 24, 24, 4.0f }
+}};
+
+// Ropes and bridges (px): a rope hangs from (ax, ay) with its free end at
+// (bx, by); a bridge is pinned at both.  Simulated by ropes.h.
+struct RopeSpawn {
+    float ax, ay, bx, by;
+    int links;
+    bool bridge;
+};
+constexpr int ROPE_COUNT = 3;
+constexpr std::array<RopeSpawn, ROPE_COUNT> LEVEL_ROPES = {{
+    {  72.0f,  32.0f,  72.0f, 128.0f,  8, false },
+    { 312.0f,  16.0f, 312.0f, 144.0f, 10, false },
+    { 400.0f, 160.0f, 480.0f, 160.0f, 10, true  }
+}};
+
+// Section 2 – Camera (smooth follow)
+// The camera is the rendering origin: everything on screen is drawn at its
+// offset relative to `position`, so screen-space math stays in small floats.
+struct Camera {
+    WorldPos position{};
+    Vec2 velocity{};
+    // Update camera using a critically damped spring toward target
+    void update(const WorldPos& target, float dt) {
+        // Offset from the camera to the position that puts target near the center of the screen
+        Vec2 diff{ target.x.relativeTo(position.x) - NATIVE_W * 0.5f + PLAYER_W * 0.5f,
+                   target.y.relativeTo(position.y) - NATIVE_H * 0.5f + PLAYER_H * 0.5f };
+        float stiffness = 60.0f;      // spring stiffness
+        float damping   = 2.0f * std::sqrt(stiffness); // critical damping
+        // Spring force
+        velocity.x += diff.x * stiffness * dt;
+        velocity.y += diff.y * stiffness * dt;
+        // Damping
+        velocity.x *= std::exp(-damping * dt);
+        velocity.y *= std::exp(-damping * dt);
+        // Integrate
+        position.x.local += velocity.x * dt;
+        position.y.local += velocity.y * dt;
+        position.normalize();
+        // Clamp to level bounds (Section 2 – Bounds)
+        static const WorldPos minPos = WorldPos::fromPixels(0.0, 0.0);
+        static const WorldPos maxPos = WorldPos::fromPixels(LEVEL_WIDTH * TILE_SIZE - NATIVE_W,
+                                                            LEVEL_HEIGHT * TILE_SIZE - NATIVE_H);
+        if (position.x.relativeTo(minPos.x) < 0) position.x = minPos.x;
+        if (position.y.relativeTo(minPos.y) < 0) position.y = minPos.y;
+        if (position.x.relativeTo(maxPos.x) > 0) position.x = maxPos.x;
+        if (position.y.relativeTo(maxPos.y) > 0) position.y = maxPos.y;
+    }
+};
+
+// Section 4 – Input (sampled once per tick by the platform layer)
+struct PlayerInput {
+    bool left{ false };
+    bool right{ false };
+    bool jump{ false };
+    bool bomb{ false };       // drop a bomb (terrain.h)
+};
+
+// Section 7 – Tile Collision
+// An entity box of w×h pixels sweeps against the solidity bitmap: down
+// (landing), then left or right.  TileBox<W, H> fixes the size at compile
+// time, which bounds how many tiles an edge can span – at most
+// (W-1)/TILE_SIZE + 2 – so each probe loop runs a constant count,
+// clamped to the last tile, and unrolls completely with no early exit.
+// DynamicTileBox is the runtime-size fallback for entities whose size is
+// data.  Both give identical results (bench_collision checks this).
+template <int W, int H>
+struct TileBox {
+    static_assert(W > 0 && H > 0, "empty entity box");
+    static constexpr int w = W;
+    static constexpr int h = H;
+    static constexpr int SPAN_X = (W - 1) / TILE_SIZE + 2;
+    static constexpr int SPAN_Y = (H - 1) / TILE_SIZE + 2;
+
+    // Any solid tile in row y between x0 and x1 (at most SPAN_X tiles)?
+    // One bounds check covers the span; outside the map is solid.
+    static bool rowSolid(const SolidityBitmap& tiles, int x0, int x1, int y) {
+        if (y < 0 || y >= tiles.height || x0 < 0 || x1 >= tiles.width) return true;
+        bool hit = false;
+        for (int k = 0; k < SPAN_X; ++k) hit |= tiles.solidInBounds(std::min(x0 + k, x1), y);
+        return hit;
+    }
+    static bool columnSolid(const SolidityBitmap& tiles, int x, int y0, int y1) {
+        if (x < 0 || x >= tiles.width || y0 < 0 || y1 >= tiles.height) return true;
+        bool hit = false;
+        for (int k = 0; k < SPAN_Y; ++k) hit |= tiles.solidInBounds(x, std::min(y0 + k, y1));
+        return hit;
+    }
+};
+
+struct DynamicTileBox {
+    int w;
+    int h;
+
+    static bool rowSolid(const SolidityBitmap& tiles, int x0, int x1, int y) {
+        for (int x = x0; x <= x1; ++x) {
+            if (tiles.solid(x, y)) return true;
+        }
+        return false;
+    }
+    static bool columnSolid(const SolidityBitmap& tiles, int x, int y0, int y1) {
+        for (int y = y0; y <= y1; ++y) {
+            if (tiles.solid(x, y)) return true;
+        }
+        return false;
+    }
+};
+
+// Moves `pos` (already integrated) out of solid tiles and zeroes the
+// blocked velocity components.  Returns true when the box landed.
+template <typename Box>
+inline bool resolveTileCollisions(const Box& box, WorldPos& pos, Vec2& velocity, const SolidityBitmap& tiles) {
+    const int chunkTileX = pos.x.chunk * TILES_PER_CHUNK;
+    const int chunkTileY = pos.y.chunk * TILES_PER_CHUNK;
+    bool landed = false;
+    // Y collisions
+    if (velocity.y > 0.0f) {
+        int bottom = pos.y.tile(TILE_SIZE, (float)box.h);
+        int leftTile  = pos.x.tile(TILE_SIZE);
+        int rightTile = pos.x.tile(TILE_SIZE, (float)(box.w - 1));
+        if (Box::rowSolid(tiles, leftTile, rightTile, bottom)) {
+            pos.y.local = (float)((bottom - chunkTileY) * TILE_SIZE - box.h);
+            velocity.y = 0.0f;
+            landed = true;
+        }
+    } else if (velocity.y < 0.0f) {
+        // upward collision (omitted)
+    }
+    // X collisions
+    int top = pos.y.tile(TILE_SIZE);
+    int bottomY = pos.y.tile(TILE_SIZE, (float)(box.h - 1));
+    if (velocity.x != 0.0f) {
+        // The leading edge, picked with selects: direction is a coin flip
+        // across a crowd of entities and would mispredict as a branch
+        const bool right = velocity.x > 0.0f;
+        const int edge = right ? box.w : 0;
+        int column = pos.x.tile(TILE_SIZE, (float)edge);
+        if (Box::columnSolid(tiles, column, top, bottomY)) {
+            pos.x.local = (float)((column + (right ? 0 : 1) - chunkTileX) * TILE_SIZE - edge);
+            velocity.x = 0.0f;
+        }
+    }
+    return landed;
+}
+
+// Section 7/8 – Player Movement & Jumping
+struct Player {
+    WorldPos position{};
+    Vec2 velocity{};
+    PlayerState state{ PlayerState::Idle };
+    bool onGround{ false };
+    float jumpBufferTimer{ 0.0f };
+    float coyoteTimer{ 0.0f };
+
+    // Collides against the live tile map; outside the map is solid.
+    void update(const PlayerInput& input, float dt, const SolidityBitmap& tiles) {
+        if (jumpBufferTimer > 0.0f) jumpBufferTimer -= dt;
+        if (coyoteTimer     > 0.0f) coyoteTimer     -= dt;
+        bool left  = input.left;
+        bool right = input.right;
+        bool jump  = input.jump;
+        float desiredAccel = 0.0f;
+        if (left ^ right) {
+            desiredAccel = (left ? -1.0f : 1.0f) * (onGround ? GROUND_ACCEL : AIR_ACCEL);
+        } else {
+            if (onGround) {
+                if (velocity.x > 0.0f) desiredAccel = -GROUND_DECEL;
+                else if (velocity.x < 0.0f) desiredAccel = GROUND_DECEL;
+            } else {
+                if (velocity.x > 0.0f) desiredAccel = -AIR_DECEL;
+                else if (velocity.x < 0.0f) desiredAccel = AIR_DECEL;
+            }
+        }
+        velocity.x += desiredAccel * dt;
+        if (velocity.x >  MAX_RUN_SPEED) velocity.x =  MAX_RUN_SPEED;
+        if (velocity.x < -MAX_RUN_SPEED) velocity.x = -MAX_RUN_SPEED;
+        if (jump) {
+            jumpBufferTimer = 0.09f;
+        }
+        if (jumpBufferTimer > 0.0f && (onGround || coyoteTimer > 0.0f)) {
+            velocity.y = JUMP_V0;
+            onGround = false;
+            jumpBufferTimer = 0.0f;
+            coyoteTimer = 0.0f;
+        }
+        velocity.y += GRAVITY * dt;
+        // Integrate in chunk-local coordinates; tile indices are offset by
+        // the chunk origin so the float part never exceeds one chunk.
+        WorldPos newPos = position;
+        newPos.x.local += velocity.x * dt;
+        newPos.y.local += velocity.y * dt;
+        if (resolveTileCollisions(TileBox<PLAYER_W, PLAYER_H>{}, newPos, velocity, tiles)) {
+            onGround = true;
+            coyoteTimer = 0.1f;
+        }
+        newPos.normalize();
+        position = newPos;
+        // State update
+        if (!onGround) {
+            state = (velocity.y < 0.0f) ? PlayerState::JumpRise : PlayerState::Fall;
+        } else {
+            state = (std::abs(velocity.x) > 1.0f) ? PlayerState::Run : PlayerState::Idle;
+        }
+    }
+};
+
+// Section 15 – Pickups & Hazards
+// Returns the bits of coins (not already in `collected`) that the player's
+// box overlaps this tick.
+inline uint32_t touchCoins(const Player& player, uint32_t collected) {
+    int x0 = player.position.x.tile(TILE_SIZE);
+    int x1 = player.position.x.tile(TILE_SIZE, PLAYER_W - 1);
+    int y0 = player.position.y.tile(TILE_SIZE);
+    int y1 = player.position.y.tile(TILE_SIZE, PLAYER_H - 1);
+    uint32_t touched = 0;
+    for (int i = 0; i < COIN_COUNT; ++i) {
+        const CoinTile& c = LEVEL_COINS[i];
+        if (c.x >= x0 && c.x <= x1 && c.y >= y0 && c.y <= y1) touched |= 1u << i;
+    }
+    return touched & ~collected;
+}
+
+inline bool belowKillPlane(const Player& player) {
+    return player.position.y.pixels() > KILL_PLANE_Y;
+}
+
+inline void respawn(Player& player) {
+    player = Player{};
+    player.position = WorldPos::fromPixels(PLAYER_SPAWN_X, PLAYER_SPAWN_Y);
+}
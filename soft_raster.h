@@ -0,0 +1,195 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SOFT_RASTER_HAS_SSE2 1
+#endif
+
+//----------------------------------------------------------------------------
+// Software Rasterizer (Section 1 – Rendering)
+//----------------------------------------------------------------------------
+// A CPU implementation of the handful of operations the game sends to the
+// renderer (render_capture.h): clear, solid rects, polylines and nearest-
+// neighbour texture copies, each either overwriting (SDL_BLENDMODE_NONE) or
+// alpha blending (SDL_BLENDMODE_BLEND) into an ARGB8888 surface.  It lets
+// render_replay time a capture with no GPU and no SDL renderer in the way.
+//
+// Spans are written four pixels at a time with SSE2; blending widens each
+// pixel to 16-bit lanes and divides by 255 with exact rounding, so the
+// scalar fallback (build with -U__SSE2__) produces identical pixels.
+// Blending follows SDL's formula: rgb = src*a + dst*(1-a), a = a + dst_a*(1-a).
+//
+
+struct SoftRect {
+    int x, y, w, h;
+};
+
+struct SoftSurface {
+    int width{ 0 };
+    int height{ 0 };
+    std::vector<uint32_t> pixels;
+
+    void resize(int w, int h) {
+        width = w;
+        height = h;
+        pixels.assign((size_t)w * h, 0);
+    }
+    uint32_t* row(int y) { return &pixels[(size_t)y * width]; }
+    const uint32_t* row(int y) const { return &pixels[(size_t)y * width]; }
+};
+
+namespace soft_raster_detail {
+
+// round(t / 255) for t in [0, 65025]
+inline uint32_t div255(uint32_t t) {
+    t += 128;
+    return (t + (t >> 8)) >> 8;
+}
+
+inline uint32_t blendPixel(uint32_t s, uint32_t d) {
+    const uint32_t a = s >> 24, inv = 255 - a;
+    uint32_t out = div255(a * 255 + (d >> 24) * inv) << 24;
+    for (int shift = 0; shift < 24; shift += 8) {
+        out |= div255(((s >> shift) & 0xFF) * a + ((d >> shift) & 0xFF) * inv) << shift;
+    }
+    return out;
+}
+
+#if defined(SOFT_RASTER_HAS_SSE2)
+// Two pixels widened to 16-bit lanes (B, G, R, A each)
+inline __m128i blendLanes(__m128i s, __m128i d) {
+    const __m128i alphaLane = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+    const __m128i colorMask = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+    __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, 0xFF), 0xFF);
+    __m128i inv = _mm_sub_epi16(_mm_set1_epi16(255), a);
+    // The alpha lane takes src_a*255 so it comes out as a + dst_a*(1-a)
+    __m128i mulS = _mm_or_si128(_mm_and_si128(a, colorMask), alphaLane);
+    __m128i t = _mm_add_epi16(_mm_mullo_epi16(s, mulS), _mm_mullo_epi16(d, inv));
+    t = _mm_add_epi16(t, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+inline __m128i blend4(__m128i s, __m128i d) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lo = blendLanes(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero));
+    __m128i hi = blendLanes(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero));
+    return _mm_packus_epi16(lo, hi);
+}
+#endif
+
+inline void fillRow(uint32_t* dst, int n, uint32_t color) {
+    int i = 0;
+#if defined(SOFT_RASTER_HAS_SSE2)
+    const __m128i c = _mm_set1_epi32((int)color);
+    for (; i + 4 <= n; i += 4) _mm_storeu_si128((__m128i*)(dst + i), c);
+#endif
+    for (; i < n; ++i) dst[i] = color;
+}
+
+inline void blendColorRow(uint32_t* dst, int n, uint32_t color) {
+    int i = 0;
+#if defined(SOFT_RASTER_HAS_SSE2)
+    const __m128i c = _mm_set1_epi32((int)color);
+    for (; i + 4 <= n; i += 4) {
+        __m128i* p = (__m128i*)(dst + i);
+        _mm_storeu_si128(p, blend4(c, _mm_loadu_si128(p)));
+    }
+#endif
+    for (; i < n; ++i) dst[i] = blendPixel(color, dst[i]);
+}
+
+inline void blendRow(uint32_t* dst, const uint32_t* src, int n) {
+    int i = 0;
+#if defined(SOFT_RASTER_HAS_SSE2)
+    for (; i + 4 <= n; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        // Fully transparent or fully opaque runs (most tile pixels) skip the math
+        int opaque = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_srli_epi32(s, 24), _mm_set1_epi32(255)));
+        if (opaque == 0xFFFF) {
+            _mm_storeu_si128((__m128i*)(dst + i), s);
+            continue;
+        }
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_srli_epi32(s, 24), _mm_setzero_si128())) == 0xFFFF) continue;
+        __m128i* p = (__m128i*)(dst + i);
+        _mm_storeu_si128(p, blend4(s, _mm_loadu_si128(p)));
+    }
+#endif
+    for (; i < n; ++i) dst[i] = blendPixel(src[i], dst[i]);
+}
+
+} // namespace soft_raster_detail
+
+// Clip `r` to the surface; false if nothing is left.
+inline bool clipToSurface(const SoftSurface& s, SoftRect& r) {
+    int x0 = std::max(r.x, 0), y0 = std::max(r.y, 0);
+    int x1 = std::min(r.x + r.w, s.width), y1 = std::min(r.y + r.h, s.height);
+    if (x1 <= x0 || y1 <= y0) return false;
+    r = { x0, y0, x1 - x0, y1 - y0 };
+    return true;
+}
+
+inline void softClear(SoftSurface& s, uint32_t color) {
+    soft_raster_detail::fillRow(s.pixels.data(), (int)s.pixels.size(), color);
+}
+
+inline void softFillRect(SoftSurface& s, SoftRect r, uint32_t color, bool blend) {
+    if (!clipToSurface(s, r)) return;
+    if (blend && (color >> 24) == 0) return;
+    const bool overwrite = !blend || (color >> 24) == 255;
+    for (int y = r.y; y < r.y + r.h; ++y) {
+        uint32_t* row = s.row(y) + r.x;
+        if (overwrite) soft_raster_detail::fillRow(row, r.w, color);
+        else soft_raster_detail::blendColorRow(row, r.w, color);
+    }
+}
+
+// Bresenham line including both end points
+inline void softDrawLine(SoftSurface& s, int x0, int y0, int x1, int y1, uint32_t color, bool blend) {
+    int dx = std::abs(x1 - x0), dy = -std::abs(y1 - y0);
+    int sx = x0 < x1 ? 1 : -1, sy = y0 < y1 ? 1 : -1;
+    for (int err = dx + dy;;) {
+        if (x0 >= 0 && y0 >= 0 && x0 < s.width && y0 < s.height) {
+            uint32_t& p = s.row(y0)[x0];
+            p = blend ? soft_raster_detail::blendPixel(color, p) : color;
+        }
+        if (x0 == x1 && y0 == y1) break;
+        int e2 = 2 * err;
+        if (e2 >= dy) { err += dy; x0 += sx; }
+        if (e2 <= dx) { err += dx; y0 += sy; }
+    }
+}
+
+// Copy `src` (whole texture if null) scaled nearest-neighbour into `dst`
+// (whole surface if null).  `scratch` holds one scaled row between calls.
+inline void softCopy(SoftSurface& target, const SoftSurface& texture, const SoftRect* srcRect,
+                     const SoftRect* dstRect, bool blend, std::vector<uint32_t>& scratch) {
+    SoftRect src = srcRect ? *srcRect : SoftRect{ 0, 0, texture.width, texture.height };
+    if (!clipToSurface(texture, src)) return;
+    const SoftRect full = dstRect ? *dstRect : SoftRect{ 0, 0, target.width, target.height };
+    if (full.w <= 0 || full.h <= 0) return;
+    SoftRect dst = full;
+    if (!clipToSurface(target, dst)) return;
+    // 16.16 steps from destination pixel centres back into the source
+    const int64_t stepX = ((int64_t)src.w << 16) / full.w, stepY = ((int64_t)src.h << 16) / full.h;
+    const bool unscaled = src.w == full.w;
+    if (!unscaled) scratch.resize((size_t)dst.w);
+    for (int y = dst.y; y < dst.y + dst.h; ++y) {
+        int sy = src.y + (int)(((int64_t)(y - full.y) * stepY + stepY / 2) >> 16);
+        const uint32_t* in = texture.row(sy) + src.x;
+        if (unscaled) {
+            in += dst.x - full.x;
+        } else {
+            int64_t fx = (int64_t)(dst.x - full.x) * stepX + stepX / 2;
+            for (int i = 0; i < dst.w; ++i, fx += stepX) scratch[i] = in[fx >> 16];
+            in = scratch.data();
+        }
+        uint32_t* out = target.row(y) + dst.x;
+        if (blend) soft_raster_detail::blendRow(out, in, dst.w);
+        else std::memcpy(out, in, (size_t)dst.w * sizeof(uint32_t));
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+//----------------------------------------------------------------------------
+// Tile Solidity Bitmap (Section 13 – Tile Layer)
+//----------------------------------------------------------------------------
+// One bit per tile, 64 tiles per word, rows padded to whole words.  Queries
+// that sweep along a row test up to 64 tiles with a mask and a single AND
+// instead of one tile lookup per tile.  Everything outside the map reads as
+// solid.  This is what all movement collides against; terrain edits update
+// it bit by bit through set() (terrain.h).
+//
+
+struct SolidityBitmap {
+    int width{ 0 };
+    int height{ 0 };
+    int wordsPerRow{ 0 };
+    std::vector<uint64_t> words;
+
+    // Non-zero tile ids are solid, unless `isSolid` says otherwise.
+    void build(const uint8_t* tiles, int w, int h, bool (*isSolid)(uint8_t) = nullptr) {
+        width = w;
+        height = h;
+        wordsPerRow = (w + 63) / 64;
+        words.assign((size_t)wordsPerRow * h, 0);
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                uint8_t t = tiles[y * w + x];
+                if (isSolid ? isSolid(t) : t != 0) set(x, y, true);
+            }
+        }
+    }
+
+    bool inBounds(int x, int y) const {
+        return x >= 0 && y >= 0 && x < width && y < height;
+    }
+
+    bool solid(int x, int y) const {
+        if (!inBounds(x, y)) return true;
+        return solidInBounds(x, y);
+    }
+
+    // solid() for callers that have already bounds-checked a whole span
+    bool solidInBounds(int x, int y) const {
+        return (words[(size_t)y * wordsPerRow + (x >> 6)] >> (x & 63)) & 1u;
+    }
+
+    void set(int x, int y, bool value) {
+        if (!inBounds(x, y)) return;
+        uint64_t& w = words[(size_t)y * wordsPerRow + (x >> 6)];
+        uint64_t bit = 1ull << (x & 63);
+        w = value ? (w | bit) : (w & ~bit);
+    }
+
+    // Any solid tile in row y between x0 and x1 inclusive?
+    bool anySolid(int x0, int x1, int y) const {
+        if (y < 0 || y >= height || x0 < 0 || x1 >= width) return true;
+        const uint64_t* row = &words[(size_t)y * wordsPerRow];
+        int w0 = x0 >> 6, w1 = x1 >> 6;
+        for (int w = w0; w <= w1; ++w) {
+            uint64_t mask = ~0ull;
+            if (w == w0) mask &= ~0ull << (x0 & 63);
+            if (w == w1 && (x1 & 63) != 63) mask &= (1ull << ((x1 & 63) + 1)) - 1;
+            if (row[w] & mask) return true;
+        }
+        return false;
+    }
+};
@@ -0,0 +1,73 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <vector>
+
+//----------------------------------------------------------------------------
+// Spatial Partition (Section 13 – Broadphase)
+//----------------------------------------------------------------------------
+// Hashed uniform grid rebuilt from scratch every tick with a counting sort:
+// one pass to count entities per bucket, a prefix sum, and one pass to
+// scatter indices.  Build cost is linear in entity count and the storage is
+// reused between ticks, so steady-state rebuilds do not allocate.
+//
+// Buckets are a power-of-two table addressed by a hash of the cell
+// coordinates, so the world does not need fixed bounds.  Different cells can
+// share a bucket; callers always filter candidates by distance.
+//
+
+struct SpatialGrid {
+    float cellSize{ 32.0f };
+    float invCellSize{ 1.0f / 32.0f };
+    uint32_t tableMask{ 0 };
+    std::vector<uint32_t> bucketStart;   // tableSize + 1 prefix offsets into `entries`
+    std::vector<uint32_t> entries;       // entity indices grouped by bucket
+    std::vector<uint32_t> bucketOf;      // bucket of each entity
+    std::vector<uint32_t> slotOf;        // position of each entity inside `entries`
+
+    void setCellSize(float size) {
+        cellSize = size;
+        invCellSize = 1.0f / size;
+    }
+
+    int cellCoord(float v) const {
+        return (int)std::floor(v * invCellSize);
+    }
+
+    uint32_t bucket(int cx, int cy) const {
+        uint32_t h = (uint32_t)cx * 0x8DA6B343u ^ (uint32_t)cy * 0xD8163841u;
+        return h & tableMask;
+    }
+
+    void build(const float* xs, const float* ys, size_t count) {
+        size_t tableSize = 16;
+        while (tableSize < count * 2) tableSize <<= 1;
+        if (bucketStart.size() != tableSize + 1) bucketStart.assign(tableSize + 1, 0);
+        else std::fill(bucketStart.begin(), bucketStart.end(), 0u);
+        tableMask = (uint32_t)tableSize - 1;
+        entries.resize(count);
+        bucketOf.resize(count);
+        slotOf.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t b = bucket(cellCoord(xs[i]), cellCoord(ys[i]));
+            bucketOf[i] = b;
+            ++bucketStart[b + 1];
+        }
+        for (size_t b = 0; b < tableSize; ++b) bucketStart[b + 1] += bucketStart[b];
+        // Scatter; a running cursor per bucket reuses bucketStart shifted by one
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t slot = bucketStart[bucketOf[i]]++;
+            entries[slot] = (uint32_t)i;
+            slotOf[i] = slot;
+        }
+        // Undo the cursor shift so bucketStart[b] is the first slot of bucket b
+        for (size_t b = tableSize; b > 0; --b) bucketStart[b] = bucketStart[b - 1];
+        bucketStart[0] = 0;
+    }
+
+    // Entities whose bucket matches cell (cx, cy), in ascending index order.
+    const uint32_t* bucketBegin(int cx, int cy) const { return entries.data() + bucketStart[bucket(cx, cy)]; }
+    const uint32_t* bucketEnd(int cx, int cy)   const { return entries.data() + bucketStart[bucket(cx, cy) + 1]; }
+};
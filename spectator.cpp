@@ -0,0 +1,157 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include "spectator_stream.h"
+
+// Spectator Client (Section 4 – Input Recording)
+// Connects to a game started with --spectate, resimulates the streamed
+// inputs locally (spectator_stream.h) and renders the result: tiles,
+// coins, crates, the armed bomb, ropes and the player, followed by a
+// camera of its own.  Joining late replays the session from the start at
+// up to --catchup ticks per frame, then keeps pace with the game.
+// --headless skips the window: it resimulates until the game quits and
+// exits non-zero on a desync or a dropped connection, for scripted
+// localhost checks.
+//
+// Build: g++ -O2 -std=c++17 -pthread spectator.cpp -o spectator `sdl2-config --cflags --libs`
+// Usage: spectator [--host HOST] [--port PORT] [--catchup TICKS] [--headless]
+
+constexpr size_t DEFAULT_CATCHUP_TICKS = 600;
+
+static const SDL_Color TILE_COLORS[TILE_ID_COUNT] = {   // by TileId, as main.cpp's tile chunks
+    { 0, 0, 0, 0 }, { 107, 74, 47, 255 }, { 154, 123, 79, 255 }, { 70, 70, 70, 255 },
+    { 216, 192, 120, 255 }, { 40, 96, 208, 176 }, { 208, 64, 16, 255 }
+};
+
+static void draw(SDL_Renderer* renderer, const GameWorld& w, std::vector<SDL_Point>& points) {
+    const WorldPos& cam = w.camera.position;
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 92, 148, 252, 255);
+    SDL_RenderClear(renderer);
+    const int x0 = std::max(0, cam.x.tile(TILE_SIZE)), y0 = std::max(0, cam.y.tile(TILE_SIZE));
+    const int x1 = std::min(w.terrain.width - 1, cam.x.tile(TILE_SIZE, (float)NATIVE_W));
+    const int y1 = std::min(w.terrain.height - 1, cam.y.tile(TILE_SIZE, (float)NATIVE_H));
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            const uint8_t id = w.terrain.tiles[(size_t)y * w.terrain.width + x];
+            if (id == TILE_EMPTY || id >= TILE_ID_COUNT) continue;
+            const SDL_Color& c = TILE_COLORS[id];
+            SDL_SetRenderDrawColor(renderer, c.r, c.g, c.b, c.a);
+            SDL_Rect r{ (int)std::floor(WorldCoord::fromTile(x, TILE_SIZE).relativeTo(cam.x)),
+                        (int)std::floor(WorldCoord::fromTile(y, TILE_SIZE).relativeTo(cam.y)), TILE_SIZE, TILE_SIZE };
+            SDL_RenderFillRect(renderer, &r);
+        }
+    }
+    SDL_SetRenderDrawColor(renderer, 255, 215, 0, 255);
+    for (int i = 0; i < COIN_COUNT; ++i) {
+        if (w.coins & (1u << i)) continue;
+        SDL_Rect r{ (int)std::floor(WorldCoord::fromTile(LEVEL_COINS[i].x, TILE_SIZE).relativeTo(cam.x)) + 4,
+                    (int)std::floor(WorldCoord::fromTile(LEVEL_COINS[i].y, TILE_SIZE).relativeTo(cam.y)) + 4,
+                    TILE_SIZE - 8, TILE_SIZE - 8 };
+        SDL_RenderFillRect(renderer, &r);
+    }
+    SDL_SetRenderDrawColor(renderer, 150, 100, 50, 255);
+    const PhysicsBodies& b = w.crates.physics.bodies;
+    for (size_t i = 0; i < w.crates.crateCount(); ++i) {
+        SDL_Rect r{ (int)std::floor(w.crates.origin.worldX(b.x[i] - b.halfW[i]).relativeTo(cam.x)),
+                    (int)std::floor(w.crates.origin.worldY(b.y[i] - b.halfH[i]).relativeTo(cam.y)),
+                    (int)(b.halfW[i] * 2.0f), (int)(b.halfH[i] * 2.0f) };
+        SDL_RenderFillRect(renderer, &r);
+    }
+    if (w.terrain.bombArmed) {
+        SDL_SetRenderDrawColor(renderer, 120, 20, 20, 255);
+        SDL_Rect r{ (int)std::floor(w.terrain.bomb.x.relativeTo(cam.x)) - 4, (int)std::floor(w.terrain.bomb.y.relativeTo(cam.y)) - 4, 8, 8 };
+        SDL_RenderFillRect(renderer, &r);
+    }
+    SDL_SetRenderDrawColor(renderer, 200, 170, 110, 255);
+    for (const VerletRope& r : w.ropes.verlet.ropes) {
+        points.clear();
+        for (uint32_t k = r.first; k < r.first + r.count; ++k) {
+            points.push_back({ (int)std::floor(w.ropes.origin.worldX(w.ropes.verlet.x[k]).relativeTo(cam.x)),
+                               (int)std::floor(w.ropes.origin.worldY(w.ropes.verlet.y[k]).relativeTo(cam.y)) });
+        }
+        SDL_RenderDrawLines(renderer, points.data(), (int)points.size());
+    }
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    SDL_Rect p{ (int)w.player.position.x.relativeTo(cam.x), (int)w.player.position.y.relativeTo(cam.y), PLAYER_W, PLAYER_H };
+    SDL_RenderFillRect(renderer, &p);
+    SDL_RenderPresent(renderer);
+}
+
+static int report(const SpectatorClient& client, const GameWorld& world) {
+    std::printf("%u ticks, %u/%zu snapshots matched, %u desyncs, %s\n", world.tick, client.matched,
+                client.snapshots.size(), client.desyncs, client.ended ? "game ended" : "connection lost");
+    return client.ended && client.desyncs == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    const char* host = "127.0.0.1";
+    uint16_t port = SPECTATOR_DEFAULT_PORT;
+    size_t catchup = DEFAULT_CATCHUP_TICKS;
+    bool headless = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--host") == 0 && i + 1 < argc) host = argv[++i];
+        else if (std::strcmp(argv[i], "--port") == 0 && i + 1 < argc) port = (uint16_t)std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--catchup") == 0 && i + 1 < argc) catchup = (size_t)std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--headless") == 0) headless = true;
+    }
+    SpectatorClient client;
+    if (!client.connect(host, port)) {
+        std::fprintf(stderr, "Could not connect to %s:%u\n", host, (unsigned)port);
+        return 1;
+    }
+    std::unique_ptr<GameWorld> world(new GameWorld);
+    world->reset();
+
+    if (headless) {
+        while (client.receive()) {
+            client.advance(*world, SIZE_MAX);
+            std::this_thread::sleep_for(std::chrono::milliseconds(SPECTATOR_POLL_MS));
+        }
+        client.advance(*world, SIZE_MAX);
+        return report(client, *world);
+    }
+
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        SDL_Log("SDL_Init failed: %s", SDL_GetError());
+        return 1;
+    }
+    SDL_Window* window = SDL_CreateWindow("Spectator", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, NATIVE_W * 2,
+                                          NATIVE_H * 2, SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE);
+    SDL_Renderer* renderer = window ? SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC) : nullptr;
+    if (!renderer) {
+        SDL_Log("Failed to create window or renderer");
+        return 1;
+    }
+    SDL_RenderSetLogicalSize(renderer, NATIVE_W, NATIVE_H);
+    std::vector<SDL_Point> points;
+    char title[128];
+    uint32_t shownTick = UINT32_MAX;
+    bool running = true, live = true;
+    while (running) {
+        SDL_Event ev;
+        while (SDL_PollEvent(&ev)) {
+            if (ev.type == SDL_QUIT) running = false;
+        }
+        if (live) live = client.receive();
+        client.advance(*world, catchup);
+        if (world->tick != shownTick) {
+            shownTick = world->tick;
+            std::snprintf(title, sizeof(title), "Spectator - tick %u/%zu%s, %u desyncs%s", world->tick,
+                          client.inputs.size(), world->tick + catchup < client.inputs.size() ? " (catching up)" : "",
+                          client.desyncs, live ? "" : (client.ended ? ", game ended" : ", connection lost"));
+            SDL_SetWindowTitle(window, title);
+        }
+        draw(renderer, *world, points);
+    }
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    return report(client, *world);
+}
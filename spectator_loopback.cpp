@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "spectator_stream.h"
+#include "rng.h"
+
+// Spectator Loopback Test (Section 4 – Input Recording)
+// Runs the game headless (GameWorld::step, the tick main.cpp runs) with a
+// scripted player, streams it through a SpectatorServer on 127.0.0.1 and
+// has several SpectatorClients connect over real sockets: one before the
+// first tick, the rest part way through, so they catch up from the start
+// of the log.  Inputs are flushed every FRAME_TICKS ticks, so each inputs
+// message carries several.  Each client resimulates what it receives and
+// checks every snapshot.  Reports what publishing costs the sim thread;
+// exits non-zero unless every client ends with no desyncs, every snapshot
+// checked and the host's final state.
+//
+// Build: g++ -O2 -std=c++17 -pthread spectator_loopback.cpp -o spectator_loopback
+// Usage: spectator_loopback [ticks] [clients] [--realtime]
+
+constexpr int      TICK_HZ         = 60;
+constexpr uint32_t FRAME_TICKS     = 4;     // ticks per flushInputs(), a frame catching up after a hitch
+constexpr int      DRAIN_TIMEOUT_S = 5;
+
+// A bot that runs one way for a while, turns, jumps and drops bombs
+static PlayerInput scriptedInput(uint32_t tick) {
+    static bool right = true;
+    RngStream rng(0x5BEC7ull, RngSystem::AI, 0, tick);
+    if (rng.range(0.0f, 1.0f) < 1.0f / 90.0f) right = !right;
+    PlayerInput in;
+    in.right = right;
+    in.left = !right;
+    in.jump = rng.range(0.0f, 1.0f) < 0.05f;
+    in.bomb = rng.range(0.0f, 1.0f) < 0.005f;
+    return in;
+}
+
+struct Spectator {
+    SpectatorClient client;
+    GameWorld world;
+    uint32_t joinTick{ 0 };
+    bool joined{ false };
+};
+
+int main(int argc, char** argv) {
+    uint32_t ticks = 3600;
+    int clientCount = 3;
+    bool realtime = false;
+    for (int i = 1, positional = 0; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--realtime") == 0) realtime = true;
+        else if (positional++ == 0) ticks = (uint32_t)std::strtoul(argv[i], nullptr, 10);
+        else clientCount = std::max(1, std::atoi(argv[i]));
+    }
+    const float dt = TickRate::fromHz(TICK_HZ).dt;
+
+    SpectatorServer server;
+    if (!server.start(0, TICK_HZ)) {
+        std::fprintf(stderr, "Could not listen on 127.0.0.1\n");
+        return 1;
+    }
+    std::printf("%u ticks at %d Hz, %d spectators on 127.0.0.1:%u\n", ticks, TICK_HZ, clientCount,
+                (unsigned)server.port);
+
+    std::unique_ptr<GameWorld> host(new GameWorld);
+    host->reset();
+    std::vector<std::unique_ptr<Spectator>> spectators;
+    for (int i = 0; i < clientCount; ++i) {
+        spectators.emplace_back(new Spectator);
+        spectators.back()->joinTick = (uint32_t)((uint64_t)ticks * i / clientCount);
+    }
+
+    double publishNs = 0.0, worstPublishNs = 0.0;
+    uint32_t snapshotsSent = 0;
+    auto serviceClients = [&] {
+        for (std::unique_ptr<Spectator>& s : spectators) {
+            if (!s->joined) continue;
+            s->client.receive();
+            s->client.advance(s->world, SIZE_MAX);
+        }
+    };
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t t = 0; t < ticks; ++t) {
+        for (std::unique_ptr<Spectator>& s : spectators) {
+            if (s->joined || s->joinTick != t) continue;
+            if (!s->client.connect("127.0.0.1", server.port)) {
+                std::fprintf(stderr, "Spectator failed to connect\n");
+                return 1;
+            }
+            s->world.reset();
+            s->joined = true;
+        }
+        const PlayerInput in = scriptedInput(t);
+        auto p0 = std::chrono::steady_clock::now();
+        server.publishInput(packInput(in));
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - p0).count();
+        host->step(in, dt);
+        if (host->tick % TICK_HZ == 0) {
+            const SpectatorSnapshot snap = spectatorSnapshot(*host);
+            p0 = std::chrono::steady_clock::now();
+            server.publishSnapshot(snap);
+            ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - p0).count();
+            ++snapshotsSent;
+        }
+        if ((t + 1) % FRAME_TICKS == 0) {
+            p0 = std::chrono::steady_clock::now();
+            server.flushInputs();
+            ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - p0).count();
+        }
+        publishNs += ns;
+        worstPublishNs = std::max(worstPublishNs, ns);
+        serviceClients();
+        if (realtime) std::this_thread::sleep_until(start + std::chrono::microseconds((uint64_t)(t + 1) * 1000000 / TICK_HZ));
+    }
+    const double simSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    server.stop();
+
+    // Let every spectator read to the end of the stream
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(DRAIN_TIMEOUT_S);
+    for (bool open = true; open && std::chrono::steady_clock::now() < deadline;) {
+        serviceClients();
+        open = std::any_of(spectators.begin(), spectators.end(),
+                           [](const std::unique_ptr<Spectator>& s) { return s->client.connected(); });
+        if (open) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    std::printf("sim %.2f s, publish mean %.0f ns worst %.0f ns per tick, %llu bytes sent\n\n", simSeconds,
+                publishNs / ticks, worstPublishNs, (unsigned long long)server.bytesSent.load());
+    std::printf("%-9s %8s %8s %10s %8s %8s %10s\n", "spectator", "joined", "ticks", "snapshots", "desyncs", "ended",
+                "identical");
+    const SpectatorSnapshot final = spectatorSnapshot(*host);
+    bool ok = true;
+    for (size_t i = 0; i < spectators.size(); ++i) {
+        const Spectator& s = *spectators[i];
+        const bool identical = spectatorSnapshot(s.world).sameAs(final);
+        const bool good = s.client.ended && s.world.tick == ticks && s.client.desyncs == 0 &&
+                          s.client.matched == snapshotsSent && identical;
+        std::printf("%-9zu %8u %8u %5u/%-4u %8u %8s %10s\n", i, s.joinTick, s.world.tick, s.client.matched,
+                    snapshotsSent, s.client.desyncs, s.client.ended ? "yes" : "NO", identical ? "yes" : "NO");
+        ok = ok && good;
+    }
+    return ok ? 0 : 1;
+}
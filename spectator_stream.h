@@ -0,0 +1,608 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "game_world.h"
+#include "replay.h"
+#include "tick_rate.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#define SPECTATOR_SUPPORTED 1
+#endif
+
+//----------------------------------------------------------------------------
+// Spectator Streaming (Section 4 – Input Recording)
+//----------------------------------------------------------------------------
+// Live spectating over TCP, built on the same determinism as replays: the
+// game streams one input byte per tick plus a snapshot every second, and a
+// spectator resimulates the inputs locally and renders its own copy.
+//
+// Wire format: a sequence of messages, each a 3-byte frame (uint8_t type,
+// uint16_t payload size, little endian) and its payload:
+//   H  hello     the 24-byte replay header (replay.h) with tickCount 0
+//   I  inputs    packed PlayerInput bytes for the next ticks, in order
+//   S  snapshot  SPECTATOR_SNAPSHOT_SIZE bytes, see encode() below
+//   E  end       the game has quit
+// Unknown types are skipped.  A snapshot is taken after `tick` inputs have
+// been applied and carries the player's state, the coins collected and a
+// hash of terrain, crates and ropes.  A spectator checks its own state
+// against every snapshot and, on a mismatch, takes the player state from
+// it (the world hash can only be reported).
+//
+// The game side never waits on the network.  The sim thread collects the
+// ticks' input bytes and, once per frame (flushInputs), appends them as one
+// inputs message; it appends snapshots the same way, to an append-only log of fixed 64 KB blocks and publishes the
+// new length with a release store: a memcpy and an atomic, no locks and
+// no syscalls.  It does not allocate either: the server thread allocates
+// each block a block ahead of the writer (the writer would only have to if
+// it wrote 64 KB within one poll period).  The server thread polls
+// non-blocking sockets, accepts spectators and sends each one the log from
+// wherever it has got to, gathering the blocks into one sendmsg() (writev
+// with MSG_NOSIGNAL) straight from the log, with no per-client copies.
+// A spectator that joins late starts at offset 0 and catches up by
+// resimulating the whole session.  New data goes out within one poll
+// period (SPECTATOR_POLL_MS).
+//
+// Binds to the loopback address unless told otherwise.  POSIX sockets
+// only; elsewhere start() and connect() fail.
+//
+
+constexpr uint16_t SPECTATOR_DEFAULT_PORT   = 7777;
+constexpr size_t   SPECTATOR_FRAME_HEADER   = 3;
+constexpr size_t   SPECTATOR_SNAPSHOT_SIZE  = 50;
+constexpr size_t   SPECTATOR_INPUT_BATCH    = 256;           // input bytes held before a flush is forced
+constexpr size_t   SPECTATOR_BLOCK_SIZE     = 64u << 10;
+constexpr size_t   SPECTATOR_MAX_BLOCKS     = 4096;          // 256 MB, days of play
+constexpr size_t   SPECTATOR_MAX_CLIENTS    = 16;
+constexpr int      SPECTATOR_IOV_MAX        = 16;            // blocks per sendmsg
+constexpr int      SPECTATOR_POLL_MS        = 4;
+constexpr int      SPECTATOR_LINGER_MS      = 500;           // stop(): time to flush the end message
+
+enum SpectatorMessage : uint8_t {
+    SPECTATE_HELLO    = 'H',
+    SPECTATE_INPUTS   = 'I',
+    SPECTATE_SNAPSHOT = 'S',
+    SPECTATE_END      = 'E'
+};
+
+struct SpectatorSnapshot {
+    uint32_t tick{ 0 };
+    uint32_t coins{ 0 };
+    Player player{};
+    uint64_t worldHash{ 0 };
+
+    void encode(uint8_t* out) const {
+        const uint8_t state = (uint8_t)player.state, onGround = player.onGround ? 1 : 0;
+        std::memcpy(out + 0, &tick, 4);
+        std::memcpy(out + 4, &coins, 4);
+        std::memcpy(out + 8, &player.position.x.chunk, 4);
+        std::memcpy(out + 12, &player.position.x.local, 4);
+        std::memcpy(out + 16, &player.position.y.chunk, 4);
+        std::memcpy(out + 20, &player.position.y.local, 4);
+        std::memcpy(out + 24, &player.velocity.x, 4);
+        std::memcpy(out + 28, &player.velocity.y, 4);
+        std::memcpy(out + 32, &player.jumpBufferTimer, 4);
+        std::memcpy(out + 36, &player.coyoteTimer, 4);
+        std::memcpy(out + 40, &worldHash, 8);
+        out[48] = state;
+        out[49] = onGround;
+    }
+
+    void decode(const uint8_t* in) {
+        std::memcpy(&tick, in + 0, 4);
+        std::memcpy(&coins, in + 4, 4);
+        std::memcpy(&player.position.x.chunk, in + 8, 4);
+        std::memcpy(&player.position.x.local, in + 12, 4);
+        std::memcpy(&player.position.y.chunk, in + 16, 4);
+        std::memcpy(&player.position.y.local, in + 20, 4);
+        std::memcpy(&player.velocity.x, in + 24, 4);
+        std::memcpy(&player.velocity.y, in + 28, 4);
+        std::memcpy(&player.jumpBufferTimer, in + 32, 4);
+        std::memcpy(&player.coyoteTimer, in + 36, 4);
+        std::memcpy(&worldHash, in + 40, 8);
+        player.state = (PlayerState)in[48];
+        player.onGround = in[49] != 0;
+    }
+
+    // Bit-exact, so -0.0 and NaN payloads count as differences
+    bool sameAs(const SpectatorSnapshot& o) const {
+        uint8_t a[SPECTATOR_SNAPSHOT_SIZE], b[SPECTATOR_SNAPSHOT_SIZE];
+        encode(a);
+        o.encode(b);
+        return std::memcmp(a, b, sizeof(a)) == 0;
+    }
+};
+
+// FNV-1a over the tile map and every crate and rope particle position (with their origins)
+inline uint64_t spectatorWorldHash(const Terrain& terrain, const CrateWorld& crates, const RopeWorld& ropes) {
+    uint64_t h = 0xCBF29CE484222325ull;
+    auto mix = [&h](const void* data, size_t size) {
+        const uint8_t* p = (const uint8_t*)data;
+        for (size_t i = 0; i < size; ++i) h = (h ^ p[i]) * 0x100000001B3ull;
+    };
+    mix(terrain.tiles.data(), terrain.tiles.size());
+    const PhysicsBodies& b = crates.physics.bodies;
+    mix(&crates.origin, sizeof(crates.origin));
+    mix(b.x.data(), b.x.size() * sizeof(float));
+    mix(b.y.data(), b.y.size() * sizeof(float));
+    mix(&ropes.origin, sizeof(ropes.origin));
+    mix(ropes.verlet.x.data(), ropes.verlet.x.size() * sizeof(float));
+    mix(ropes.verlet.y.data(), ropes.verlet.y.size() * sizeof(float));
+    return h;
+}
+
+// What the game publishes after `world.tick` ticks, and what a spectator
+// checks its own world against
+inline SpectatorSnapshot spectatorSnapshot(const GameWorld& world) {
+    return { world.tick, world.coins, world.player, spectatorWorldHash(world.terrain, world.crates, world.ropes) };
+}
+
+// Append-only message log shared by the sim thread (single writer) and the
+// server thread (reader).  Blocks never move once allocated, so the reader
+// can send from them while the writer fills later ones.  The reader keeps
+// the block after the one being written allocated (reserveAhead); the
+// writer allocates only if it ever fills a whole block between two polls.
+struct SpectatorLog {
+    std::atomic<uint8_t*> blocks[SPECTATOR_MAX_BLOCKS]{};
+    std::atomic<uint64_t> committed{ 0 };   // bytes the reader may send
+    uint64_t written{ 0 };                  // writer only
+
+    SpectatorLog() = default;
+    SpectatorLog(const SpectatorLog&) = delete;
+    SpectatorLog& operator=(const SpectatorLog&) = delete;
+    ~SpectatorLog() {
+        for (std::atomic<uint8_t*>& b : blocks) delete[] b.load(std::memory_order_relaxed);
+    }
+
+    // Writer thread.  False once the log is full; nothing is appended then.
+    bool append(uint8_t type, const uint8_t* payload, uint16_t size) {
+        if (written + SPECTATOR_FRAME_HEADER + size > SPECTATOR_BLOCK_SIZE * SPECTATOR_MAX_BLOCKS) return false;
+        const uint8_t frame[SPECTATOR_FRAME_HEADER] = { type, (uint8_t)size, (uint8_t)(size >> 8) };
+        copyIn(frame, sizeof(frame));
+        copyIn(payload, size);
+        committed.store(written, std::memory_order_release);
+        return true;
+    }
+
+    // Reader thread: allocates the block being written and the next one
+    void reserveAhead() {
+        const size_t current = (size_t)(committed.load(std::memory_order_acquire) / SPECTATOR_BLOCK_SIZE);
+        for (size_t i = current; i < std::min(current + 2, SPECTATOR_MAX_BLOCKS); ++i) block(i);
+    }
+
+#if defined(SPECTATOR_SUPPORTED)
+    // Reader thread: iovecs covering [from, end), at most maxIov of them
+    int gather(uint64_t from, uint64_t end, iovec* iov, int maxIov) const {
+        int n = 0;
+        while (from < end && n < maxIov) {
+            const size_t offset = (size_t)(from % SPECTATOR_BLOCK_SIZE);
+            const size_t size = (size_t)std::min<uint64_t>(end - from, SPECTATOR_BLOCK_SIZE - offset);
+            iov[n].iov_base = blocks[from / SPECTATOR_BLOCK_SIZE].load(std::memory_order_acquire) + offset;
+            iov[n].iov_len = size;
+            ++n;
+            from += size;
+        }
+        return n;
+    }
+#endif
+
+private:
+    // Block i, allocated by whichever thread gets there first
+    uint8_t* block(size_t i) {
+        uint8_t* b = blocks[i].load(std::memory_order_acquire);
+        if (b) return b;
+        uint8_t* fresh = new uint8_t[SPECTATOR_BLOCK_SIZE];
+        if (blocks[i].compare_exchange_strong(b, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) return fresh;
+        delete[] fresh;
+        return b;
+    }
+
+    void copyIn(const uint8_t* data, size_t size) {
+        while (size > 0) {
+            uint8_t* b = block((size_t)(written / SPECTATOR_BLOCK_SIZE));
+            const size_t offset = (size_t)(written % SPECTATOR_BLOCK_SIZE);
+            const size_t n = std::min(size, SPECTATOR_BLOCK_SIZE - offset);
+            std::memcpy(b + offset, data, n);
+            written += n;
+            data += n;
+            size -= n;
+        }
+    }
+};
+
+#if defined(SPECTATOR_SUPPORTED)
+
+#if defined(MSG_NOSIGNAL)
+constexpr int SPECTATOR_SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SPECTATOR_SEND_FLAGS = 0;     // SO_NOSIGPIPE is set per socket instead
+#endif
+
+inline bool spectatorNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+struct SpectatorServer {
+    uint16_t port{ 0 };                         // bound port once started
+    std::atomic<uint32_t> clients{ 0 };
+    std::atomic<uint64_t> bytesSent{ 0 };
+
+    SpectatorServer() = default;
+    SpectatorServer(const SpectatorServer&) = delete;
+    SpectatorServer& operator=(const SpectatorServer&) = delete;
+    ~SpectatorServer() { stop(); }
+
+    bool active() const { return listenFd >= 0; }
+
+    // Listens on bindAddress:port (port 0 picks a free one) and starts the
+    // server thread; the hello message is the first thing every spectator
+    // receives.
+    bool start(uint16_t listenPort, uint16_t tickHz, uint64_t levelSeed = 0, uint32_t levelId = 0,
+               const char* bindAddress = "127.0.0.1") {
+        if (active()) return false;
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(listenPort);
+        if (inet_pton(AF_INET, bindAddress, &addr.sin_addr) != 1) return false;
+        listenFd = socket(AF_INET, SOCK_STREAM, 0);
+        if (listenFd < 0) return false;
+        int one = 1;
+        setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        socklen_t len = sizeof(addr);
+        if (bind(listenFd, (const sockaddr*)&addr, sizeof(addr)) != 0 || listen(listenFd, 8) != 0 ||
+            !spectatorNonBlocking(listenFd) || getsockname(listenFd, (sockaddr*)&addr, &len) != 0 ||
+            pipe(wakeFds) != 0) {
+            closeAll();
+            return false;
+        }
+        spectatorNonBlocking(wakeFds[0]);
+        spectatorNonBlocking(wakeFds[1]);
+        port = ntohs(addr.sin_port);
+        uint8_t hello[REPLAY_HEADER_SIZE];
+        writeReplayHeader(hello, tickHz, levelSeed, levelId, 0);
+        log.reserveAhead();
+        log.append(SPECTATE_HELLO, hello, sizeof(hello));
+        stopping.store(false, std::memory_order_relaxed);
+        thread = std::thread([this] { run(); });
+        return true;
+    }
+
+    // Sends the end message, gives spectators up to SPECTATOR_LINGER_MS to
+    // receive everything, then closes every socket.
+    void stop() {
+        if (!active()) return;
+        flushInputs();
+        log.append(SPECTATE_END, nullptr, 0);
+        stopping.store(true, std::memory_order_release);
+        const uint8_t wake = 1;
+        ssize_t ignored = write(wakeFds[1], &wake, 1);
+        (void)ignored;
+        thread.join();
+        closeAll();
+    }
+
+    // Sim thread only.  These append to the log; they never block or make a
+    // syscall.  Inputs are held until flushInputs(), a snapshot or a full
+    // batch, so a frame's ticks go out as one message.
+    void publishInput(uint8_t bits) {
+        if (!active()) return;
+        pendingInputs[pendingCount++] = bits;
+        if (pendingCount == SPECTATOR_INPUT_BATCH) flushInputs();
+    }
+
+    void flushInputs() {
+        if (pendingCount == 0) return;
+        log.append(SPECTATE_INPUTS, pendingInputs, (uint16_t)pendingCount);
+        pendingCount = 0;
+    }
+
+    void publishSnapshot(const SpectatorSnapshot& s) {
+        if (!active()) return;
+        flushInputs();
+        uint8_t payload[SPECTATOR_SNAPSHOT_SIZE];
+        s.encode(payload);
+        log.append(SPECTATE_SNAPSHOT, payload, sizeof(payload));
+    }
+
+private:
+    struct Client {
+        int fd;
+        uint64_t sent;
+    };
+
+    SpectatorLog log;
+    uint8_t pendingInputs[SPECTATOR_INPUT_BATCH];   // sim thread only
+    size_t pendingCount{ 0 };
+    std::thread thread;
+    std::atomic<bool> stopping{ false };
+    std::vector<Client> sockets;            // server thread only
+    int listenFd{ -1 };
+    int wakeFds[2]{ -1, -1 };
+
+    void closeAll() {
+        for (Client& c : sockets) ::close(c.fd);
+        sockets.clear();
+        clients.store(0, std::memory_order_relaxed);
+        for (int& fd : wakeFds) {
+            if (fd >= 0) ::close(fd);
+            fd = -1;
+        }
+        if (listenFd >= 0) ::close(listenFd);
+        listenFd = -1;
+    }
+
+    void acceptClients() {
+        for (;;) {
+            int fd = accept(listenFd, nullptr, nullptr);
+            if (fd < 0) return;
+            if (sockets.size() >= SPECTATOR_MAX_CLIENTS || !spectatorNonBlocking(fd)) {
+                ::close(fd);
+                continue;
+            }
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+#if defined(SO_NOSIGPIPE)
+            setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+            sockets.push_back({ fd, 0 });
+        }
+    }
+
+    // Sends as much of [c.sent, end) as the socket takes; false if it failed
+    bool flush(Client& c, uint64_t end) {
+        while (c.sent < end) {
+            iovec iov[SPECTATOR_IOV_MAX];
+            msghdr msg{};
+            msg.msg_iov = iov;
+            msg.msg_iovlen = log.gather(c.sent, end, iov, SPECTATOR_IOV_MAX);
+            ssize_t n = sendmsg(c.fd, &msg, SPECTATOR_SEND_FLAGS);
+            if (n < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+            c.sent += (uint64_t)n;
+            bytesSent.fetch_add((uint64_t)n, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    // Spectators send nothing; reading only notices a closed connection
+    static bool drain(int fd) {
+        uint8_t scratch[256];
+        for (;;) {
+            ssize_t n = recv(fd, scratch, sizeof(scratch), 0);
+            if (n > 0) continue;
+            return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+        }
+    }
+
+    void run() {
+        std::vector<pollfd> fds;
+        auto lingerEnd = std::chrono::steady_clock::time_point::max();
+        for (;;) {
+            log.reserveAhead();
+            const uint64_t end = log.committed.load(std::memory_order_acquire);
+            if (stopping.load(std::memory_order_acquire)) {
+                const auto now = std::chrono::steady_clock::now();
+                if (lingerEnd == std::chrono::steady_clock::time_point::max()) {
+                    lingerEnd = now + std::chrono::milliseconds(SPECTATOR_LINGER_MS);
+                }
+                bool flushed = std::all_of(sockets.begin(), sockets.end(), [end](const Client& c) { return c.sent == end; });
+                if (flushed || now >= lingerEnd) return;
+            }
+            fds.clear();
+            fds.push_back({ wakeFds[0], POLLIN, 0 });
+            fds.push_back({ listenFd, POLLIN, 0 });
+            for (const Client& c : sockets) fds.push_back({ c.fd, (short)(POLLIN | (c.sent < end ? POLLOUT : 0)), 0 });
+            if (poll(fds.data(), (nfds_t)fds.size(), SPECTATOR_POLL_MS) < 0 && errno != EINTR) return;
+            if (fds[0].revents & POLLIN) {
+                uint8_t scratch[16];
+                while (read(wakeFds[0], scratch, sizeof(scratch)) > 0) {}
+            }
+            if (fds[1].revents & POLLIN) acceptClients();
+            // fds[2 + i] belongs to sockets[i]; accepted sockets were appended after them
+            size_t kept = 0;
+            for (size_t i = 0; i < sockets.size(); ++i) {
+                Client& c = sockets[i];
+                const short ev = i + 2 < fds.size() ? fds[i + 2].revents : (short)POLLOUT;
+                bool ok = !(ev & (POLLERR | POLLNVAL));
+                if (ok && (ev & (POLLIN | POLLHUP))) ok = drain(c.fd);
+                if (ok && (ev & POLLOUT)) ok = flush(c, end);
+                if (ok) sockets[kept++] = c;
+                else ::close(c.fd);
+            }
+            sockets.resize(kept);
+            clients.store((uint32_t)kept, std::memory_order_relaxed);
+        }
+    }
+};
+
+// Receiving end: reads the stream without blocking and keeps everything
+// that has arrived.  advance() resimulates it into a GameWorld.
+struct SpectatorClient {
+    bool hello{ false };
+    bool ended{ false };
+    uint16_t tickHz{ 0 };
+    uint64_t levelSeed{ 0 };
+    uint32_t levelId{ 0 };
+    std::vector<uint8_t> inputs;                // every tick so far
+    std::vector<SpectatorSnapshot> snapshots;   // in tick order
+    uint32_t matched{ 0 };                      // snapshots checked and identical
+    uint32_t desyncs{ 0 };
+
+    SpectatorClient() = default;
+    SpectatorClient(const SpectatorClient&) = delete;
+    SpectatorClient& operator=(const SpectatorClient&) = delete;
+    ~SpectatorClient() { close(); }
+
+    bool connected() const { return fd >= 0; }
+
+    bool connect(const char* host, uint16_t port) {
+        close();
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        char service[8];
+        std::snprintf(service, sizeof(service), "%u", (unsigned)port);
+        addrinfo* list = nullptr;
+        if (getaddrinfo(host, service, &hints, &list) != 0) return false;
+        for (addrinfo* a = list; a && fd < 0; a = a->ai_next) {
+            fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+            if (fd < 0) continue;
+            if (::connect(fd, a->ai_addr, a->ai_addrlen) != 0 || !spectatorNonBlocking(fd)) close();
+        }
+        freeaddrinfo(list);
+        return fd >= 0;
+    }
+
+    void close() {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    }
+
+    // Takes whatever has arrived.  False once the connection is closed (check
+    // `ended` to tell a finished game from a dropped one) or the stream is
+    // malformed.
+    bool receive() {
+        if (fd < 0) return false;
+        uint8_t chunk[16384];
+        for (;;) {
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n > 0) {
+                pending.insert(pending.end(), chunk, chunk + n);
+                continue;
+            }
+            if (n < 0 && errno == EINTR) continue;
+            const bool open = n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+            if (!parse() || !open) {
+                close();
+                return false;
+            }
+            return true;
+        }
+    }
+
+    // Steps `world` through at most maxTicks received inputs, checking each
+    // snapshot when its tick comes up; a mismatched player (and coin set) is
+    // replaced by the snapshot's.  Returns the ticks stepped.
+    size_t advance(GameWorld& world, size_t maxTicks, JobSystem* jobs = nullptr) {
+        if (!hello) return 0;
+        const float dt = TickRate::fromHz(tickHz).dt;
+        size_t stepped = 0;
+        for (;;) {
+            while (nextSnapshot < snapshots.size() && snapshots[nextSnapshot].tick <= world.tick) {
+                const SpectatorSnapshot& s = snapshots[nextSnapshot++];
+                if (s.tick < world.tick) continue;
+                if (spectatorSnapshot(world).sameAs(s)) {
+                    ++matched;
+                } else {
+                    ++desyncs;
+                    world.player = s.player;
+                    world.coins = s.coins;
+                }
+            }
+            if (stepped == maxTicks || world.tick >= inputs.size()) return stepped;
+            world.step(unpackInput(inputs[world.tick]), dt, jobs);
+            ++stepped;
+        }
+    }
+
+private:
+    int fd{ -1 };
+    std::vector<uint8_t> pending;               // a partial message
+    size_t nextSnapshot{ 0 };
+
+    bool parse() {
+        size_t at = 0;
+        bool ok = true;
+        while (ok && pending.size() - at >= SPECTATOR_FRAME_HEADER) {
+            const uint8_t type = pending[at];
+            const size_t size = pending[at + 1] | (size_t)pending[at + 2] << 8;
+            if (pending.size() - at - SPECTATOR_FRAME_HEADER < size) break;
+            const uint8_t* payload = pending.data() + at + SPECTATOR_FRAME_HEADER;
+            if (type == SPECTATE_HELLO) {
+                ReplayView header;
+                ok = !hello && header.parse(payload, size) && isSupportedTickRate(header.tickHz);
+                hello = ok;
+                tickHz = header.tickHz;
+                levelSeed = header.levelSeed;
+                levelId = header.levelId;
+            } else if (type == SPECTATE_INPUTS) {
+                ok = hello;
+                inputs.insert(inputs.end(), payload, payload + size);
+            } else if (type == SPECTATE_SNAPSHOT) {
+                ok = hello && size == SPECTATOR_SNAPSHOT_SIZE;
+                if (ok) {
+                    snapshots.emplace_back();
+                    snapshots.back().decode(payload);
+                }
+            } else if (type == SPECTATE_END) {
+                ended = true;
+            }
+            at += SPECTATOR_FRAME_HEADER + size;
+        }
+        pending.erase(pending.begin(), pending.begin() + (ptrdiff_t)at);
+        return ok;
+    }
+};
+
+#else
+
+struct SpectatorServer {
+    uint16_t port{ 0 };
+    std::atomic<uint32_t> clients{ 0 };
+    std::atomic<uint64_t> bytesSent{ 0 };
+    bool active() const { return false; }
+    bool start(uint16_t, uint16_t, uint64_t = 0, uint32_t = 0, const char* = "127.0.0.1") { return false; }
+    void stop() {}
+    void publishInput(uint8_t) {}
+    void flushInputs() {}
+    void publishSnapshot(const SpectatorSnapshot&) {}
+};
+
+struct SpectatorClient {
+    bool hello{ false };
+    bool ended{ false };
+    uint16_t tickHz{ 0 };
+    uint64_t levelSeed{ 0 };
+    uint32_t levelId{ 0 };
+    std::vector<uint8_t> inputs;
+    std::vector<SpectatorSnapshot> snapshots;
+    uint32_t matched{ 0 };
+    uint32_t desyncs{ 0 };
+    bool connected() const { return false; }
+    bool connect(const char*, uint16_t) { return false; }
+    void close() {}
+    bool receive() { return false; }
+    size_t advance(GameWorld&, size_t, JobSystem* = nullptr) { return 0; }
+};
+
+#endif
+
+// Reads --spectate[=PORT] from the command line; 0 if absent.
+inline uint16_t parseSpectatePort(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--spectate") == 0) return SPECTATOR_DEFAULT_PORT;
+        if (std::strncmp(argv[i], "--spectate=", 11) == 0) {
+            long port = std::strtol(argv[i] + 11, nullptr, 10);
+            if (port > 0 && port <= 65535) return (uint16_t)port;
+            std::fprintf(stderr, "Bad spectator port '%s'; using %u\n", argv[i] + 11, (unsigned)SPECTATOR_DEFAULT_PORT);
+            return SPECTATOR_DEFAULT_PORT;
+        }
+    }
+    return 0;
+}
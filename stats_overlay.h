@@ -0,0 +1,101 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "render_capture.h"
+
+//----------------------------------------------------------------------------
+// Stats Overlay (Section 12 – HUD / Debug)
+//----------------------------------------------------------------------------
+// Debug text drawn with a built-in 3×5 pixel font, so it needs no font
+// files or glyph textures.  Lines are formatted with print() during the
+// frame; draw() turns every lit font pixel into a rect and submits them with
+// a single SDL_RenderFillRects call over a translucent backing box.
+// Lowercase letters render as uppercase; unknown characters as blanks.
+//
+
+struct StatsOverlay {
+    static constexpr int GLYPH_W = 3;
+    static constexpr int GLYPH_H = 5;
+
+    std::vector<std::string> lines;
+    std::vector<SDL_Rect> pixels;
+    bool visible{ true };
+
+    // Five rows of three bits each (4 = left column, 1 = right column)
+    static const uint8_t* glyph(char c) {
+        static const uint8_t digits[10][5] = {
+            {7,5,5,5,7}, {2,6,2,2,7}, {7,1,7,4,7}, {7,1,3,1,7}, {5,5,7,1,1},
+            {7,4,7,1,7}, {7,4,7,5,7}, {7,1,1,1,1}, {7,5,7,5,7}, {7,5,7,1,7}
+        };
+        static const uint8_t letters[26][5] = {
+            {2,5,7,5,5}, {6,5,6,5,6}, {3,4,4,4,3}, {6,5,5,5,6}, {7,4,6,4,7},
+            {7,4,6,4,4}, {3,4,5,5,3}, {5,5,7,5,5}, {7,2,2,2,7}, {1,1,1,5,2},
+            {5,5,6,5,5}, {4,4,4,4,7}, {5,7,7,5,5}, {6,5,5,5,5}, {2,5,5,5,2},
+            {6,5,6,4,4}, {2,5,5,6,3}, {6,5,6,5,5}, {3,4,2,1,6}, {7,2,2,2,2},
+            {5,5,5,5,7}, {5,5,5,5,2}, {5,5,7,7,5}, {5,5,2,5,5}, {5,5,2,2,2},
+            {7,1,2,4,7}
+        };
+        static const struct { char c; uint8_t rows[5]; } symbols[] = {
+            {'.', {0,0,0,0,2}}, {':', {0,2,0,2,0}}, {'%', {5,1,2,4,5}}, {'/', {1,1,2,4,4}},
+            {'-', {0,0,7,0,0}}, {'+', {0,2,7,2,0}}, {'=', {0,7,0,7,0}}, {'(', {1,2,2,2,1}},
+            {')', {4,2,2,2,4}}
+        };
+        if (c >= '0' && c <= '9') return digits[c - '0'];
+        if (c >= 'a' && c <= 'z') c = (char)(c - 'a' + 'A');
+        if (c >= 'A' && c <= 'Z') return letters[c - 'A'];
+        for (const auto& s : symbols) {
+            if (s.c == c) return s.rows;
+        }
+        return nullptr;
+    }
+
+    void clear() { lines.clear(); }
+
+    void print(const char* fmt, ...) {
+        char buffer[128];
+        va_list args;
+        va_start(args, fmt);
+        std::vsnprintf(buffer, sizeof(buffer), fmt, args);
+        va_end(args);
+        lines.emplace_back(buffer);
+    }
+
+    void draw(SDL_Renderer* renderer, int x, int y, int scale) {
+        if (!visible || lines.empty()) {
+            clear();
+            return;
+        }
+        const int advance = (GLYPH_W + 1) * scale;
+        const int lineHeight = (GLYPH_H + 2) * scale;
+        size_t longest = 0;
+        pixels.clear();
+        for (size_t l = 0; l < lines.size(); ++l) {
+            const std::string& text = lines[l];
+            longest = std::max(longest, text.size());
+            for (size_t i = 0; i < text.size(); ++i) {
+                const uint8_t* rows = glyph(text[i]);
+                if (!rows) continue;
+                int gx = x + (int)i * advance;
+                int gy = y + (int)l * lineHeight;
+                for (int r = 0; r < GLYPH_H; ++r) {
+                    for (int col = 0; col < GLYPH_W; ++col) {
+                        if (rows[r] & (4 >> col)) pixels.push_back({ gx + col * scale, gy + r * scale, scale, scale });
+                    }
+                }
+            }
+        }
+        SDL_Rect backing = { x - scale, y - scale, (int)longest * advance + scale, (int)lines.size() * lineHeight };
+        captureDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+        captureDrawColor(renderer, 0, 0, 0, 160);
+        captureFillRect(renderer, &backing);
+        captureDrawColor(renderer, 255, 255, 255, 255);
+        captureFillRects(renderer, pixels.data(), (int)pixels.size());
+        captureDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+        clear();
+    }
+};
@@ -0,0 +1,367 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "sim.h"
+#include "solidity.h"
+
+//----------------------------------------------------------------------------
+// Destructible Terrain (Section 15 – Level)
+//----------------------------------------------------------------------------
+// The live tile map, initialised from LEVEL_DATA and edited at runtime by
+// crumbling tiles and bomb craters.  Data derived from the tiles is kept up
+// to date incrementally:
+//
+//   solidity   updated bit by bit inside setTile(), so collision is exact
+//              on the tick of the edit
+//   autotile   4-bit mask of solid neighbours per tile (edge shading)
+//   rects      solid tiles merged into rectangles, per chunk
+//   nav        walk / drop / jump edges between standable tiles
+//   rendering  chunk textures and minimap areas (via takeRebuilt())
+//
+// Everything except solidity is rebuilt per 16×16-tile chunk.  An edit
+// queues every chunk whose derived data can see the edited tile (the nav
+// graph looks several tiles around each node) and update() rebuilds at most
+// `budget` queued chunks per call, so a large blast is spread over a few
+// frames instead of stalling one.  Blast radius is capped, which bounds the
+// work inside the simulation tick too.
+//
+// step() is the deterministic, per-tick part (crumbling, bombs) and runs in
+// replays; update() only feeds presentation and AI, and runs per frame.
+// Sand and liquids are moved by cellular.h, which reports its changes
+// through syncTiles().
+//
+
+constexpr int   TERRAIN_CHUNK_TILES  = 16;
+constexpr int   TERRAIN_CHUNK_BUDGET = 4;      // chunk rebuilds per update()
+constexpr int   TERRAIN_MAX_BLAST    = 6;      // tiles
+constexpr float CRUMBLE_SECONDS      = 0.5f;   // standing time before a breakable tile goes
+constexpr float BOMB_FUSE_SECONDS    = 1.2f;
+constexpr int   BOMB_RADIUS_TILES    = 3;
+
+// Navigation reach, in tiles (Section 7/8 jump: ~5.7 tiles high, ~8 across)
+constexpr int NAV_JUMP_UP     = 4;
+constexpr int NAV_JUMP_ACROSS = 3;
+constexpr int NAV_MAX_DROP    = 8;
+
+enum AutotileBits : uint8_t {
+    AUTOTILE_N = 1u << 0,
+    AUTOTILE_E = 1u << 1,
+    AUTOTILE_S = 1u << 2,
+    AUTOTILE_W = 1u << 3
+};
+
+struct TileRect {
+    int x0, y0, x1, y1;     // inclusive tile bounds
+    bool empty() const { return x1 < x0 || y1 < y0; }
+};
+
+enum class NavEdgeKind : uint8_t { Walk, Drop, Jump };
+
+struct NavEdge {
+    uint32_t to;             // tile index of the target node
+    NavEdgeKind kind;
+};
+
+// Nodes are standable tiles (two empty tiles for the player's height above
+// a solid one).  Edges live in fixed slots per tile so a chunk can be
+// rebuilt in place.
+struct NavGraph {
+    static constexpr int MAX_EDGES = 8;
+    std::vector<uint8_t> node;         // per tile
+    std::vector<uint8_t> edgeCount;    // per tile
+    std::vector<NavEdge> edges;        // MAX_EDGES per tile
+    size_t nodeCount{ 0 };
+    size_t edgeTotal{ 0 };
+
+    void resize(size_t tiles) {
+        node.assign(tiles, 0);
+        edgeCount.assign(tiles, 0);
+        edges.assign(tiles * MAX_EDGES, NavEdge{ 0, NavEdgeKind::Walk });
+        nodeCount = edgeTotal = 0;
+    }
+
+    const NavEdge* edgesOf(uint32_t tile) const { return &edges[(size_t)tile * MAX_EDGES]; }
+};
+
+struct Terrain {
+    int width{ 0 }, height{ 0 };
+    int chunksX{ 0 }, chunksY{ 0 };
+    std::vector<uint8_t> tiles;
+    SolidityBitmap solidity;
+    std::vector<uint8_t> autotile;
+    std::vector<std::vector<TileRect>> rects;    // per chunk
+    size_t rectCount{ 0 };
+    NavGraph nav;
+
+    std::vector<uint8_t> queued;                 // per chunk
+    std::vector<uint32_t> dirty;                 // FIFO of chunk indices
+    size_t dirtyHead{ 0 };
+    std::vector<uint32_t> rebuilt;               // chunks rebuilt since takeRebuilt()
+
+    std::vector<float> crumble;                  // standing time per tile
+    TileRect editedThisTick{ 0, 0, -1, -1 };
+
+    // Bomb (one at a time)
+    bool bombArmed{ false };
+    WorldPos bomb{};
+    float bombFuse{ 0.0f };
+    bool prevBomb{ false };
+
+    void load(const uint8_t* data, int w, int h) {
+        width = w;
+        height = h;
+        tiles.assign(data, data + (size_t)w * h);
+        solidity.build(data, w, h, tileSolid);
+        chunksX = (w + TERRAIN_CHUNK_TILES - 1) / TERRAIN_CHUNK_TILES;
+        chunksY = (h + TERRAIN_CHUNK_TILES - 1) / TERRAIN_CHUNK_TILES;
+        autotile.assign((size_t)w * h, 0);
+        rects.assign((size_t)chunksX * chunksY, {});
+        rectCount = 0;
+        nav.resize((size_t)w * h);
+        queued.assign((size_t)chunksX * chunksY, 0);
+        dirty.clear();
+        dirtyHead = 0;
+        rebuilt.clear();
+        crumble.assign((size_t)w * h, 0.0f);
+        editedThisTick = { 0, 0, -1, -1 };
+        bombArmed = prevBomb = false;
+        for (int c = 0; c < chunksX * chunksY; ++c) rebuildChunk(c);
+    }
+
+    bool inBounds(int x, int y) const { return x >= 0 && y >= 0 && x < width && y < height; }
+
+    uint8_t get(int x, int y) const {
+        return inBounds(x, y) ? tiles[(size_t)y * width + x] : (uint8_t)TILE_BEDROCK;
+    }
+
+    bool solid(int x, int y) const { return solidity.solid(x, y); }
+
+    // Change one tile.  Collision sees it immediately; derived data is
+    // queued.  Returns false if nothing changed.
+    bool setTile(int x, int y, uint8_t id) {
+        if (!inBounds(x, y)) return false;
+        uint8_t& t = tiles[(size_t)y * width + x];
+        if (t == id) return false;
+        t = id;
+        solidity.set(x, y, tileSolid(id));
+        crumble[(size_t)y * width + x] = 0.0f;
+        edited({ x, y, x, y });
+        return true;
+    }
+
+    // Tiles in `area` were written directly (cellular.h): strip the cell
+    // automaton's per-step flag bit, refresh their solidity and queue
+    // derived data as setTile() would.
+    void syncTiles(const TileRect& area) {
+        for (int y = area.y0; y <= area.y1; ++y) {
+            for (int x = area.x0; x <= area.x1; ++x) {
+                uint8_t& t = tiles[(size_t)y * width + x];
+                t &= 0x7F;
+                solidity.set(x, y, tileSolid(t));
+            }
+        }
+        edited(area);
+    }
+
+    void edited(const TileRect& a) {
+        TileRect& e = editedThisTick;
+        if (e.empty()) e = a;
+        else e = { std::min(e.x0, a.x0), std::min(e.y0, a.y0), std::max(e.x1, a.x1), std::max(e.y1, a.y1) };
+        // Nodes up to NAV_MAX_DROP above can drop onto a changed tile, nodes
+        // a jump below can land on it, and jumps reach NAV_JUMP_ACROSS sideways
+        queueTiles(a.x0 - NAV_JUMP_ACROSS - 1, a.y0 - NAV_MAX_DROP - 1, a.x1 + NAV_JUMP_ACROSS + 1, a.y1 + NAV_JUMP_UP + 2);
+    }
+
+    // Clear a disc of destructible tiles (everything but bedrock) centred
+    // on the tile containing `centre`.  Returns the number of tiles removed.
+    int explode(const WorldPos& centre, int radiusTiles) {
+        const int r = std::min(radiusTiles, TERRAIN_MAX_BLAST);
+        const int tx = centre.x.tile(TILE_SIZE), ty = centre.y.tile(TILE_SIZE);
+        int removed = 0;
+        for (int y = ty - r; y <= ty + r; ++y) {
+            for (int x = tx - r; x <= tx + r; ++x) {
+                if ((x - tx) * (x - tx) + (y - ty) * (y - ty) > r * r) continue;
+                uint8_t t = get(x, y);
+                if (t == TILE_EMPTY || t == TILE_BEDROCK) continue;
+                removed += setTile(x, y, TILE_EMPTY) ? 1 : 0;
+            }
+        }
+        return removed;
+    }
+
+    // Per tick: breakable tiles under a standing player crumble, and the
+    // bomb input drops a bomb at the player's feet that explodes after its
+    // fuse.  editedThisTick covers every tile changed during the call.
+    void step(const Player& player, const PlayerInput& input, float dt) {
+        editedThisTick = { 0, 0, -1, -1 };
+        if (player.onGround) {
+            int y = player.position.y.tile(TILE_SIZE, PLAYER_H);
+            int x0 = player.position.x.tile(TILE_SIZE), x1 = player.position.x.tile(TILE_SIZE, PLAYER_W - 1);
+            for (int x = x0; x <= x1; ++x) {
+                if (get(x, y) != TILE_BREAKABLE) continue;
+                float& t = crumble[(size_t)y * width + x];
+                t += dt;
+                if (t >= CRUMBLE_SECONDS) setTile(x, y, TILE_EMPTY);
+            }
+        }
+        if (input.bomb && !prevBomb && !bombArmed) {
+            bombArmed = true;
+            bomb = player.position;
+            bomb.x.local += PLAYER_W * 0.5f;
+            bomb.y.local += PLAYER_H - 4.0f;
+            bomb.normalize();
+            bombFuse = BOMB_FUSE_SECONDS;
+        }
+        prevBomb = input.bomb;
+        if (bombArmed && (bombFuse -= dt) <= 0.0f) {
+            bombArmed = false;
+            explode(bomb, BOMB_RADIUS_TILES);
+        }
+    }
+
+    void queueTiles(int x0, int y0, int x1, int y1) {
+        int cx0 = std::max(x0, 0) / TERRAIN_CHUNK_TILES, cx1 = std::min(x1, width - 1) / TERRAIN_CHUNK_TILES;
+        int cy0 = std::max(y0, 0) / TERRAIN_CHUNK_TILES, cy1 = std::min(y1, height - 1) / TERRAIN_CHUNK_TILES;
+        for (int cy = cy0; cy <= cy1; ++cy) {
+            for (int cx = cx0; cx <= cx1; ++cx) {
+                uint32_t c = (uint32_t)(cy * chunksX + cx);
+                if (queued[c]) continue;
+                queued[c] = 1;
+                dirty.push_back(c);
+            }
+        }
+    }
+
+    size_t pending() const { return dirty.size() - dirtyHead; }
+
+    // Rebuild up to `budget` queued chunks, oldest first.  Returns how many.
+    int update(int budget = TERRAIN_CHUNK_BUDGET) {
+        int done = 0;
+        while (done < budget && dirtyHead < dirty.size()) {
+            uint32_t c = dirty[dirtyHead++];
+            queued[c] = 0;
+            rebuildChunk((int)c);
+            ++done;
+        }
+        if (dirtyHead == dirty.size()) {
+            dirty.clear();
+            dirtyHead = 0;
+        }
+        return done;
+    }
+
+    // Chunks whose textures / minimap area must be refreshed.
+    void takeRebuilt(std::vector<uint32_t>& out) {
+        out.swap(rebuilt);
+        rebuilt.clear();
+    }
+
+    TileRect chunkTiles(int c) const {
+        int cx = c % chunksX, cy = c / chunksX;
+        return { cx * TERRAIN_CHUNK_TILES, cy * TERRAIN_CHUNK_TILES,
+                 std::min((cx + 1) * TERRAIN_CHUNK_TILES, width) - 1,
+                 std::min((cy + 1) * TERRAIN_CHUNK_TILES, height) - 1 };
+    }
+
+    void rebuildChunk(int c) {
+        const TileRect area = chunkTiles(c);
+        for (int y = area.y0; y <= area.y1; ++y) {
+            for (int x = area.x0; x <= area.x1; ++x) {
+                autotile[(size_t)y * width + x] = (uint8_t)((solid(x, y - 1) ? AUTOTILE_N : 0) |
+                                                            (solid(x + 1, y) ? AUTOTILE_E : 0) |
+                                                            (solid(x, y + 1) ? AUTOTILE_S : 0) |
+                                                            (solid(x - 1, y) ? AUTOTILE_W : 0));
+            }
+        }
+        mergeRects(c, area);
+        for (int y = area.y0; y <= area.y1; ++y) {
+            for (int x = area.x0; x <= area.x1; ++x) buildNavNode(x, y);
+        }
+        rebuilt.push_back((uint32_t)c);
+    }
+
+    // Greedy merge: horizontal runs of solid tiles, each extended downwards
+    // while the rows below have the same run.
+    void mergeRects(int c, const TileRect& area) {
+        std::vector<TileRect>& out = rects[c];
+        rectCount -= out.size();
+        out.clear();
+        const int w = area.x1 - area.x0 + 1, h = area.y1 - area.y0 + 1;
+        uint8_t used[TERRAIN_CHUNK_TILES * TERRAIN_CHUNK_TILES] = {};
+        for (int ly = 0; ly < h; ++ly) {
+            for (int lx = 0; lx < w; ++lx) {
+                if (used[ly * TERRAIN_CHUNK_TILES + lx] || !solid(area.x0 + lx, area.y0 + ly)) continue;
+                int runEnd = lx;
+                while (runEnd + 1 < w && !used[ly * TERRAIN_CHUNK_TILES + runEnd + 1] &&
+                       solid(area.x0 + runEnd + 1, area.y0 + ly)) ++runEnd;
+                int rowEnd = ly;
+                for (bool extend = true; extend && rowEnd + 1 < h;) {
+                    for (int x = lx; x <= runEnd; ++x) {
+                        if (used[(rowEnd + 1) * TERRAIN_CHUNK_TILES + x] || !solid(area.x0 + x, area.y0 + rowEnd + 1)) {
+                            extend = false;
+                            break;
+                        }
+                    }
+                    if (extend) ++rowEnd;
+                }
+                for (int y = ly; y <= rowEnd; ++y) {
+                    for (int x = lx; x <= runEnd; ++x) used[y * TERRAIN_CHUNK_TILES + x] = 1;
+                }
+                out.push_back({ area.x0 + lx, area.y0 + ly, area.x0 + runEnd, area.y0 + rowEnd });
+            }
+        }
+        rectCount += out.size();
+    }
+
+    bool standable(int x, int y) const {
+        return inBounds(x, y) && !solid(x, y) && !solid(x, y - 1) && solid(x, y + 1);
+    }
+
+    bool clear(int x, int y) const { return inBounds(x, y) && !solid(x, y); }
+
+    void buildNavNode(int x, int y) {
+        const uint32_t i = (uint32_t)(y * width + x);
+        nav.nodeCount -= nav.node[i];
+        nav.edgeTotal -= nav.edgeCount[i];
+        nav.node[i] = standable(x, y) ? 1 : 0;
+        nav.edgeCount[i] = 0;
+        nav.nodeCount += nav.node[i];
+        if (!nav.node[i]) return;
+        NavEdge* out = &nav.edges[(size_t)i * NavGraph::MAX_EDGES];
+        int n = 0;
+        auto add = [&](int tx, int ty, NavEdgeKind kind) {
+            if (n < NavGraph::MAX_EDGES) out[n++] = { (uint32_t)(ty * width + tx), kind };
+        };
+        for (int dir = -1; dir <= 1; dir += 2) {
+            int nx = x + dir;
+            if (standable(nx, y)) {
+                add(nx, y, NavEdgeKind::Walk);
+            } else if (clear(nx, y) && clear(nx, y - 1)) {
+                for (int d = 1; d <= NAV_MAX_DROP; ++d) {
+                    if (standable(nx, y + d)) { add(nx, y + d, NavEdgeKind::Drop); break; }
+                    if (!clear(nx, y + d)) break;
+                }
+            }
+        }
+        // Jumps: straight up through clear headroom, then across the target's
+        // row and head row; nearest targets first
+        for (int dy = 1; dy <= NAV_JUMP_UP; ++dy) {
+            if (!clear(x, y - dy - 1)) break;
+            for (int adx = 1; adx <= NAV_JUMP_ACROSS; ++adx) {
+                for (int dir = -1; dir <= 1; dir += 2) {
+                    int tx = x + dir * adx, ty = y - dy;
+                    if (!standable(tx, ty)) continue;
+                    bool path = true;
+                    for (int k = 1; k < adx && path; ++k) {
+                        path = clear(x + dir * k, ty) && clear(x + dir * k, ty - 1);
+                    }
+                    if (path) add(tx, ty, NavEdgeKind::Jump);
+                }
+            }
+        }
+        nav.edgeCount[i] = (uint8_t)n;
+        nav.edgeTotal += n;
+    }
+};
@@ -0,0 +1,181 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "render_capture.h"
+
+//----------------------------------------------------------------------------
+// Texture Cache (Section 1 – Rendering & Assets)
+//----------------------------------------------------------------------------
+// Derived textures (tile chunks, parallax bakes, atlases, glyph pages) are
+// registered under a 64-bit key together with a callback that can rebuild
+// them.  The cache owns the SDL textures and keeps their total size under
+// `budgetBytes`: at beginFrame() the least recently used textures (by the
+// frame they were last drawn) are destroyed until the budget is met.  An
+// evicted entry keeps its callback, so the next get() transparently
+// rebuilds it and counts a miss.
+//
+// Textures used in the current frame are never evicted, so a frame whose
+// working set exceeds the budget temporarily runs over it instead of
+// thrashing.  prefetch() builds an entry ahead of need (e.g. the chunk the
+// camera is moving towards) outside the hit/miss statistics.
+//
+// Sizes are estimated as width × height × bytes per pixel.
+//
+
+using TextureKey = uint64_t;
+using TextureBuilder = std::function<SDL_Texture*(SDL_Renderer*)>;
+
+struct TextureCacheStats {
+    uint64_t hits{ 0 };
+    uint64_t misses{ 0 };
+    uint64_t evictions{ 0 };
+    uint64_t prefetches{ 0 };
+    float hitRate{ 1.0f };             // over the last rate window
+    float evictionsPerSecond{ 0.0f };  // over the last rate window
+};
+
+struct TextureCache {
+    struct Entry {
+        TextureBuilder build;
+        SDL_Texture* texture{ nullptr };
+        size_t bytes{ 0 };
+        uint64_t lastUsedFrame{ 0 };
+    };
+
+    SDL_Renderer* renderer{ nullptr };
+    size_t budgetBytes{ 64u << 20 };
+    size_t residentBytes{ 0 };
+    uint64_t frame{ 0 };
+    std::unordered_map<TextureKey, Entry> entries;
+    TextureCacheStats stats;
+
+    // Rate window bookkeeping
+    float windowSeconds{ 0.0f };
+    uint64_t windowHits{ 0 }, windowMisses{ 0 }, windowEvictions{ 0 };
+
+    static size_t textureBytes(SDL_Texture* texture) {
+        Uint32 format;
+        int w, h;
+        if (SDL_QueryTexture(texture, &format, nullptr, &w, &h) != 0) return 0;
+        return (size_t)w * h * SDL_BYTESPERPIXEL(format);
+    }
+
+    // Register (or replace) a rebuildable texture.  Nothing is built yet.
+    void define(TextureKey key, TextureBuilder build) {
+        Entry& e = entries[key];
+        release(e);
+        e.build = std::move(build);
+    }
+
+    bool contains(TextureKey key) const { return entries.count(key) != 0; }
+
+    bool resident(TextureKey key) const {
+        auto it = entries.find(key);
+        return it != entries.end() && it->second.texture != nullptr;
+    }
+
+    // Texture for drawing this frame; rebuilds it if it was evicted.
+    SDL_Texture* get(TextureKey key) {
+        auto it = entries.find(key);
+        if (it == entries.end()) return nullptr;
+        Entry& e = it->second;
+        if (e.texture) {
+            ++stats.hits;
+            ++windowHits;
+        } else {
+            ++stats.misses;
+            ++windowMisses;
+            load(e);
+        }
+        e.lastUsedFrame = frame;
+        return e.texture;
+    }
+
+    // Build ahead of need.  Counts as neither a hit nor a miss.
+    void prefetch(TextureKey key) {
+        auto it = entries.find(key);
+        if (it == entries.end() || it->second.texture) return;
+        ++stats.prefetches;
+        load(it->second);
+    }
+
+    // Forget a texture's contents (its source changed); rebuilt on next use.
+    void invalidate(TextureKey key) {
+        auto it = entries.find(key);
+        if (it != entries.end()) release(it->second);
+    }
+
+    void remove(TextureKey key) {
+        auto it = entries.find(key);
+        if (it == entries.end()) return;
+        release(it->second);
+        entries.erase(it);
+    }
+
+    // Advance the frame counter, evict down to budget and update the rates.
+    void beginFrame(float frameSeconds) {
+        ++frame;
+        evictToBudget();
+        windowSeconds += frameSeconds;
+        if (windowSeconds >= 1.0f) {
+            uint64_t lookups = windowHits + windowMisses;
+            stats.hitRate = lookups ? (float)windowHits / (float)lookups : 1.0f;
+            stats.evictionsPerSecond = windowEvictions / windowSeconds;
+            windowSeconds = 0.0f;
+            windowHits = windowMisses = windowEvictions = 0;
+        }
+    }
+
+    void evictToBudget() {
+        if (residentBytes <= budgetBytes) return;
+        // Oldest first; anything used in the previous frame is still hot
+        std::vector<std::pair<uint64_t, Entry*>> candidates;
+        for (auto& kv : entries) {
+            Entry& e = kv.second;
+            if (e.texture && e.lastUsedFrame + 1 < frame) candidates.push_back({ e.lastUsedFrame, &e });
+        }
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const std::pair<uint64_t, Entry*>& a, const std::pair<uint64_t, Entry*>& b) {
+                      return a.first < b.first;
+                  });
+        for (auto& c : candidates) {
+            if (residentBytes <= budgetBytes) break;
+            release(*c.second);
+            ++stats.evictions;
+            ++windowEvictions;
+        }
+    }
+
+    // Drop every texture (e.g. on SDL_RENDER_DEVICE_RESET); definitions stay.
+    void releaseAll() {
+        for (auto& kv : entries) release(kv.second);
+    }
+
+    void destroy() {
+        releaseAll();
+        entries.clear();
+    }
+
+    void load(Entry& e) {
+        if (!e.build || !renderer) return;
+        e.texture = e.build(renderer);
+        if (!e.texture) return;
+        e.bytes = textureBytes(e.texture);
+        residentBytes += e.bytes;
+        // A fresh texture must survive at least until it can be drawn
+        e.lastUsedFrame = std::max(e.lastUsedFrame, frame);
+    }
+
+    void release(Entry& e) {
+        if (!e.texture) return;
+        captureDestroyTexture(e.texture);
+        e.texture = nullptr;
+        residentBytes -= e.bytes;
+        e.bytes = 0;
+    }
+};
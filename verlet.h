@@ -0,0 +1,273 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "solidity.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VERLET_HAS_SSE2 1
+#endif
+
+//----------------------------------------------------------------------------
+// Verlet Ropes (Section 14 – Dynamic Bodies)
+//----------------------------------------------------------------------------
+// Ropes, chains and hanging bridges as Verlet particles joined by distance
+// constraints.  Particles are SoA (position, previous position, inverse
+// mass; 0 = pinned).  A step integrates every particle, then runs a fixed
+// number of relaxation iterations, each projecting all constraints, then
+// tethering particles to their anchors and pushing them out of solid tiles
+// (solidity bitmap).  Positions are float pixels relative to a movable
+// origin (SimOrigin, sim.h): tile lookups add the origin's tile
+// (setTileOrigin), and shift() moves every particle when the origin moves.
+//
+// A rope of n links has constraints between particles k and k+1.  Even
+// links never share a particle, nor do odd ones, so constraints are stored
+// in two phases (all even links of all ropes, then all odd ones), each
+// padded to whole rows of four.  A row gathers four constraints, corrects
+// them in SSE2 lanes and scatters the result without conflicts.  Padding
+// rows point at particle 0, a pinned sentinel.
+//
+// All arrays are sized when ropes are added; step() never allocates.  The
+// integrator assumes a constant dt, i.e. the fixed simulation tick.
+//
+
+constexpr float VERLET_GRAVITY  = 2100.0f;   // matches the player (Section 7/8)
+constexpr float VERLET_DAMPING  = 0.995f;    // velocity kept per step
+constexpr float VERLET_FRICTION = 0.3f;      // tangential velocity lost on tile contact
+
+struct VerletRope {
+    uint32_t first;      // first particle
+    uint32_t count;      // particles (links + 1)
+    float linkLength;    // rest length of every link
+    bool bridge;         // pinned at both ends
+};
+
+struct VerletSystem {
+    // Particles; index 0 is the pinned sentinel used by padding constraints
+    std::vector<float> x, y, px, py, invMass;
+    // Constraints in two padded phases: [0, phaseEnd[0]) and [phaseEnd[0], phaseEnd[1])
+    std::vector<uint32_t> ca, cb;
+    std::vector<float> rest;
+    uint32_t phaseEnd[2]{ 0, 0 };
+    std::vector<VerletRope> ropes;
+
+    const SolidityBitmap* tiles{ nullptr };
+    float tileSize{ 16.0f };
+    int tileOriginX{ 0 };     // bitmap tile at position (0, 0)
+    int tileOriginY{ 0 };
+    int iterations{ 8 };
+
+    VerletSystem() { clear(); }
+
+    void clear() {
+        x.assign(1, 0.0f); y.assign(1, 0.0f);
+        px.assign(1, 0.0f); py.assign(1, 0.0f);
+        invMass.assign(1, 0.0f);
+        ca.clear(); cb.clear(); rest.clear();
+        phaseEnd[0] = phaseEnd[1] = 0;
+        ropes.clear();
+    }
+
+    void setTiles(const SolidityBitmap& bitmap, float size) {
+        tiles = &bitmap;
+        tileSize = size;
+    }
+
+    void setTileOrigin(int tx, int ty) {
+        tileOriginX = tx;
+        tileOriginY = ty;
+    }
+
+    // Move every particle by (dx, dy) px, for an origin shift.
+    void shift(float dx, float dy) {
+        for (size_t i = 1; i < x.size(); ++i) {
+            x[i] += dx; px[i] += dx;
+            y[i] += dy; py[i] += dy;
+        }
+    }
+
+    size_t particleCount() const { return x.size() - 1; }
+
+    // A straight rope from (ax, ay) to (bx, by) with `links` segments.  The
+    // start is pinned; pinEnd pins the other end too (a bridge).  Links are
+    // `slack` times longer than the spawn spacing, so a bridge sags.
+    uint32_t addRope(float ax, float ay, float bx, float by, int links, bool pinEnd,
+                     float slack = 1.0f, float linkMass = 1.0f) {
+        float span = std::sqrt((bx - ax) * (bx - ax) + (by - ay) * (by - ay));
+        VerletRope rope{ (uint32_t)x.size(), (uint32_t)links + 1, span / links * slack, pinEnd };
+        for (int k = 0; k <= links; ++k) {
+            float t = (float)k / (float)links;
+            float cx = ax + (bx - ax) * t, cy = ay + (by - ay) * t;
+            bool pinned = k == 0 || (pinEnd && k == links);
+            x.push_back(cx); y.push_back(cy);
+            px.push_back(cx); py.push_back(cy);
+            invMass.push_back(pinned ? 0.0f : 1.0f / linkMass);
+        }
+        ropes.push_back(rope);
+        buildConstraints();
+        return (uint32_t)ropes.size() - 1;
+    }
+
+    void buildConstraints() {
+        ca.clear(); cb.clear(); rest.clear();
+        for (int phase = 0; phase < 2; ++phase) {
+            for (const VerletRope& r : ropes) {
+                for (uint32_t k = (uint32_t)phase; k + 1 < r.count; k += 2) {
+                    uint32_t a = r.first + k, b = a + 1;
+                    ca.push_back(a); cb.push_back(b);
+                    rest.push_back(r.linkLength);
+                }
+            }
+            while (ca.size() % 4) {
+                ca.push_back(0); cb.push_back(0); rest.push_back(0.0f);
+            }
+            phaseEnd[phase] = (uint32_t)ca.size();
+        }
+    }
+
+    void pin(uint32_t i, float cx, float cy) {
+        x[i] = px[i] = cx;
+        y[i] = py[i] = cy;
+    }
+
+    void step(float dt) {
+        const size_t n = x.size();
+        const float g = VERLET_GRAVITY * dt * dt;
+        for (size_t i = 1; i < n; ++i) {
+            if (invMass[i] == 0.0f) continue;
+            float vx = (x[i] - px[i]) * VERLET_DAMPING;
+            float vy = (y[i] - py[i]) * VERLET_DAMPING;
+            px[i] = x[i];
+            py[i] = y[i];
+            x[i] += vx;
+            y[i] += vy + g;
+        }
+        for (int it = 0; it < iterations; ++it) {
+            for (uint32_t c = 0; c < phaseEnd[0]; c += 4) solveRow(c);
+            for (uint32_t c = phaseEnd[0]; c < phaseEnd[1]; c += 4) solveRow(c);
+            tether();
+            collideTiles();
+        }
+    }
+
+    // Project four distance constraints: move both ends along the link,
+    // split by inverse mass.
+    void solveRow(uint32_t c) {
+        const uint32_t* A = &ca[c];
+        const uint32_t* B = &cb[c];
+#if defined(VERLET_HAS_SSE2)
+        __m128 xa = _mm_setr_ps(x[A[0]], x[A[1]], x[A[2]], x[A[3]]);
+        __m128 ya = _mm_setr_ps(y[A[0]], y[A[1]], y[A[2]], y[A[3]]);
+        __m128 xb = _mm_setr_ps(x[B[0]], x[B[1]], x[B[2]], x[B[3]]);
+        __m128 yb = _mm_setr_ps(y[B[0]], y[B[1]], y[B[2]], y[B[3]]);
+        __m128 wa = _mm_setr_ps(invMass[A[0]], invMass[A[1]], invMass[A[2]], invMass[A[3]]);
+        __m128 wb = _mm_setr_ps(invMass[B[0]], invMass[B[1]], invMass[B[2]], invMass[B[3]]);
+        __m128 dx = _mm_sub_ps(xb, xa), dy = _mm_sub_ps(yb, ya);
+        __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+        // Padding and fully pinned links have wa + wb = 0; the epsilon keeps
+        // the quotient finite and the zero weights cancel it
+        __m128 denom = _mm_max_ps(_mm_mul_ps(len, _mm_add_ps(wa, wb)), _mm_set1_ps(1e-6f));
+        __m128 k = _mm_div_ps(_mm_sub_ps(len, _mm_loadu_ps(&rest[c])), denom);
+        __m128 cx = _mm_mul_ps(dx, k), cy = _mm_mul_ps(dy, k);
+        xa = _mm_add_ps(xa, _mm_mul_ps(cx, wa)); ya = _mm_add_ps(ya, _mm_mul_ps(cy, wa));
+        xb = _mm_sub_ps(xb, _mm_mul_ps(cx, wb)); yb = _mm_sub_ps(yb, _mm_mul_ps(cy, wb));
+        alignas(16) float oxa[4], oya[4], oxb[4], oyb[4];
+        _mm_store_ps(oxa, xa); _mm_store_ps(oya, ya);
+        _mm_store_ps(oxb, xb); _mm_store_ps(oyb, yb);
+        for (int l = 0; l < 4; ++l) {
+            x[A[l]] = oxa[l]; y[A[l]] = oya[l];
+            x[B[l]] = oxb[l]; y[B[l]] = oyb[l];
+        }
+#else
+        for (uint32_t l = c; l < c + 4; ++l) {
+            const uint32_t a = ca[l], b = cb[l];
+            const float wa = invMass[a], wb = invMass[b];
+            float dx = x[b] - x[a], dy = y[b] - y[a];
+            float len = std::sqrt(dx * dx + dy * dy);
+            float k = (len - rest[l]) / std::max(len * (wa + wb), 1e-6f);
+            x[a] += dx * k * wa; y[a] += dy * k * wa;
+            x[b] -= dx * k * wb; y[b] -= dy * k * wb;
+        }
+#endif
+    }
+
+    // Long-range attachment: no particle may be further from its rope's
+    // anchor (the nearer one on a bridge) than the links between them allow.
+    // A few relaxation passes cannot carry a long chain's weight back to
+    // the anchor, so without this hanging ropes visibly stretch.
+    void tether() {
+        for (const VerletRope& r : ropes) {
+            const uint32_t last = r.first + r.count - 1;
+            for (uint32_t i = r.first + 1; i < last + (r.bridge ? 0 : 1); ++i) {
+                if (invMass[i] == 0.0f) continue;
+                uint32_t k = i - r.first;
+                uint32_t anchor = r.first;
+                if (r.bridge && last - i < k) {
+                    anchor = last;
+                    k = last - i;
+                }
+                float dx = x[i] - x[anchor], dy = y[i] - y[anchor];
+                float d2 = dx * dx + dy * dy, maxD = k * r.linkLength;
+                if (d2 <= maxD * maxD) continue;
+                float scale = maxD / std::sqrt(d2);
+                x[i] = x[anchor] + dx * scale;
+                y[i] = y[anchor] + dy * scale;
+            }
+        }
+    }
+
+    // Push particles inside a solid tile out through its nearest open face,
+    // removing the normal velocity and some of the tangential.
+    void collideTiles() {
+        if (!tiles) return;
+        const size_t n = x.size();
+        for (size_t i = 1; i < n; ++i) {
+            if (invMass[i] == 0.0f) continue;
+            // tx, ty are relative to the origin; the bitmap is read at +tileOrigin
+            int tx = (int)std::floor(x[i] / tileSize), ty = (int)std::floor(y[i] / tileSize);
+            const int mx = tx + tileOriginX, my = ty + tileOriginY;
+            if (!tiles->solid(mx, my)) continue;
+            float left = x[i] - tx * tileSize, right = (tx + 1) * tileSize - x[i];
+            float top = y[i] - ty * tileSize, bottom = (ty + 1) * tileSize - y[i];
+            float best = 1e30f;
+            int face = -1;
+            if (!tiles->solid(mx - 1, my) && left   < best) { best = left;   face = 0; }
+            if (!tiles->solid(mx + 1, my) && right  < best) { best = right;  face = 1; }
+            if (!tiles->solid(mx, my - 1) && top    < best) { best = top;    face = 2; }
+            if (!tiles->solid(mx, my + 1) && bottom < best) { best = bottom; face = 3; }
+            if (face < 0) {
+                // Buried: fall back to where it was
+                x[i] = px[i];
+                y[i] = py[i];
+                continue;
+            }
+            if (face < 2) {
+                // Tile edges belong to the tile, so the low faces step off by a hair
+                x[i] = face == 0 ? tx * tileSize - 0.01f : (tx + 1) * tileSize;
+                px[i] = x[i];
+                py[i] = y[i] - (y[i] - py[i]) * (1.0f - VERLET_FRICTION);
+            } else {
+                y[i] = face == 2 ? ty * tileSize - 0.01f : (ty + 1) * tileSize;
+                py[i] = y[i];
+                px[i] = x[i] - (x[i] - px[i]) * (1.0f - VERLET_FRICTION);
+            }
+        }
+    }
+
+    // Closest free particle within `radius` of (cx, cy), or 0 if none.
+    uint32_t nearestParticle(float cx, float cy, float radius) const {
+        uint32_t best = 0;
+        float bestD2 = radius * radius;
+        for (size_t i = 1; i < x.size(); ++i) {
+            if (invMass[i] == 0.0f) continue;
+            float d2 = (x[i] - cx) * (x[i] - cx) + (y[i] - cy) * (y[i] - cy);
+            if (d2 < bestD2) { bestD2 = d2; best = (uint32_t)i; }
+        }
+        return best;
+    }
+
+    float velocityX(uint32_t i, float dt) const { return (x[i] - px[i]) / dt; }
+    float velocityY(uint32_t i, float dt) const { return (y[i] - py[i]) / dt; }
+};
@@ -0,0 +1,84 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+
+//----------------------------------------------------------------------------
+// Floating-Origin World Coordinates (Section 0 – World Units)
+//----------------------------------------------------------------------------
+// A world axis is stored as (chunk index, local float) with the local part
+// kept in [0, WORLD_CHUNK_SIZE).  The float therefore never grows beyond one
+// chunk and its precision (≤ 2^-13 px) is the same at the start of a level
+// and a million pixels in – sub-pixel steps like GRAVITY*dt*dt never
+// quantise away.
+//
+// Gameplay math works on `local` directly and calls normalize() afterwards.
+// Rendering rebases everything to the camera with relativeTo(), so all
+// screen-space math is small 32-bit floats.  The chunk size is a power of
+// two, so moving whole chunks between the parts is exact.
+//
+
+constexpr int WORLD_CHUNK_SIZE = 1024;   // pixels per chunk (power of two)
+
+struct WorldCoord {
+    int32_t chunk{ 0 };
+    float   local{ 0.0f };
+
+    static WorldCoord fromPixels(double px) {
+        WorldCoord c;
+        double f = std::floor(px / WORLD_CHUNK_SIZE);
+        c.chunk = (int32_t)f;
+        c.local = (float)(px - f * WORLD_CHUNK_SIZE);
+        c.normalize();
+        return c;
+    }
+
+    // Left/top edge of tile `t`; tileSize must divide WORLD_CHUNK_SIZE.
+    static WorldCoord fromTile(int t, int tileSize) {
+        const int perChunk = WORLD_CHUNK_SIZE / tileSize;
+        int32_t chunk = t >= 0 ? t / perChunk : -((-t + perChunk - 1) / perChunk);
+        return { chunk, (float)((t - chunk * perChunk) * tileSize) };
+    }
+
+    // Fold `local` back into [0, WORLD_CHUNK_SIZE) after it has been moved.
+    void normalize() {
+        if (local >= 0.0f && local < (float)WORLD_CHUNK_SIZE) return;
+        float f = std::floor(local / WORLD_CHUNK_SIZE);
+        chunk += (int32_t)f;
+        local -= f * WORLD_CHUNK_SIZE;
+        // Rounding of tiny negative values can land exactly on the upper bound
+        if (local >= (float)WORLD_CHUNK_SIZE) {
+            local -= WORLD_CHUNK_SIZE;
+            ++chunk;
+        }
+    }
+
+    // Signed distance from `origin` to this coordinate in pixels.
+    float relativeTo(const WorldCoord& origin) const {
+        return (float)(chunk - origin.chunk) * WORLD_CHUNK_SIZE + (local - origin.local);
+    }
+
+    // Index of the tile containing this coordinate.  `offset` is a local
+    // displacement (e.g. entity width) applied before the lookup.
+    int tile(int tileSize, float offset = 0.0f) const {
+        return chunk * (WORLD_CHUNK_SIZE / tileSize) + (int)std::floor((local + offset) / tileSize);
+    }
+
+    // Absolute position; only for logging and coarse comparisons.
+    double pixels() const {
+        return (double)chunk * WORLD_CHUNK_SIZE + local;
+    }
+};
+
+struct WorldPos {
+    WorldCoord x;
+    WorldCoord y;
+
+    static WorldPos fromPixels(double px, double py) {
+        return { WorldCoord::fromPixels(px), WorldCoord::fromPixels(py) };
+    }
+
+    void normalize() {
+        x.normalize();
+        y.normalize();
+    }
+};